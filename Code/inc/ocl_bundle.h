@@ -0,0 +1,81 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OCL_BUNDLE_H
+#define OCL_BUNDLE_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace ocl{
+
+class Device;
+
+/*! \class Bundle ocl_bundle.h "inc/ocl_bundle.h"
+  *
+  * \brief Versioned collection of precompiled Program binaries.
+  *
+  * Each Binary is stored together with the name, version and driver version
+  * of the Device it has been built for, the build options and a hash
+  * of the source of the Program. A Program with a Bundle uses a Binary only
+  * if all of these match for every Device of its Context and builds from
+  * source otherwise. Bundles are created with the oclpc tool or with
+  * Program::binaries() and can be embedded into an executable.
+  */
+class Bundle
+{
+public:
+	/*! \brief Binary of a Program for a single Device. */
+	struct Binary
+	{
+		Binary() : device(), version(), driver(), options(), source(0), data() {}
+
+		std::string device;  /**< Name of the Device. */
+		std::string version; /**< OpenCL version of the Device. */
+		std::string driver;  /**< Driver version of the Device. */
+		std::string options; /**< Build options. */
+		uint64_t source;     /**< Hash of the Program source. */
+		std::vector<unsigned char> data;
+	};
+
+	static const uint32_t format = 1; /**< Version of the serialized format. */
+
+	Bundle();
+	Bundle(const unsigned char *data, size_t size);
+	explicit Bundle(std::istream &stream);
+
+	void add(const Binary &binary);
+	void add(const Bundle &bundle);
+	const Binary* find(const Device &device, const std::string &options, uint64_t source) const;
+	const std::vector<Binary>& binaries() const;
+	bool empty() const;
+	size_t size() const;
+
+	std::vector<unsigned char> serialize() const;
+	void write(std::ostream &stream) const;
+
+	static uint64_t hash(const std::string &source);
+
+private:
+	std::vector<Binary> _binaries;
+};
+
+}
+
+#endif
@@ -0,0 +1,76 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OCL_COMPLETION_QUEUE_H
+#define OCL_COMPLETION_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace ocl{
+
+/*! \class CompletionQueue ocl_completion_queue.h "inc/ocl_completion_queue.h"
+  * \brief Host thread on which Event completion callbacks are executed.
+  *
+  * OpenCL calls event callbacks on a thread of the driver which must not
+  * block and must not call most OpenCL functions. Callbacks registered with
+  * Event::then and the futures of Event, EventList, when_all and when_any
+  * are therefore only posted by the driver thread and executed
+  * in order on the single thread of the CompletionQueue.
+  * The thread is started on first use. It is shut down at program exit before the
+  * static objects are destructed which have been constructed before the first use,
+  * after all callbacks posted until then have been executed. Callbacks posted
+  * afterwards are rejected. Exceptions thrown by callbacks are passed to the ErrorHandler.
+  */
+class CompletionQueue
+{
+public:
+	/*! \brief Function called with an exception thrown by a callback. */
+	typedef std::function<void(std::exception_ptr)> ErrorHandler;
+
+	static CompletionQueue& instance();
+
+	~CompletionQueue();
+	CompletionQueue(const CompletionQueue&) = delete;
+	CompletionQueue& operator=(const CompletionQueue&) = delete;
+
+	bool post(std::function<void()> task);
+	void shutdown();
+	bool isShutdown() const;
+	size_t pending() const;
+	bool isCompletionThread() const;
+	void setErrorHandler(ErrorHandler);
+
+private:
+	CompletionQueue();
+	void run();
+
+	mutable std::mutex _mutex;
+	std::condition_variable _condition;
+	std::deque< std::function<void()> > _tasks;
+	bool _stop;
+	ErrorHandler _errorHandler; /**< Called with exceptions thrown by callbacks, which are discarded if empty. */
+	std::thread _thread;
+};
+
+}
+
+#endif
@@ -0,0 +1,37 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef OCL_CONFIG_H
+#define OCL_CONFIG_H
+
+/*! \brief Selects whether the hot paths validate their arguments.
+  *
+  * Transfers, copies and kernel launches check contexts, pointers and
+  * argument positions if OCL_CHECKED is 1. Errors that OpenCL reports
+  * itself are always thrown by OPENCL_SAFE_CALL.
+  * The value is fixed when the library is configured so that the library and
+  * the applications using it see the same value. Builds with CMake generate
+  * this header from ocl_config.h.in and the OCL_CHECKED option, which is OFF
+  * for Release and MinSizeRel. The Makefile and qmake builds pass -DOCL_CHECKED=0
+  * in their release configuration, the applications must be compiled with it too.
+  */
+#ifndef OCL_CHECKED
+#define OCL_CHECKED 1
+#endif
+
+#endif
@@ -20,6 +20,7 @@
 
 #include <vector>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
 
@@ -40,6 +41,7 @@
 #endif
 
 #include <ocl_device.h>
+#include <ocl_registry.h>
 
 
 namespace ocl{
@@ -47,6 +49,9 @@ namespace ocl{
 class Kernel;
 class Program;
 class Queue;
+class QueuePool;
+class DependencyTracker;
+class Profiler;
 class Platform;
 class Event;
 class Memory;
@@ -68,6 +73,11 @@ class Sampler;
   * when it is provided in their argument list.
   *
   * Note that there can only be one active Context within one Platform.
+  * <br>
+  * Objects may be created, destructed and registered from several threads.
+  * The active Queue and Program are set for each thread separately.
+  * Threads which have not set their own see the one of the thread which has set one first.
+  * The DependencyTracker and Profiler of a Context lock on their own and can be shared by these threads.
 */
 
 class Context
@@ -117,6 +127,9 @@ public:
 	void remove(Queue*);
 	void remove(Memory*);
 	void remove(Sampler*);
+	void remove(QueuePool*);
+	void remove(DependencyTracker*);
+	void remove(Profiler*);
 
 	bool has(const Device&)  const;
 	bool has(DeviceType) const;
@@ -132,30 +145,50 @@ public:
 	void setActiveProgram(Program&);
 
 	Queue& activeQueue() const;
+	Queue& rotateActiveQueue() const;
 	void setActiveQueue(Queue&);
+	void setActiveQueue(QueuePool&);
+	QueuePool* activeQueuePool() const;
+	void track(const Queue&, const Event&);
+
+	void setDependencyTracker(DependencyTracker&);
+	DependencyTracker* dependencyTracker() const;
+
+	void setProfiler(Profiler&);
+	Profiler* profiler() const;
 
 
-	const std::set<Event*>    & events() const;
-	const std::set<Memory*>   & memories() const;
-	const std::set<Queue*>    & queues() const;
-	const std::set<Sampler*>  & samplers() const;
+	std::set<Event*>    events() const;
+	std::set<Memory*>   memories() const;
+	std::set<Queue*>    queues() const;
+	std::set<Sampler*>  samplers() const;
 	const std::vector<Device> & devices() const;
 
+	const std::vector<cl_image_format>& imageFormats(cl_mem_object_type, cl_mem_flags = CL_MEM_READ_WRITE) const;
+	bool supportsImageFormat(const cl_image_format&, cl_mem_object_type, cl_mem_flags = CL_MEM_READ_WRITE) const;
+
 	std::vector<cl_device_id> cl_devices() const;
         
 protected:
 
 	cl_context _id;                  /**< OpenCL context. */
 
-	std::set<Program*>  _programs;    /**< OpenCL programs which shall run on the context. */
-	std::set<Queue*>    _queues;
-	std::set<Event*>    _events;
-	std::set<Memory*>   _memories;
-	std::set<Sampler*>  _samplers;
+	Registry<Program>  _programs;    /**< OpenCL programs which shall run on the context. */
+	Registry<Queue>    _queues;
+	Registry<Event>    _events;
+	Registry<Memory>   _memories;
+	Registry<Sampler>  _samplers;
 	std::vector<Device> _devices;
 
-	Queue* _activeQueue;
-	Program* _activeProgram;
+	ActiveObject<Queue> _activeQueue;
+	ActiveObject<QueuePool> _activeQueuePool; /**< Dispatches commands without an explicit Queue if set. */
+	mutable ActiveObject<Queue> _activePoolQueue; /**< Queue of the active QueuePool selected for each thread. */
+	ActiveObject<Program> _activeProgram;
+	std::atomic<DependencyTracker*> _dependencyTracker; /**< Builds wait lists of commands if set. */
+	std::atomic<Profiler*> _profiler; /**< Records the commands if set. */
+
+	mutable std::mutex _imageFormatsMutex;
+	mutable std::map< std::pair<cl_mem_object_type, cl_mem_flags>, std::vector<cl_image_format> > _imageFormats; /**< Supported image formats for each image type and access. */
 
 };
 
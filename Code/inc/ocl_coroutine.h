@@ -0,0 +1,336 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OCL_COROUTINE_H
+#define OCL_COROUTINE_H
+
+/*! \file ocl_coroutine.h "inc/ocl_coroutine.h"
+  * \brief Awaitables for Event and EventList objects with C++20 coroutines.
+  *
+  * This header is only effective if the compiler supports C++20 coroutines and
+  * is header only so that the library itself can still be compiled as C++11.
+  * Any function returning an Event such as Buffer::readAsync or Kernel::operator()
+  * can then be awaited within a coroutine:
+  *
+  * \code
+  * ocl::Task pipeline(ocl::Queue &queue, ocl::Kernel &kernel, ocl::Buffer &buffer, float *data, size_t size)
+  * {
+  *     co_await buffer.writeAsync(queue, 0, data, size);
+  *     co_await kernel(queue, buffer.id());
+  *     co_await buffer.readAsync(queue, 0, data, size);
+  * }
+  * \endcode
+  *
+  * The coroutine is resumed by the Executor after the command has completed.
+  * By default it is resumed on the thread of the CompletionQueue. With a RunLoop
+  * a single host thread drives any number of coroutines without blocking.
+  */
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#if __has_include(<coroutine>)
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <ocl_event.h>
+#include <ocl_event_list.h>
+#include <ocl_query.h>
+
+#define OCL_COROUTINES 1
+
+namespace ocl{
+
+/*! \brief Function which executes the resumption of a coroutine. */
+typedef std::function<void(std::function<void()>)> Executor;
+
+/*! \brief Returns the mutex and default Executor of all awaitables. */
+inline std::pair<std::mutex, Executor>& defaultExecutor()
+{
+	static std::pair<std::mutex, Executor> executor;
+	return executor;
+}
+
+/*! \brief Sets the Executor which resumes coroutines awaiting an Event.
+  *
+  * An empty Executor resumes them on the thread of the CompletionQueue, which is the default.
+  */
+inline void setExecutor(Executor executor)
+{
+	std::lock_guard<std::mutex> lock(defaultExecutor().first);
+	defaultExecutor().second = std::move(executor);
+}
+
+/*! \brief Returns the Executor which resumes coroutines awaiting an Event. */
+inline Executor executor()
+{
+	std::lock_guard<std::mutex> lock(defaultExecutor().first);
+	return defaultExecutor().second;
+}
+
+/*! \class EventAwaiter ocl_coroutine.h "inc/ocl_coroutine.h"
+  * \brief Suspends a coroutine until the commands of an EventList have completed.
+  *
+  * Throws the error of a command which terminated abnormally when resumed.
+  */
+class EventAwaiter
+{
+public:
+	/*! \brief Instantiates an EventAwaiter resumed by the executor or by the default Executor if empty. */
+	EventAwaiter(const EventList &list, Executor executor = Executor()) :
+		_list(list), _executor(std::move(executor)), _state(std::make_shared<State>())
+	{
+	}
+
+	/*! \brief Returns true if all commands have completed already. */
+	bool await_ready() const
+	{
+		for(size_t i = 0; i < _list.size(); ++i){
+			cl_int status = CL_COMPLETE;
+			OPENCL_SAFE_CALL( clGetEventInfo(_list.data()[i], CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(status), &status, NULL) );
+			if(status != CL_COMPLETE) return false;
+		}
+		return true;
+	}
+
+	/*! \brief Resumes the coroutine after the last command has completed.
+	  *
+	  * The coroutine and thus this EventAwaiter may be destroyed as soon as the last
+	  * callback is registered. Everything needed is therefore copied before.
+	  */
+	void await_suspend(std::coroutine_handle<> handle)
+	{
+		const Executor executor = _executor ? _executor : ocl::executor();
+		const std::shared_ptr<State> state = _state;
+		const std::vector<cl_event> ids(_list.data(), _list.data() + _list.size());
+		state->remaining = ids.size();
+		for(cl_event id : ids){
+			Event::onComplete(id, [state, executor, handle](cl_int result){
+				if(result < 0) state->status = result;
+				if(--state->remaining != 0) return;
+				if(executor) executor([handle]{ handle.resume(); });
+				else handle.resume();
+			});
+		}
+	}
+
+	/*! \brief Throws if a command terminated abnormally. */
+	void await_resume() const
+	{
+		const cl_int status = _state->status;
+		OPENCL_SAFE_CALL( status < 0 ? status : CL_SUCCESS );
+	}
+
+private:
+	/*! \brief Completion state shared with the callbacks. */
+	struct State
+	{
+		State() : remaining(0), status(CL_COMPLETE) {}
+		std::atomic<size_t> remaining;
+		std::atomic<cl_int> status;
+	};
+
+	EventList _list;
+	Executor _executor;
+	std::shared_ptr<State> _state;
+};
+
+/*! \brief Suspends a coroutine until the command of the Event has completed. */
+inline EventAwaiter operator co_await(const Event &event)
+{
+	return EventAwaiter(EventList(event));
+}
+
+/*! \brief Suspends a coroutine until the commands of the EventList have completed. */
+inline EventAwaiter operator co_await(const EventList &list)
+{
+	return EventAwaiter(list);
+}
+
+/*! \brief Suspends a coroutine until the commands of the EventList have completed and resumes it on the executor. */
+inline EventAwaiter resumeOn(Executor executor, const EventList &list)
+{
+	return EventAwaiter(list, std::move(executor));
+}
+
+/*! \class RunLoop ocl_coroutine.h "inc/ocl_coroutine.h"
+  * \brief Executor whose functions are executed on the thread calling run().
+  *
+  * Set it with setExecutor(loop.executor()) or use it with resumeOn
+  * in order to resume all coroutines on one host thread.
+  */
+class RunLoop
+{
+public:
+	RunLoop() : _mutex(), _condition(), _functions() {}
+	RunLoop(const RunLoop&) = delete;
+	RunLoop& operator=(const RunLoop&) = delete;
+
+	/*! \brief Appends the function which is executed by run(). */
+	void post(std::function<void()> function)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_functions.push_back(std::move(function));
+		}
+		_condition.notify_one();
+	}
+
+	/*! \brief Executes the posted functions until done returns true.
+	  *
+	  * Blocks while there is no function and done returns false.
+	  */
+	void run(const std::function<bool()> &done)
+	{
+		while(!done()){
+			std::function<void()> function;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_condition.wait(lock, [this]{ return !_functions.empty(); });
+				function = std::move(_functions.front());
+				_functions.pop_front();
+			}
+			function();
+		}
+	}
+
+	/*! \brief Executes the functions posted so far without blocking and returns their number. */
+	size_t poll()
+	{
+		std::deque< std::function<void()> > functions;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			functions.swap(_functions);
+		}
+		for(auto &function : functions) function();
+		return functions.size();
+	}
+
+	/*! \brief Returns an Executor which posts to this RunLoop. */
+	Executor executor()
+	{
+		return [this](std::function<void()> function){ this->post(std::move(function)); };
+	}
+
+private:
+	std::mutex _mutex;
+	std::condition_variable _condition;
+	std::deque< std::function<void()> > _functions;
+};
+
+/*! \class Task ocl_coroutine.h "inc/ocl_coroutine.h"
+  * \brief Return type of coroutines awaiting Event objects.
+  *
+  * The coroutine starts immediately and runs until its first suspension.
+  * A Task can be awaited by another coroutine. If the Task is destructed before
+  * the coroutine has finished, the coroutine continues and destroys itself at the end.
+  * An exception of the coroutine is thrown by get().
+  */
+class Task
+{
+public:
+	struct promise_type
+	{
+		enum State { Running, Awaited, Detached, Finished };
+
+		promise_type() : state(Running), continuation(), exception() {}
+
+		Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+
+		struct FinalAwaiter
+		{
+			bool await_ready() noexcept { return false; }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+			{
+				promise_type &promise = handle.promise();
+				const int previous = promise.state.exchange(Finished);
+				if(previous == Awaited) return promise.continuation;
+				if(previous == Detached) handle.destroy();
+				return std::noop_coroutine();
+			}
+			void await_resume() noexcept {}
+		};
+
+		FinalAwaiter final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { exception = std::current_exception(); }
+
+		std::atomic<int> state;
+		std::coroutine_handle<> continuation;
+		std::exception_ptr exception;
+	};
+
+	Task(Task &&other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+	Task(const Task&) = delete;
+	Task& operator=(const Task&) = delete;
+
+	/*! \brief Destroys the finished coroutine or lets it destroy itself when it finishes. */
+	~Task()
+	{
+		if(!_handle) return;
+		if(_handle.promise().state.exchange(promise_type::Detached) == promise_type::Finished)
+			_handle.destroy();
+	}
+
+	/*! \brief Returns true if the coroutine has finished. */
+	bool done() const
+	{
+		return _handle && _handle.promise().state.load() == promise_type::Finished;
+	}
+
+	/*! \brief Throws the exception of the finished coroutine if there is one. */
+	void get() const
+	{
+		if(!this->done()) throw std::runtime_error("Task not finished");
+		if(_handle.promise().exception) std::rethrow_exception(_handle.promise().exception);
+	}
+
+	bool await_ready() const { return false; }
+
+	/*! \brief Resumes the awaiting coroutine when this Task has finished. */
+	bool await_suspend(std::coroutine_handle<> handle)
+	{
+		promise_type &promise = _handle.promise();
+		promise.continuation = handle;
+		if(promise.state.exchange(promise_type::Awaited) != promise_type::Finished) return true;
+		promise.state.store(promise_type::Finished);
+		return false;
+	}
+
+	void await_resume() const { this->get(); }
+
+private:
+	explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+	std::coroutine_handle<promise_type> _handle;
+};
+
+}
+
+#endif
+#endif
+
+#endif
@@ -0,0 +1,108 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OCL_DEPENDENCY_TRACKER_H
+#define OCL_DEPENDENCY_TRACKER_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+#include <ocl_event.h>
+#include <ocl_memory.h>
+
+namespace ocl{
+
+class Context;
+class EventList;
+
+/*! \class DependencyTracker ocl_dependency_tracker.h "inc/ocl_dependency_tracker.h"
+  * \brief Builds wait lists of commands from the Memory objects they read and write.
+  *
+  * A DependencyTracker records for each Memory object the Event of the last
+  * command writing it and the Event objects of the commands reading it since.
+  * A command reading a Memory object waits for its last writer (read after write).
+  * A command writing a Memory object waits for its last writer and all
+  * of its readers (write after write, write after read).
+  *
+  * If set for a Context with Context::setDependencyTracker, Kernel executions and
+  * Buffer and Image transfers wait for the commands they depend on in addition
+  * to the EventList provided. Commands on out-of-order Queue objects or on different
+  * Queue objects of a QueuePool can then run concurrently without providing Event
+  * objects manually. Kernel arguments declared const, __constant or read_only are read,
+  * write_only images are written and all other Memory arguments are read and written.
+  * Memory arguments are tracked whether they are passed as Memory, Buffer, Image or cl_mem.
+  * A DependencyTracker can be used by several threads at the same time. The wait list
+  * of a command is built, the command is enqueued and its Event is recorded while the
+  * DependencyTracker is locked so that two threads using the same Memory object cannot
+  * both miss each other's command. Tracked commands are thus enqueued one at a time and
+  * blocking commands keep the DependencyTracker locked until they have completed.
+  */
+class DependencyTracker
+{
+public:
+	/*! \brief Memory objects used by a command together with their Access. */
+	typedef std::vector< std::pair<cl_mem, Memory::Access> > Uses;
+
+	explicit DependencyTracker(Context&);
+	~DependencyTracker();
+
+	DependencyTracker(const DependencyTracker&) = delete;
+	DependencyTracker& operator=(const DependencyTracker&) = delete;
+
+	/*! \brief Enqueues a command with the events it has to wait for and returns its Event. */
+	typedef std::function<Event(const EventList&)> Command;
+	/*! \brief Executes a blocking command with the events it has to wait for. */
+	typedef std::function<void(const EventList&)> BlockingCommand;
+
+	Event enqueue(const Uses&, const EventList&, const Command&);
+	void execute(const Uses&, const EventList&, const BlockingCommand&);
+	void forget(cl_mem);
+	void clear();
+	size_t size() const;
+	Context& context() const;
+
+private:
+	/*! \brief Outstanding commands of a Memory object. */
+	struct State
+	{
+		State() : writer(), readers() {}
+		std::unique_ptr<Event> writer;
+		std::vector<Event> readers;
+	};
+
+	EventList waitList(const Uses&, const EventList&) const;
+	void record(const Uses&, const Event&);
+	void completed(const Uses&);
+
+	Context *_context;
+	mutable std::mutex _mutex;
+	std::map<cl_mem, State> _states;
+};
+
+}
+
+#endif
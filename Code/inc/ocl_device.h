@@ -20,6 +20,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 
 #ifdef __APPLE__
 #include <OpenCL/opencl.h>
@@ -27,6 +28,7 @@
 #include <CL/opencl.h>
 #endif
 #include <ocl_device_type.h>
+#include <ocl_device_info.h>
 
 namespace ocl{
 
@@ -39,10 +41,25 @@ namespace ocl{
   * the same for all compute units. All compute units share a global memory and posses their own local memory. Depending on the
   * architecture of the device, the compute units work in a lock-step single instruction multiple data or single program
   * multiple data fashion.
+  * <br>
+  * The capabilities of a Device are queried once and shared by all copies. See DeviceInfo.
+  * <br>
+  * A Device can be partitioned into sub-devices, e.g. one for each NUMA node of a multi-socket CPU.
+  * A sub-device is a regular Device which can be used for a Context and a Queue. See DevicePartition.
   */
 class  Device
 {
 public:	
+
+	/*! \brief Affinity domain along which a Device is partitioned. */
+	enum AffinityDomain {
+		Numa              = CL_DEVICE_AFFINITY_DOMAIN_NUMA,              /*!< Compute units which share a NUMA node. */
+		L4Cache           = CL_DEVICE_AFFINITY_DOMAIN_L4_CACHE,          /*!< Compute units which share a level 4 cache. */
+		L3Cache           = CL_DEVICE_AFFINITY_DOMAIN_L3_CACHE,          /*!< Compute units which share a level 3 cache. */
+		L2Cache           = CL_DEVICE_AFFINITY_DOMAIN_L2_CACHE,          /*!< Compute units which share a level 2 cache. */
+		L1Cache           = CL_DEVICE_AFFINITY_DOMAIN_L1_CACHE,          /*!< Compute units which share a level 1 cache. */
+		NextPartitionable = CL_DEVICE_AFFINITY_DOMAIN_NEXT_PARTITIONABLE /*!< Next domain in the order NUMA, L4, L3, L2, L1 which can be partitioned. */
+	};
 	
 	Device(const Device&);
 	explicit Device(cl_device_id);
@@ -67,6 +84,7 @@ public:
 	void setId(cl_device_id);
 	cl_device_id id() const;
 	const DeviceType& type() const;
+	const DeviceInfo& info() const;
 
 	std::vector<size_t> maxWorkItemSizes() const;
 	size_t maxWorkItemDim() const;
@@ -79,6 +97,7 @@ public:
 
 	cl_platform_id platform() const;
 	std::string version()    const;
+	std::string driverVersion() const;
 	std::string name()       const;
 	std::string vendor()     const;
 	std::string extensions() const;
@@ -88,9 +107,20 @@ public:
 	bool supportsExtension( std::string const& extension ) const;
 	bool supportsVersion( int major, int minor ) const;
 
+	bool isSubDevice() const;
+	Device parent() const;
+	bool supportsPartition(cl_device_partition_property) const;
+	bool supportsAffinityDomain(AffinityDomain) const;
+	std::vector<Device> partitionEqually(size_t computeUnits) const;
+	std::vector<Device> partitionByCounts(const std::vector<size_t>& computeUnits) const;
+	std::vector<Device> partitionByAffinity(AffinityDomain = Numa) const;
+
 private:
+	std::vector<Device> partition(const std::vector<cl_device_partition_property>&) const;
+
 	cl_device_id _id;
 	DeviceType _type;
+	std::shared_ptr<const DeviceInfo> _info; /**< Capabilities shared by all copies. */
 
 
 };
@@ -0,0 +1,95 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OCL_DEVICE_CLOCK_H
+#define OCL_DEVICE_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+namespace ocl{
+
+class Queue;
+
+/*! \class DeviceClock ocl_device_clock.h "inc/ocl_device_clock.h"
+  * \brief Converts device timestamps into host time and vice versa.
+  *
+  * Profiling times of Event objects are given in the clock of the Device.
+  * A DeviceClock correlates this clock with std::chrono::steady_clock so that
+  * device commands and host spans can be placed on one timeline.
+  *
+  * Each calibration takes several samples of both clocks and keeps the one with
+  * the smallest host interval. The device time is read with clGetDeviceAndHostTimer
+  * if the Device supports it (OpenCL 2.1). Otherwise the queued time of a marker is
+  * used. The markers are enqueued on a private command queue of the DeviceClock
+  * so that calibrate() neither waits for nor delays the commands of the Queue.
+  * With one calibration only the offset is known. Calibrating again later
+  * also estimates the drift between both clocks.
+  */
+class DeviceClock
+{
+public:
+	typedef std::chrono::steady_clock host_clock;
+
+	explicit DeviceClock(const Queue&);
+	DeviceClock(const DeviceClock&) = default;
+	DeviceClock& operator=(const DeviceClock&) = default;
+
+	void calibrate();
+	size_t calibrations() const;
+	bool hasHostTimer() const;
+
+	double offset() const;
+	double drift() const;
+	double error() const;
+
+	host_clock::time_point toHost(cl_ulong device_ns) const;
+	cl_ulong toDevice(host_clock::time_point) const;
+
+	const Queue& queue() const;
+
+private:
+	/*! \brief Simultaneous times of the host and the device in nanoseconds. */
+	struct Sample
+	{
+		Sample() : host(0), device(0), error(0) {}
+		std::int64_t host;
+		cl_ulong device;
+		std::int64_t error;
+	};
+
+	Sample sample() const;
+	Sample sampleOnce() const;
+
+	const Queue *_queue;
+	std::shared_ptr<_cl_command_queue> _markerQueue; /**< Profiling queue for the markers if there is no host timer. */
+	bool _hostTimer;
+	size_t _calibrations;
+	Sample _first;
+	Sample _last;
+};
+
+}
+
+#endif
@@ -0,0 +1,193 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OCL_DEVICE_INFO_H
+#define OCL_DEVICE_INFO_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_set>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+namespace ocl{
+
+/*! \class DeviceInfo ocl_device_info.h "inc/ocl_device_info.h"
+  * \brief Immutable snapshot of the capabilities of an OpenCL device.
+  *
+  * The capabilities are queried once for each cl_device_id and shared by
+  * all Device objects referring to it. Capabilities which are
+  * not supported by the version of the device or by the OpenCL headers are zero.
+  * Use Device::info() in order to access the snapshot of a Device.
+  */
+class DeviceInfo
+{
+public:
+
+	explicit DeviceInfo(cl_device_id);
+
+	DeviceInfo( DeviceInfo const& ) = delete;
+	DeviceInfo& operator =( DeviceInfo const& ) = delete;
+
+	static std::shared_ptr<const DeviceInfo> get(cl_device_id);
+	static void refresh();
+
+	cl_device_id id() const;
+	cl_device_type type() const;
+	cl_platform_id platform() const;
+	cl_device_id parent() const;
+
+	const std::string& name() const;
+	const std::string& vendor() const;
+	const std::string& version() const;
+	const std::string& driverVersion() const;
+	const std::string& openclCVersion() const;
+	const std::string& profile() const;
+	const std::string& extensions() const;
+	cl_uint vendorId() const;
+	int versionMajor() const;
+	int versionMinor() const;
+
+	bool supportsVersion(int major, int minor) const;
+	bool supportsExtension(const std::string&) const;
+
+	size_t maxComputeUnits() const;
+	size_t maxClockFrequency() const;
+	size_t maxWorkItemDim() const;
+	const std::vector<size_t>& maxWorkItemSizes() const;
+	size_t maxWorkGroupSize() const;
+	size_t maxParameterSize() const;
+	size_t partitionMaxSubDevices() const;
+	const std::vector<cl_device_partition_property>& partitionProperties() const;
+	cl_device_affinity_domain partitionAffinityDomain() const;
+
+	size_t preferredVectorWidthChar() const;
+	size_t preferredVectorWidthShort() const;
+	size_t preferredVectorWidthInt() const;
+	size_t preferredVectorWidthLong() const;
+	size_t preferredVectorWidthFloat() const;
+	size_t preferredVectorWidthDouble() const;
+	size_t preferredVectorWidthHalf() const;
+
+	size_t addressBits() const;
+	size_t memBaseAddrAlign() const;
+	size_t maxMemAllocSize() const;
+	size_t globalMemSize() const;
+	size_t globalMemCacheSize() const;
+	size_t globalMemCachelineSize() const;
+	cl_device_mem_cache_type globalMemCacheType() const;
+	size_t localMemSize() const;
+	cl_device_local_mem_type localMemType() const;
+	size_t maxConstantBufferSize() const;
+	size_t maxConstantArgs() const;
+	bool hostUnifiedMemory() const;
+	bool errorCorrectionSupport() const;
+
+	bool imageSupport() const;
+	size_t maxReadImageArgs() const;
+	size_t maxWriteImageArgs() const;
+	size_t maxSamplers() const;
+	size_t image2dMaxWidth() const;
+	size_t image2dMaxHeight() const;
+	size_t image3dMaxWidth() const;
+	size_t image3dMaxHeight() const;
+	size_t image3dMaxDepth() const;
+	size_t imageMaxBufferSize() const;
+	size_t imagePitchAlignment() const;
+
+	cl_device_fp_config singleFpConfig() const;
+	cl_device_fp_config doubleFpConfig() const;
+	cl_device_exec_capabilities executionCapabilities() const;
+	cl_command_queue_properties queueProperties() const;
+	cl_bitfield svmCapabilities() const;
+	size_t profilingTimerResolution() const;
+	bool endianLittle() const;
+	bool available() const;
+	bool compilerAvailable() const;
+	bool linkerAvailable() const;
+
+private:
+	cl_device_id _id;
+	cl_device_type _type;
+	cl_platform_id _platform;
+
+	std::string _name;
+	std::string _vendor;
+	std::string _version;
+	std::string _driverVersion;
+	std::string _openclCVersion;
+	std::string _profile;
+	std::string _extensions;
+	std::unordered_set<std::string> _extensionSet; /**< Extensions for hashed lookups. */
+	cl_uint _vendorId;
+	int _versionMajor;
+	int _versionMinor;
+	cl_device_id _parent;
+
+	size_t _maxComputeUnits;
+	size_t _maxClockFrequency;
+	std::vector<size_t> _maxWorkItemSizes;
+	size_t _maxWorkGroupSize;
+	size_t _maxParameterSize;
+	size_t _partitionMaxSubDevices;
+	std::vector<cl_device_partition_property> _partitionProperties;
+	cl_device_affinity_domain _partitionAffinityDomain;
+	size_t _preferredVectorWidth[7]; /**< char, short, int, long, float, double and half. */
+
+	size_t _addressBits;
+	size_t _memBaseAddrAlign;
+	size_t _maxMemAllocSize;
+	size_t _globalMemSize;
+	size_t _globalMemCacheSize;
+	size_t _globalMemCachelineSize;
+	cl_device_mem_cache_type _globalMemCacheType;
+	size_t _localMemSize;
+	cl_device_local_mem_type _localMemType;
+	size_t _maxConstantBufferSize;
+	size_t _maxConstantArgs;
+	bool _hostUnifiedMemory;
+	bool _errorCorrectionSupport;
+
+	bool _imageSupport;
+	size_t _maxReadImageArgs;
+	size_t _maxWriteImageArgs;
+	size_t _maxSamplers;
+	size_t _image2dMaxSize[2];
+	size_t _image3dMaxSize[3];
+	size_t _imageMaxBufferSize;
+	size_t _imagePitchAlignment;
+
+	cl_device_fp_config _singleFpConfig;
+	cl_device_fp_config _doubleFpConfig;
+	cl_device_exec_capabilities _executionCapabilities;
+	cl_command_queue_properties _queueProperties;
+	cl_bitfield _svmCapabilities;
+	size_t _profilingTimerResolution;
+	bool _endianLittle;
+	bool _available;
+	bool _compilerAvailable;
+	bool _linkerAvailable;
+};
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef OCL_DEVICE_PARTITION_H
+#define OCL_DEVICE_PARTITION_H
+
+#include <memory>
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+#include <ocl_device.h>
+#include <ocl_event.h>
+#include <ocl_event_list.h>
+#include <ocl_queue.h>
+
+namespace ocl{
+
+class Context;
+class Memory;
+
+/*! \class DevicePartition ocl_device_partition.h "inc/ocl_device_partition.h"
+  * \brief Partitions a Device into sub-devices with one Context and one Queue for each sub-device.
+  *
+  * A CPU device spanning two sockets accesses remote memory over the interconnect
+  * whenever work-items of one socket touch pages of the other. Partitioning along
+  * the Numa affinity domain creates one sub-device for each socket. The Queue of a
+  * sub-device only executes on the compute units of its node and pin() hints that
+  * Memory objects should be placed into that node, which the OpenCL implementation
+  * may ignore.
+  * <br>
+  * All sub-devices share one Context so that Buffer objects can be used on each of them.
+  * Use a MultiDeviceLauncher with context() in order to split an index space across the
+  * sub-devices. If the Device cannot be partitioned along the affinity domain, the
+  * partition consists of the Device itself.
+  */
+class DevicePartition
+{
+public:
+	explicit DevicePartition(const Device&, Device::AffinityDomain = Device::Numa, Queue::props = 0);
+	DevicePartition(const Device&, const std::vector<size_t>& computeUnits, Queue::props = 0);
+	~DevicePartition();
+
+	DevicePartition(const DevicePartition&) = delete;
+	DevicePartition& operator=(const DevicePartition&) = delete;
+
+	size_t size() const;
+	bool isPartitioned() const;
+	const Device& device() const;
+	const Device& device(size_t pos) const;
+	const std::vector<Device>& devices() const;
+	Queue& queue(size_t pos) const;
+	Context& context() const;
+
+	void pin(const Memory&, size_t pos, bool discard = false) const;
+	Event pinAsync(const Memory&, size_t pos, bool discard = false, const EventList& list = EventList()) const;
+
+	void finish() const;
+
+private:
+	void create(Queue::props);
+
+	Device _device;                              /**< Partitioned Device. */
+	std::vector<Device> _devices;                /**< Sub-devices or the Device itself. */
+	std::unique_ptr<Context> _context;           /**< Context of all sub-devices. */
+	std::vector< std::unique_ptr<Queue> > _queues; /**< Queue of each sub-device. */
+};
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OCL_DEVICE_SELECTOR_H
+#define OCL_DEVICE_SELECTOR_H
+
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+#include <ocl_device.h>
+#include <ocl_device_type.h>
+
+namespace ocl{
+
+/*! \class DeviceSelector ocl_device_selector.h "inc/ocl_device_selector.h"
+  * \brief Ranks Device objects by their expected performance.
+  *
+  * The score of a Device is a weighted sum of the logarithms of its compute
+  * throughput, memory bandwidth and global memory size plus a bonus for
+  * double precision support. With the Capabilities policy the compute
+  * throughput is estimated from the compute units and the clock frequency
+  * and the bandwidth is not taken into account.
+  * With the Benchmark policy a short micro-benchmark measures the bandwidth
+  * and the compute throughput once for each Device of the process.
+  * <br>
+  * Use best() in order to create a Context and Queue for the fastest Device
+  * instead of the first one in enumeration order.
+  */
+class DeviceSelector
+{
+public:
+	/*! \brief Determines how the performance of a Device is obtained. */
+	enum Policy { Capabilities, Benchmark };
+
+	/*! \brief Performance of a Device. */
+	struct Measurement
+	{
+		double gflops;     /**< Single precision GFLOP/s. */
+		double bandwidth;  /**< Global memory bandwidth in GB/s or zero if not measured. */
+	};
+
+	/*! \brief Lanes assumed for a GPU compute unit, e.g. a warp of 32 threads.
+	  *
+	  * The preferred work-group size multiple would be more accurate
+	  * but can only be queried for a built Kernel.
+	  */
+	static const size_t gpu_lanes_per_compute_unit = 32;
+
+	explicit DeviceSelector(Policy = Capabilities);
+
+	void setPolicy(Policy);
+	Policy policy() const;
+	void setWeights(double compute, double bandwidth, double memory, double doubles);
+
+	double score(const Device&) const;
+	Measurement measurement(const Device&) const;
+	std::vector<Device> rank(const std::vector<Device>&) const;
+	std::vector<Device> rank(const DeviceType& = device_type::ALL) const;
+	Device best(const DeviceType& = device_type::ALL) const;
+
+	static Measurement estimate(const Device&);
+	static Measurement benchmark(const Device&);
+
+private:
+	static Measurement run(const Device&);
+
+	Policy _policy;
+	double _compute;    /**< Weight of the compute throughput. */
+	double _bandwidth;  /**< Weight of the memory bandwidth. */
+	double _memory;     /**< Weight of the global memory size. */
+	double _doubles;    /**< Bonus for double precision support. */
+};
+
+}
+
+#endif
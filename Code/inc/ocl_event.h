@@ -23,6 +23,8 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <functional>
+#include <future>
 
 #ifdef __APPLE__
 #include <OpenCL/opencl.h>
@@ -47,6 +49,9 @@ class Context;
   * as synchronization points when created as user Event objects.The Event objects correspond to
   * a synchronization points. Be carefull with Memory usage. Only free and
   * reuse Memory objects if the Event objects are completed.
+  * Instead of blocking, functions can be executed on the thread of the
+  * CompletionQueue after completion with then() or the completion can be
+  * waited for with a std::future returned by future().
   */
 class Event
 {
@@ -76,12 +81,19 @@ public:
 
 	void 	waitUntilCompleted() const;
 
+	void onComplete(std::function<void(cl_int)> callback) const;
+	static void onComplete(cl_event, std::function<void(cl_int)> callback);
+	std::future<void> then(std::function<void()> function) const;
+	std::future<void> future() const;
+
 	bool 	operator!= ( const Event & other ) const;
 	bool 	operator== ( const Event & other ) const;
 	
 	Event& operator =(const Event & other); 
 
 private:
+	static void CL_CALLBACK complete(cl_event, cl_int, void*);
+
 	cl_event _id;
     Context* _ctxt;
 };
@@ -23,6 +23,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <future>
 
 #ifdef __APPLE__
 #include <OpenCL/opencl.h>
@@ -45,36 +46,56 @@ class Context;
   * reuse Memory objects if the Event objects are completed.
   * The Context of an EventList is determined by its Event objects.Thus,
   * all Event objects must be within the same Context.
+  * <br>
+  * An EventList retains the OpenCL events of its Event objects so that the
+  * Event objects may go out of scope. Up to inline_capacity events are stored
+  * within the EventList itself without allocating memory. The events are
+  * stored contiguously and can be passed to OpenCL with size() and data().
   */
 class EventList
 {
 public:
+    static const size_t inline_capacity = 8; /**< Number of events stored without allocating memory. */
+
     EventList();
     EventList ( const Event& );
     EventList ( const EventList& );
-    ~EventList() = default;
+    EventList ( EventList&& );
+    ~EventList();
 
     void       append   ( const Event & event );
     void       append   ( const EventList & other );
-    const Event& at       ( size_t index ) const;
+    Event      at       ( size_t index ) const;
     bool       contains ( const Event & event ) const;
     bool       isEmpty  () const;
     void       remove   ( const Event &);
     size_t     size     () const;
+    void       clear    ();
 
     ocl::Context& context() const;
 
+    const cl_event* data() const;
     std::vector<cl_event> events() const;
     void  waitUntilCompleted() const;
+    std::future<void> future() const;
     EventList &  operator<< ( const Event & );
     EventList &  operator<< ( const EventList & );
     EventList &  operator=  ( const EventList & );
+    EventList &  operator=  ( EventList && );
 
 private:
-    std::vector<const ocl::Event*> _events;
+    void append(cl_event id);
+    cl_event* begin();
+
+    cl_event _inline[inline_capacity];
+    std::vector<cl_event> _heap; /**< Stores the events once there are more than inline_capacity. */
+    size_t _size;
     ocl::Context* _ctxt;
 };
 
+std::future<void>   when_all(const EventList &list);
+std::future<size_t> when_any(const EventList &list);
+
 }
 
 #endif
@@ -48,6 +48,7 @@ namespace ocl {
 class Memory;
 class Context;
 class Queue;
+class Buffer;
 
 class Image : public Memory
 {
@@ -107,6 +108,8 @@ public:
 	Image(Context&, size_t width, size_t height, ChannelType channel_type = Float, ChannelOrder order = RGBA, Access access = ReadWrite);
 	Image(Context&, size_t width, size_t height, size_t depth, ChannelType channel_type = Float, ChannelOrder order = RGBA, Access access = ReadWrite);
     Image(Context&, unsigned int texture, unsigned long texture_target, long miplevel);
+	Image(Context&, const Buffer&, ChannelType channel_type = Float, ChannelOrder order = RGBA, Access access = ReadWrite);
+	Image(Context&, const Buffer&, size_t width, size_t height, size_t row_pitch = 0, ChannelType channel_type = Float, ChannelOrder order = RGBA, Access access = ReadWrite);
 
 
 	void create(size_t width, size_t height, size_t depth, ImageType image_type, ChannelType channel_type = Float, ChannelOrder order = RGBA, Access access = ReadWrite);
@@ -114,6 +117,8 @@ public:
 	void create(size_t width, size_t height, ChannelType channel_type = Float, ChannelOrder order = RGBA, Access access = ReadWrite);
 	void create(size_t width, ChannelType channel_type = Float, ChannelOrder order = RGBA, Access access = ReadWrite);
     void create(unsigned int texture, unsigned long texture_target, long miplevel);
+	void create(const Buffer&, ChannelType channel_type = Float, ChannelOrder order = RGBA, Access access = ReadWrite);
+	void create(const Buffer&, size_t width, size_t height, size_t row_pitch = 0, ChannelType channel_type = Float, ChannelOrder order = RGBA, Access access = ReadWrite);
 
     void recreate(size_t width, size_t height, ChannelType, ChannelOrder);
 
@@ -148,6 +153,12 @@ public:
 
     void acquireAccess(Queue&);
     void releaseAccess(Queue&, const EventList& = EventList());
+
+    static bool supported(const Context&, ImageType, ChannelType, ChannelOrder, Access = ReadWrite);
+    static size_t pixelSize(ChannelType, ChannelOrder);
+
+protected:
+    void profile(const Event &event, const size_t *region) const;
 };
 }
 
@@ -0,0 +1,121 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef OCL_IMAGE_POOL_H
+#define OCL_IMAGE_POOL_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+#include <ocl_event_list.h>
+#include <ocl_image.h>
+
+namespace ocl{
+
+class Context;
+
+/*! \class ImagePool ocl_image_pool.h "inc/ocl_image_pool.h"
+  * \brief Recycles Image objects of the same type, dimensions, format and access.
+  *
+  * Processing a video allocates images of the same size for every frame.
+  * An ImagePool hands out an idle Image with matching type, dimensions, format
+  * and access if there is one and creates a new Image otherwise. When the last
+  * reference to an acquired Image is dropped, the Image returns to the pool
+  * instead of being released, as long as the pool holds less than capacity()
+  * idle images.
+  * <br>
+  * The content of a recycled Image is undefined. Hand an Image back with
+  * release(std::shared_ptr<Image>&, const EventList&) in order to pass the
+  * commands still using it. An idle Image whose commands have completed is
+  * preferred, otherwise acquire() waits until the commands of the Image have
+  * completed before returning it.
+  */
+class ImagePool
+{
+public:
+	explicit ImagePool(Context&, size_t capacity = 16);
+	~ImagePool();
+
+	ImagePool(const ImagePool&) = delete;
+	ImagePool& operator=(const ImagePool&) = delete;
+
+	std::shared_ptr<Image> acquire(size_t width, Image::ChannelType = Image::Float, Image::ChannelOrder = Image::RGBA, Image::Access = Image::ReadWrite);
+	std::shared_ptr<Image> acquire(size_t width, size_t height, Image::ChannelType = Image::Float, Image::ChannelOrder = Image::RGBA, Image::Access = Image::ReadWrite);
+	std::shared_ptr<Image> acquire(size_t width, size_t height, size_t depth, Image::ChannelType = Image::Float, Image::ChannelOrder = Image::RGBA, Image::Access = Image::ReadWrite);
+
+	void release(std::shared_ptr<Image>&, const EventList &pending);
+
+	void setCapacity(size_t);
+	size_t capacity() const;
+	size_t idle() const;
+	size_t hits() const;
+	size_t misses() const;
+	void clear();
+	Context& context() const;
+
+private:
+	/*! \brief Image type, width, height, depth, channel type, channel order and access. */
+	typedef std::tuple<int, size_t, size_t, size_t, int, int, int> Key;
+
+	/*! \brief Idle Image together with the commands which may still use it. */
+	struct Idle
+	{
+		std::unique_ptr<Image> image;
+		EventList pending;
+	};
+
+	/*! \brief Idle images shared with the deleters of the acquired images. */
+	struct State
+	{
+		State(Context &c, size_t n) : context(&c), mutex(), images(), capacity(n), hits(0), misses(0) {}
+		State(const State&) = delete;
+		State& operator=(const State&) = delete;
+		Context *context;
+		std::mutex mutex;
+		std::multimap<Key, Idle> images;
+		size_t capacity;
+		size_t hits;
+		size_t misses;
+	};
+
+	/*! \brief Deleter of an acquired Image which returns it to the pool. */
+	struct Recycler
+	{
+		std::weak_ptr<State> state;
+		Key key;
+		EventList pending;  /**< Commands which may still use the Image. */
+		void operator()(Image*) const;
+	};
+
+	std::shared_ptr<Image> acquire(Image::ImageType, size_t width, size_t height, size_t depth,
+	                               Image::ChannelType, Image::ChannelOrder, Image::Access);
+
+	std::shared_ptr<State> _state;
+};
+
+}
+
+#endif
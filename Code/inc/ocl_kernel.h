@@ -20,12 +20,15 @@
 #define OCL_KERNEL_H
 
 
+#include <functional>
 #include <string>
 #include <typeinfo>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include <ocl_event.h>
+#include <ocl_memory.h>
 
 #ifdef __APPLE__
 #include <OpenCL/opencl.h>
@@ -44,6 +47,8 @@ class Program;
 class Context;
 class Queue;
 class EventList;
+class Buffer;
+class Image;
 
 /*! \class Kernel ocl_kernel.h "inc/ocl_kernel.h"
   *
@@ -69,10 +74,13 @@ class Kernel
 public:
     /*! \brief Enumeration for the memory locations of the arguments of this Kernel.*/
     enum mem_loc {global,local,host,constant,image,sampler};
+    /*! \brief Name, memory locations and access of the arguments of a kernel function of an intermediate language.*/
+    struct EntryPoint { std::string name; std::vector<mem_loc> memlocs; std::vector<Memory::Access> access; };
     Kernel(const std::string &kernel);
     Kernel(const Program&, const std::string &kernel);
     Kernel(const std::string &kernel, const utl::Type &);
     Kernel(const Program&, const std::string &kernel, const utl::Type &);
+    Kernel(const Program&, const EntryPoint &);
     Kernel(const Kernel&) = delete;
 		Kernel& operator =( Kernel const& ) = delete;
 		~Kernel();
@@ -130,24 +138,35 @@ public:
 
 	const size_t* localSize() const;
 	const size_t* globalSize() const;
+	const size_t* globalOffset() const;
 	size_t localSize(size_t pos) const;
 	size_t globalSize(size_t pos) const;
+	size_t globalOffset(size_t pos) const;
 
 	void setLocalSize(size_t *localSize);
 	void setGlobalSize(size_t *globalSize);
 	void setLocalSize(size_t localSize, size_t pos);
 	void setGlobalSize(size_t globalSize, size_t pos);
+	void setGlobalOffset(size_t globalOffset, size_t pos);
 
 	const std::string& name() const;
 	const std::string& toString() const;
 	size_t numberOfArgs() const;
 	mem_loc memoryLocation(size_t pos) const;
+	Memory::Access access(size_t pos) const;
 
 
 	static std::string specialize(const std::string &kernel, const std::string &type); //const utl::Type &);
+	static std::string specialize(const std::string &kernel, const std::vector<std::string> &arguments);
+	static std::string mangle(const std::vector<std::string> &arguments);
+	static std::vector<std::string> completeArguments(const std::string &kernel, const std::vector<std::string> &arguments);
 	static std::vector<mem_loc> extractMemlocs(const std::string &kernel);
+	static std::vector<Memory::Access> extractAccess(const std::string &kernel);
+	static std::vector<EntryPoint> extractEntryPoints(const std::vector<unsigned char> &il);
 	static std::string extractName(const std::string &kernel);
 	static std::string extractParameter(const std::string& kernel);
+	static std::vector<std::string> extractParameters(const std::string& kernel);
+	static bool typeParameter(const std::string& kernel, size_t pos);
 	static bool templated(const std::string& kernel);
 
 
@@ -155,6 +174,9 @@ public:
     template<class T>
     void setArg(int pos, const T& data);
     void setArg(int pos, cl_mem);    
+    void setArg(int pos, const Memory&);
+    void setArg(int pos, const Buffer&);
+    void setArg(int pos, const Image&);
     void setArg(int pos, cl_sampler);
 
 private:
@@ -195,13 +217,21 @@ private:
     size_t _workDim;
     size_t _globalSize[3];
     size_t _localSize[3];
+    size_t _globalOffset[3]; /**< Offset of the index space which is zero by default. */
     ocl::Event callKernel();
     ocl::Event callKernel(const Queue&, const EventList&);
     ocl::Event callKernel(const Queue&);
+    Event enqueue(const EventList&, const std::function<Event(const EventList&)>&) const;
+    std::vector< std::pair<cl_mem, Memory::Access> > uses() const;
+    const size_t* workOffset() const;
 
     std::string _kernelfunc;
     std::string _name;
     std::vector<mem_loc> _memlocs;
+    std::vector<Memory::Access> _access; /**< Access of the arguments used for dependency tracking. */
+    std::vector<cl_mem> _memArgs;        /**< Memory objects set as arguments. */
+
+    static std::vector<std::string> templateDeclarations(const std::string& kernel, size_t *start = nullptr, size_t *end = nullptr);
 
 };
 
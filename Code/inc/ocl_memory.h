@@ -23,6 +23,7 @@
 #include <string>
 #include <sstream>
 #include <utility>
+#include <functional>
 
 #ifdef __APPLE__
 #include <OpenCL/opencl.h>
@@ -30,6 +31,8 @@
 #include <CL/opencl.h>
 #endif
 
+#include <ocl_event_list.h>
+
 
 namespace ocl{
 
@@ -50,6 +53,8 @@ namespace ocl{
 class Queue;
 class Context;
 class Device;
+class Event;
+class EventList;
 
 class Memory
 {
@@ -66,6 +71,8 @@ public:
 	cl_mem_flags 	flags () const;
     void release();
 	void unmap ( void * mapped_ptr ) const;
+	void migrate ( const Queue &, bool discard = false, const EventList & list = EventList() ) const;
+	Event migrateAsync ( const Queue &, bool discard = false, const EventList & list = EventList() ) const;
 	cl_mem 	id () const;
 	size_t 	size_bytes () const;
 	bool 	operator!= ( const Memory & other ) const;
@@ -86,6 +93,10 @@ protected:
     Memory (Memory && other);
     virtual ~Memory ();
 
+    Event enqueue(const EventList &list, Access access, const Memory *dest, const std::function<Event(const EventList&)> &command) const;
+    void execute(const EventList &list, Access access, const Memory *dest, const std::function<void(const EventList&)> &command) const;
+    void profile(const Event &event, size_t size_bytes) const;
+
 protected:
 	Context *_ctxt;
     cl_mem _id;
@@ -0,0 +1,68 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OCL_MODULE_H
+#define OCL_MODULE_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ocl{
+
+/*! \class Module ocl_module.h "inc/ocl_module.h"
+  *
+  * \brief Named unit of OpenCL C source code which can be included by a Program.
+  *
+  * A Module holds kernel functions and auxiliary code such as helper
+  * functions, typedefs and defines. Modules are included into a Program either
+  * directly or by an #include "name" directive within the source of the Program
+  * or of another Module. Each Module is included at most once per Program so that
+  * shared auxiliary code is emitted only once. Modules are identified by their
+  * name or path and by their source.
+  *
+  * Modules read from files are cached by their path. A file is only read
+  * again if its modification time or size changed and only parsed again if
+  * its content hash changed.
+  */
+class Module
+{
+public:
+	Module();
+	Module(const std::string &name, const std::string &source);
+
+	const std::string& name() const;
+	const std::string& source() const;
+	const std::vector<std::string>& includes() const;
+	size_t hash() const;
+
+	static std::shared_ptr<const Module> load(const std::string &name, const std::vector<std::string> &paths);
+	static std::string locate(const std::string &name, const std::vector<std::string> &paths);
+	static std::string stripIncludes(const std::string &source, std::vector<std::string> *includes,
+	                                 const std::function<bool(const std::string&)> &resolvable = std::function<bool(const std::string&)>());
+
+private:
+	std::string _name;
+	std::string _source;  /**< Source including the #include directives. */
+	std::vector<std::string> _includes; /**< Names of the included modules in order of their appearance. */
+	size_t _hash;         /**< Hash of the original source. */
+};
+
+}
+
+#endif
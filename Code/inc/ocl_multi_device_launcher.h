@@ -0,0 +1,177 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OCL_MULTI_DEVICE_LAUNCHER_H
+#define OCL_MULTI_DEVICE_LAUNCHER_H
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+#include <ocl_buffer.h>
+#include <ocl_event.h>
+#include <ocl_event_list.h>
+#include <ocl_kernel.h>
+#include <ocl_queue.h>
+
+namespace ocl{
+
+class Context;
+class Device;
+
+/*! \class MultiDeviceLauncher ocl_multi_device_launcher.h "inc/ocl_multi_device_launcher.h"
+  * \brief Splits the index space of a Kernel across all Device objects of a Context.
+  *
+  * The index space is split along its last dimension, i.e. x for 1D and y for 2D,
+  * into contiguous parts which are multiples of the local size. Each Device executes
+  * its part with a global offset on its own Queue. The parts are proportional to the
+  * throughput of each Device, which is measured with the profiling information of
+  * completed executions and adapted between calls. Before the first measurement of a
+  * Device its part is proportional to the number of compute units times the clock frequency.
+  *
+  * Buffer objects registered with scatter() are written and those registered with
+  * gather() are read for the part of each Device. The first Device works on the
+  * registered Buffer itself, every other Device on its own Buffer of the same size
+  * which replaces the registered one in the arguments of the Kernel. The devices
+  * thus never share a registered memory object, and the registered Buffer only holds
+  * the part of the first Device afterwards. Note that the Kernel must only access the
+  * elements of its own global IDs.
+  */
+class MultiDeviceLauncher
+{
+public:
+	MultiDeviceLauncher(Context&, Queue::props = 0);
+	~MultiDeviceLauncher();
+
+	MultiDeviceLauncher(const MultiDeviceLauncher&) = delete;
+	MultiDeviceLauncher& operator=(const MultiDeviceLauncher&) = delete;
+
+	size_t size() const;
+	Queue& queue(size_t pos) const;
+	const Device& device(size_t pos) const;
+	double share(size_t pos) const;
+	double throughput(size_t pos) const;
+	Context& context() const;
+
+	void setAdaptation(double rate);
+	double adaptation() const;
+
+	void scatter(const Buffer&, const void *data, size_t bytesPerIndex);
+	void gather(const Buffer&, void *data, size_t bytesPerIndex);
+	void clearTransfers();
+
+	void finish() const;
+
+	/*! \brief Executes the Kernel with the arguments on all Device objects.
+	*
+	* The registered Buffer slices are written before and read after
+	* the execution on each Device. Returns the events of the last command
+	* of each Device. See Kernel::operator()(const Queue&, const EventList&, const Types&...).
+	*/
+	template<class ... Types>
+	EventList operator()(Kernel &kernel, const Types& ... args)
+	{
+		const std::vector<Part> parts = this->partition(kernel);
+		EventList events;
+		try{
+			for(const Part &part : parts){
+				const EventList writes = this->write(part);
+				this->setRange(kernel, part);
+				const Event execution = kernel(*this->_slots[part.pos]->queue, writes, this->argument(part.pos, args)...);
+				events << this->read(part, writes, execution);
+			}
+		}
+		catch(...){
+			this->restore(kernel, parts);
+			throw;
+		}
+		this->restore(kernel, parts);
+		return events;
+	}
+
+private:
+	/*! \brief Range of the index space executed by one Device. */
+	struct Part
+	{
+		size_t pos;      /**< Position of the Device. */
+		size_t dim;      /**< Dimension along which the index space is split. */
+		size_t base;     /**< Offset of the whole index space. */
+		size_t offset;   /**< First index of the part relative to base. */
+		size_t count;    /**< Number of indices of the part. */
+		size_t global;   /**< Global size of the whole index space. */
+	};
+
+	/*! \brief Buffer whose slices are written or read for each part. */
+	struct Transfer
+	{
+		const Buffer *buffer;
+		const void *source;
+		void *target;
+		size_t bytesPerIndex;
+		size_t size;
+	};
+
+	/*! \brief First and last command of a part which has not been measured yet. */
+	struct Sample
+	{
+		Sample(const Event &f, const Event &l, size_t c) : first(f), last(l), count(c) {}
+		Event first;
+		Event last;
+		size_t count;
+	};
+
+	/*! \brief Queue of a Device together with its throughput. */
+	struct Slot
+	{
+		explicit Slot(Queue *q) : queue(q), throughput(0), share(0), pending() {}
+		std::unique_ptr<Queue> queue;
+		double throughput;            /**< Measured indices per nanosecond or zero. */
+		double share;                 /**< Fraction of the index space of the last call. */
+		std::vector<Sample> pending;
+	};
+
+	void replicate(const Buffer&);
+	const Buffer& buffer(size_t pos, const Buffer&) const;
+	cl_mem argument(size_t pos, cl_mem) const;
+	const Buffer& argument(size_t pos, const Buffer&) const;
+	/*! \brief Returns arguments which are not a registered Buffer unchanged. */
+	template<class T>
+	const T& argument(size_t, const T &arg) const { return arg; }
+
+	std::vector<Part> partition(const Kernel&);
+	void measure();
+	EventList write(const Part&) const;
+	EventList read(const Part&, const EventList &writes, const Event &execution);
+	void setRange(Kernel&, const Part&) const;
+	void restore(Kernel&, const std::vector<Part>&) const;
+
+	Context *_context;
+	double _adaptation;
+	std::vector< std::unique_ptr<Slot> > _slots;
+	std::vector<Transfer> _transfers;
+	std::map< const Buffer*, std::vector< std::unique_ptr<Buffer> > > _replicas; /**< Buffer of each further Device for each registered Buffer. */
+};
+
+}
+
+#endif
@@ -30,6 +30,8 @@
 #include <CL/opencl.h>
 #endif
 
+#include <ocl_registry.h>
+
 
 /**
 * @mainpage C++ Wrapper for OpenCL
@@ -69,6 +71,9 @@ class Queue;
   * switched any time in the program flow. Within one Context multiple Queue objects
   * can be created. One of these must be selected as an active Queue on
   * which commands are enqueued. Multiple Platforms may exist.
+  * <br>
+  * The active Platform and the active Context are set for each thread separately.
+  * Threads which have not set their own see the one of the thread which has set one first.
   *
   */
 class Platform
@@ -129,12 +134,12 @@ public:
     
 private: 
 
-    static Platform *_activePlatform;
+    static ActiveObject<Platform>& active();
 
     std::vector<Device> _devices;
     cl_platform_id _id;
-	Context * _activeContext;
-	std::set<Context*> _contexts;
+	ActiveObject<Context> _activeContext;
+	Registry<Context> _contexts;
 
 };
 
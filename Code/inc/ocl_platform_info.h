@@ -0,0 +1,92 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef OCL_PLATFORM_INFO_H
+#define OCL_PLATFORM_INFO_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+#include <ocl_device_info.h>
+
+namespace ocl{
+
+/*! \class PlatformInfo ocl_platform_info.h "inc/ocl_platform_info.h"
+  * \brief Immutable snapshot of an OpenCL platform and its devices.
+  *
+  * The platforms and their devices are enumerated lazily on the first
+  * call of all() or get() and cached for the whole process. The cache is shared
+  * by Platform, Device and the query functions such as ocl::platforms(),
+  * ocl::devices() and ocl::name() so that the ICD loader is only asked once.
+  * Only the ids of the devices are enumerated, their DeviceInfo is obtained on demand.
+  * <br>
+  * Call refresh() in order to enumerate the platforms again, e.g. after a
+  * device has been added to the system.
+  */
+class PlatformInfo
+{
+public:
+
+	explicit PlatformInfo(cl_platform_id);
+
+	PlatformInfo( PlatformInfo const& ) = delete;
+	PlatformInfo& operator =( PlatformInfo const& ) = delete;
+
+	static std::vector< std::shared_ptr<const PlatformInfo> > all();
+	static std::shared_ptr<const PlatformInfo> get(cl_platform_id);
+	static void refresh();
+
+	cl_platform_id id() const;
+	const std::string& profile() const;
+	const std::string& version() const;
+	const std::string& name() const;
+	const std::string& vendor() const;
+	const std::string& extensions() const;
+	bool supportsVersion(int major, int minor) const;
+
+	const std::vector<cl_device_id>& devices() const;
+	const std::vector< std::shared_ptr<const DeviceInfo> >& deviceInfos() const;
+	cl_device_type deviceTypes() const;
+
+private:
+	cl_platform_id _id;
+	std::string _profile;
+	std::string _version;
+	std::string _name;
+	std::string _vendor;
+	std::string _extensions;
+	int _versionMajor;
+	int _versionMinor;
+	std::vector<cl_device_id> _devices;
+	mutable std::once_flag _deviceInfosOnce;
+	mutable std::vector< std::shared_ptr<const DeviceInfo> > _deviceInfos; /**< Snapshots of the devices obtained on demand. */
+	mutable std::once_flag _deviceTypesOnce;
+	mutable cl_device_type _deviceTypes;                                   /**< Union of the types of all devices queried on demand. */
+};
+
+}
+
+#endif
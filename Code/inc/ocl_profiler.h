@@ -0,0 +1,126 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OCL_PROFILER_H
+#define OCL_PROFILER_H
+
+#include <chrono>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+#include <ocl_event.h>
+
+namespace ocl{
+
+class Context;
+class DeviceClock;
+
+/*! \class Profiler ocl_profiler.h "inc/ocl_profiler.h"
+  * \brief Records the commands of a Context and writes them as Chrome trace.
+  *
+  * If set for a Context with Context::setProfiler, the Event of each Kernel
+  * execution and asynchronous Buffer or Image command is recorded together
+  * with the Kernel name and the number of bytes transferred. Blocking commands
+  * do not create an Event and are not recorded. Without a Profiler, a command
+  * only checks whether one is set.
+  *
+  * The Queue objects must be created with CL_QUEUE_PROFILING_ENABLE.
+  * write() and save() wait for the recorded commands and write a JSON timeline
+  * which can be opened with chrome://tracing or Perfetto. Each Device is
+  * shown as a process and each Queue as a thread so that overlapping transfers
+  * and kernels become visible.
+  *
+  * Host spans such as the build of a Program can be recorded as well. If a
+  * DeviceClock is set for a Device, the times of its commands are converted
+  * into host time so that they appear on the same timeline as the host spans.
+  *
+  * The times of completed commands are queried while recording and their
+  * Event objects are released. A Profiler can be used by several threads at the same time.
+  */
+class Profiler
+{
+public:
+	explicit Profiler(Context&);
+	~Profiler();
+
+	Profiler(const Profiler&) = delete;
+	Profiler& operator=(const Profiler&) = delete;
+
+	void record(const Event&, const std::string &name = std::string(), size_t size_bytes = 0);
+	void record(const std::string &name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end);
+	void setClock(const DeviceClock&);
+	void clear();
+	size_t size() const;
+	Context& context() const;
+
+	void write(std::ostream&) const;
+	void save(const std::string &filename) const;
+
+private:
+	/*! \brief Recorded command. */
+	struct Record
+	{
+		Record(const Event &e, const std::string &n, size_t s) :
+			event(new Event(e)), name(n), size_bytes(s), valid(false), type(0), queue(0), device(0), times() {}
+		Record(const Record&) = delete;
+		Record& operator=(const Record&) = delete;
+		Record(Record&&) = default;
+		Record& operator=(Record&&) = default;
+		std::unique_ptr<Event> event; /**< Released once the times are queried. */
+		std::string name;
+		size_t size_bytes;
+		bool valid;                   /**< True if the command completed and has profiling information. */
+		cl_command_type type;
+		cl_command_queue queue;
+		cl_device_id device;
+		cl_ulong times[4];            /**< Queued, submitted, start and end time in the clock of the Device. */
+	};
+
+	/*! \brief Recorded host span. */
+	struct Span
+	{
+		Span(const std::string &n, std::chrono::steady_clock::time_point b, std::chrono::steady_clock::time_point e) : name(n), begin(b), end(e) {}
+		std::string name;
+		std::chrono::steady_clock::time_point begin;
+		std::chrono::steady_clock::time_point end;
+	};
+
+	static bool resolve(Record&, bool wait);
+	void resolveCompleted();
+
+	Context *_context;
+	mutable std::mutex _mutex;
+	mutable std::vector<Record> _records; /**< Records are resolved when written. */
+	std::vector<Span> _spans;
+	std::map<cl_device_id, const DeviceClock*> _clocks;
+	size_t _unresolved;                   /**< Number of records still holding an Event. */
+	size_t _resolveAt;                    /**< Number of unresolved records at which completed ones are resolved. */
+};
+
+}
+
+#endif
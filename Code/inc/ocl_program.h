@@ -18,9 +18,18 @@
 #ifndef OCL_PROGRAM_H
 #define OCL_PROGRAM_H
 
-// #include <map>
+#include <map>
+#include <future>
+#include <iostream>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
 
 #ifdef __APPLE__
 #include <OpenCL/opencl.h>
@@ -28,6 +37,8 @@
 #include <CL/opencl.h>
 #endif
 #include <utl_type.h>
+#include <ocl_module.h>
+#include <ocl_bundle.h>
 
 namespace ocl{
 
@@ -80,6 +91,8 @@ namespace compile_option{
 namespace ocl{
 class Kernel;
 class Context;
+class Device;
+class KernelHandle;
 
 
 /*! \class Program ocl_program.h "inc/ocl_program.h"
@@ -90,6 +103,15 @@ class Context;
   * and auxiliary functions within a single Context. It is used
   * for building, compiling and linking of Kernel objects together.
   * A Program creates Kernel objects by either reading them from a stream or string.
+  * Auxiliary code outside of kernel functions keeps its order relative to the
+  * kernel functions. Repeated auxiliary code is emitted once unless it contains
+  * preprocessor directives. #include "name" directives are resolved by Module objects
+  * which are registered with addModule() or found in the include paths. Other
+  * directives are left to the compiler.
+  * Alternatively, a Program is created from a SPIR-V module with loadIL()
+  * whose kernel functions are looked up and called like those read from source.
+  * If a Bundle is set, the Program is created from its precompiled binaries
+  * when they match all Device objects and is built from source otherwise.
   * Kernel objects owned by the Program are stored within a map and
   * accessed via their function name. While a Program object is only valid for one Context,
   * a Context might have multiple Program objects. In order to
@@ -107,13 +129,26 @@ class Program
   typedef std::vector< std::unique_ptr< Kernel > > Kernels;
 	typedef Kernels::const_iterator const_iterator;
 	typedef Kernels::iterator iterator;
+	typedef std::map< std::string, std::pair< std::string, cl_program > > Objects;
 public:
+	/*! \brief Preprocessor definitions (name, value) by which a variant of a Program is specialized.*/
+	typedef std::map< std::string, std::string > Defines;
+	/*! \brief Template arguments by which a templated Kernel function is instantiated.*/
+	typedef std::vector< std::string > Arguments;
+	static const size_t default_variant_limit = 8; /**< Number of resident variants unless changed with setVariantLimit(). */
+
     Program();
 	~Program();
 	explicit Program(ocl::Context& ctxt, const utl::Types&, const CompileOption & o = CompileOption());
     explicit Program(ocl::Context& ctxt, const CompileOption & o = CompileOption());
 
     void build();
+    std::shared_future<void> buildAsync();
+    std::shared_future<void> buildAsync(const std::vector<ocl::Device> &devices);
+    void waitForBuild() const;
+    bool isBuilding() const;
+    void compile();
+    void link();
 	cl_program id() const;
     Context& context() const;
 	void setContext(Context&);
@@ -121,7 +156,27 @@ public:
 
     Program& operator << (const std::string &kernels);
     Program& operator << (std::istream& stream);
+    Program& operator << (const Module &module);
+
+    void addModule(const Module &module);
+    void addIncludePath(const std::string &path);
+    const std::vector<std::string>& includePaths() const;
+
+    void loadIL(const std::vector<unsigned char> &il);
+    void loadIL(std::istream &stream);
+    bool isIL() const;
+    void setSpecializationConstant(cl_uint id, size_t size, const void *value);
+    template<class T>
+    void setSpecializationConstant(cl_uint id, const T &value);
+    void clearSpecializationConstants();
 
+    void setBundle(const Bundle *bundle);
+    const Bundle* bundle() const;
+    bool isBuiltFromBinary() const;
+    Bundle binaries() const;
+
+    void setLazy(bool lazy);
+    bool isLazy() const;
     void setTypes(const utl::Types &);
     void setTypes(utl::Types &&);
     const utl::Types& types() const;
@@ -133,9 +188,26 @@ public:
     bool isBuilt() const;
     Kernel& kernel(const std::string &name);
     Kernel& kernel(const std::string &name, const utl::Type &);
+    Kernel& kernel(const char *name);
+    Kernel& kernel(const char *name, const utl::Type &);
+    Kernel& instantiate(const std::string &name, const Arguments &arguments);
+    bool isTemplate(const std::string &name) const;
+    KernelHandle handle(const std::string &name);
+    KernelHandle handle(const std::string &name, const utl::Type &);
+    size_t generation() const;
 
     template<class T>
     Kernel& kernel(const std::string &name);
+    template<class T>
+    Kernel& kernel(const char *name);
+
+    Kernel& kernel(const std::string &name, const Defines &defines);
+    Kernel& kernel(const std::string &name, const utl::Type &, const Defines &defines);
+    Program& variant(const Defines &defines);
+    void setVariantLimit(size_t limit);
+    size_t variantLimit() const;
+    size_t numberOfVariants() const;
+    void clearVariants();
 
     bool operator==(const Program &other) const;
     bool operator!=(const Program &other) const;
@@ -143,6 +215,10 @@ public:
     Program& operator =( Program const& ) = delete;
     
     Program( Program const& ) = delete;
+
+    static void buildAll(const std::vector<Program*> &programs);
+    template<class ... Programs>
+    static void buildAll(Program &first, Programs& ... rest);
      
 private:
 
@@ -151,22 +227,129 @@ private:
 	cl_program _id; /**< OpenCL program for a OpenCL context. */
     Context *_context;
 	Kernels _kernels;  /**< Set of kernels which are created and ready for command queue insertion. */
+	/*! \brief Entry of the kernel index. Specialized kernels are indexed by their full name and by their template name and Type. */
+	struct IndexEntry { std::string name; const std::type_info *type; Kernel *kernel; };
+	typedef std::unordered_multimap< size_t, IndexEntry > Index;
+	Index _index;      /**< Kernel objects hashed by (name, type_info of the Type). */
+	std::unordered_map< const Kernel*, std::vector< size_t > > _indexKeys; /**< Keys of the index entries of each Kernel. */
+	size_t _generation; /**< Incremented whenever Kernel objects are added, replaced or removed. */
+	Objects _objects;  /**< Compiled object per kernel name together with the source it was compiled from. */
+	std::map< std::string, std::string > _templates; /**< Templated kernel functions by name which are instantiated on request. */
+	bool _lazy; /**< If true, templated kernel functions are specialized and built per Type on first use. */
+	std::map< std::string, std::string > _lazyTemplates; /**< Templated kernel functions by name awaiting a Type on first use. */
+	std::map< std::type_index, std::unique_ptr< Program > > _typeGroups; /**< Built specializations of all lazy templates per Type. */
+	typedef std::list< std::pair< std::string, std::unique_ptr< Program > > > Variants;
+	Variants _variants; /**< Built variants specialized by Defines, most recently used first. */
+	std::map< std::string, Variants::iterator > _variantIndex;
+	size_t _variantLimit;
+	std::vector< std::string > _sources; /**< Source read into this Program in order without resolved #include directives. */
+	std::vector< std::pair< std::string, Arguments > > _instances; /**< Kernel templates instantiated on request. */
     utl::Types _types;
     ocl::CompileOption _options;
+	std::vector< std::string > _includePaths; /**< Directories in which included modules are searched. */
+	std::map< std::string, std::shared_ptr< const Module > > _modules; /**< Registered modules by name. */
+	std::vector< std::pair< std::string, std::shared_ptr< const Module > > > _included; /**< Modules included into this Program by their name or path. */
+	std::vector< unsigned char > _il; /**< SPIR-V module from which this Program is created instead of source. */
+	std::map< cl_uint, std::vector< unsigned char > > _specializationConstants; /**< Values of specialization constants of the SPIR-V module by id. */
+	const Bundle *_bundle; /**< Precompiled binaries which are preferred over the source. */
+	bool _fromBinary; /**< True if this Program has been created from binaries of the Bundle. */
+	bool _deferred; /**< True if the build of a Program with only lazy templates is deferred to their first use. */
 
+	void read(const std::string &kernels);
+	void include(const std::string &name, const std::string &directory);
+	void include(const std::string &key, const std::shared_ptr< const Module > &module, const std::string &directory);
+	std::string includeModules(const std::string &source, const std::string &directory = std::string());
+	std::vector<std::string> searchPaths(const std::string &directory) const;
+	std::string helpers(size_t position = std::string::npos) const;
+	void eraseKernel(const Kernel *kernel);
 	std::string nextKernel(const std::string &kernels, size_t pos);
 	void eraseComments(std::string &file_string) const;
     void checkBuild(cl_int buildErr) const;
+    Kernel* find(const char *name, size_t length, const utl::Type *type) const;
+    bool isLazyTemplate(const char *name, size_t length) const;
+    void index(const std::string &name, const utl::Type *type, Kernel *kernel);
+    void unindex(const Kernel *kernel);
+    void insertKernel(std::unique_ptr< Kernel > kernel, const std::string &templateName, const utl::Type *type);
+    static size_t hash(const char *name, size_t length, const std::type_info *type);
+    void checkBuild(cl_program program, cl_int buildErr) const;
+    void releaseObjects();
+    Program& typeGroup(const utl::Type &type);
+    void clearTypeGroups();
+    std::string linkOptions() const;
+    static std::string internalize(const std::string &code);
+    void createProgram(bool binary = true);
+    bool createProgramFromBundle(const std::string &source);
+    void createProgramFromIL();
+    cl_int rebuildFromSource(const std::vector<cl_device_id> &devices = std::vector<cl_device_id>());
+    bool deferBuild();
+    void createKernels();
+    void notifyBuild(cl_int buildErr);
+    void completeBuild(cl_int buildErr) const;
+    static void CL_CALLBACK buildNotify(cl_program, void *program);
+
+    mutable std::mutex _buildMutex; /**< Guards the promise of a pending asynchronous build. */
+    std::unique_ptr< std::promise<cl_int> > _buildPromise;
+    std::shared_future<cl_int> _buildNotified; /**< Ready when the OpenCL implementation finished the build. */
+    std::shared_future<void> _buildFuture;     /**< Checks the build and creates the Kernel objects on the waiting thread. */
     
+    /*! \brief Code outside of kernel functions which precedes the Kernel at the position within _kernels. */
+    struct CodeBlock { size_t position; std::string code; };
+
     /**
-     * Code common to all kernels.
-     * 
-     * Constraint: commonCodeBlocks_.size() == _kernels.size() + 1
+     * Code common to all kernels in order of appearance.
      */
-    std::vector< std::string > commonCodeBlocks_;
+    std::vector< CodeBlock > commonCodeBlocks_;
     
     void checkConstraints() const;
 };
+
+/*! \class KernelHandle ocl_program.h "inc/ocl_program.h"
+  *
+  * \brief Handle to a Kernel of a Program that can be kept by the caller.
+  *
+  * The Kernel is resolved through the index of the Program on first access
+  * and cached afterwards. The handle resolves the Kernel again if Kernel objects
+  * of the Program have been added, replaced or removed in the meantime.
+  */
+class KernelHandle
+{
+public:
+	KernelHandle();
+	KernelHandle(Program &program, const std::string &name, const utl::Type *type = nullptr);
+	KernelHandle(const KernelHandle&) = default;
+	KernelHandle& operator=(const KernelHandle&) = default;
+
+	Kernel& kernel() const;
+	Kernel& operator*() const;
+	Kernel* operator->() const;
+
+private:
+	Program *_program;
+	std::string _name;
+	const utl::Type *_type;
+	mutable Kernel *_kernel;
+	mutable size_t _generation;
+};
+
+/*! \brief Sets the value of the specialization constant with the specified id.
+  *
+  * See setSpecializationConstant(cl_uint, size_t, const void*).
+*/
+template<class T>
+void Program::setSpecializationConstant(cl_uint id, const T &value)
+{
+	setSpecializationConstant(id, sizeof(T), &value);
+}
+
+/*! \brief Builds the specified Program objects in parallel.
+  *
+  * See Program::buildAll(const std::vector<Program*>&).
+*/
+template<class ... Programs>
+void Program::buildAll(Program &first, Programs& ... rest)
+{
+	buildAll(std::vector<Program*>{ &first, &rest... });
+}
 }
 
 #endif
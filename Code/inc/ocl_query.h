@@ -20,6 +20,7 @@
 
 #include <string>
 #include <iostream>
+#include <stdexcept>
 
 #ifdef __APPLE__
 #include <OpenCL/opencl.h>
@@ -27,8 +28,20 @@
 #include <CL/opencl.h>
 #endif
 
+#include <ocl_config.h>
+
 #define OPENCL_SAFE_CALL(status) ocl::safe_call(status,__FILE__,__FUNCTION__,__LINE__);
 
+/*! \brief Throws a std::runtime_error with the message if the condition does not hold.
+  *
+  * Neither the condition nor the message is evaluated if OCL_CHECKED is 0.
+  */
+#if OCL_CHECKED
+#define OCL_ASSERT(condition, message) do { if(!(condition)) throw std::runtime_error(message); } while(0)
+#else
+#define OCL_ASSERT(condition, message) do { } while(0)
+#endif
+
 
 
 namespace ocl
@@ -90,6 +103,7 @@ namespace ocl
 
 
     void safe_call(cl_int status, const std::string file, const std::string function, const int line);
+    bool checked();
 	double execTime(cl_event event);
 
 
@@ -0,0 +1,138 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OCL_QUEUE_POOL_H
+#define OCL_QUEUE_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+#include <ocl_event.h>
+#include <ocl_kernel.h>
+#include <ocl_queue.h>
+
+namespace ocl{
+
+class Context;
+class Device;
+
+/*! \class QueuePool ocl_queue_pool.h "inc/ocl_queue_pool.h"
+  * \brief Set of command Queue objects to which independent commands are dispatched.
+  *
+  * A QueuePool owns several Queue objects of one Device or of all Device
+  * objects of a Context. Each command is dispatched either round-robin or to the
+  * Queue with the fewest commands in flight. Commands are counted as in flight
+  * from dispatch until their Event completes.
+  *
+  * A QueuePool can be set as the active Queue of its Context. Calls without
+  * an explicit Queue such as Buffer::read(void*, size_t) or Kernel::operator()(args...)
+  * are then enqueued to the Queue which the QueuePool has selected for the calling
+  * thread, until Context::rotateActiveQueue() selects the next one. Note that commands
+  * on different Queue objects are not ordered. Dependent commands must be synchronized
+  * with Event objects or dispatched to the same Queue.
+  */
+class QueuePool
+{
+public:
+	/*! \brief Strategy by which a Queue is selected for the next command. */
+	enum Policy { RoundRobin, LeastLoaded };
+
+	QueuePool(Context&, const Device&, size_t size, Queue::props = 0, Policy = LeastLoaded);
+	QueuePool(Context&, size_t sizePerDevice, Queue::props = 0, Policy = LeastLoaded);
+	~QueuePool();
+
+	QueuePool(const QueuePool&) = delete;
+	QueuePool& operator=(const QueuePool&) = delete;
+
+	Queue& next();
+	Queue& next(const Device&);
+	Queue& queue(size_t pos) const;
+	size_t size() const;
+	size_t inFlight() const;
+	size_t inFlight(size_t pos) const;
+
+	void setPolicy(Policy);
+	Policy policy() const;
+	Context& context() const;
+
+	const Event& track(const Queue&, const Event&);
+	void flush() const;
+	void finish() const;
+
+	/*! \brief Calls the function with the next Queue and tracks the returned Event.
+	*
+	* The function takes a Queue& and must return the Event of the enqueued command,
+	* e.g. [&](ocl::Queue &q){ return buffer.writeAsync(q, 0, data, size); }.
+	*/
+	template<class Function>
+	Event dispatch(Function function)
+	{
+		Queue &q = next();
+		Event event = function(q);
+		track(q, event);
+		return event;
+	}
+
+	/*! \brief Executes the Kernel with the arguments on the next Queue.
+	*
+	* See Kernel::operator()(const Queue&, const Types&...).
+	*/
+	template<class ... Types>
+	Event operator()(Kernel &kernel, const Types& ... args)
+	{
+		Queue &q = next();
+		Event event = kernel(q, args...);
+		track(q, event);
+		return event;
+	}
+
+private:
+	/*! \brief Queue together with the number of its commands in flight. */
+	struct Slot
+	{
+		Slot(QueuePool *p, Queue *q) : pool(p), queue(q), inFlight(0) {}
+		Slot(const Slot&) = delete;
+		Slot& operator=(const Slot&) = delete;
+		QueuePool *pool;
+		std::unique_ptr<Queue> queue;
+		std::atomic<size_t> inFlight;
+	};
+
+	Queue& select(const Device *device);
+	void create(const Device&, size_t size, Queue::props);
+	static void CL_CALLBACK complete(cl_event, cl_int, void *slot);
+
+	Context *_context;
+	std::atomic<Policy> _policy; /**< Policy which may be changed while other threads select Queue objects. */
+	std::vector< std::unique_ptr<Slot> > _slots;
+	std::atomic<size_t> _cursor; /**< Position at which the search for the next Queue starts. */
+	std::mutex _mutex;
+	std::condition_variable _completed; /**< Notified whenever a command in flight completes. */
+};
+
+}
+
+#endif
@@ -0,0 +1,271 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OCL_REGISTRY_H
+#define OCL_REGISTRY_H
+
+#include <set>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <utility>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <iterator>
+
+
+namespace ocl{
+
+/*! \class Registry ocl_registry.h "inc/ocl_registry.h"
+  * \brief Thread-safe set of objects registered within a Context or Platform.
+  *
+  * The objects are distributed over several shards by their address.
+  * Each shard is guarded by its own mutex so that objects
+  * which are created and destructed concurrently rarely wait for each other.
+  */
+template<class T>
+class Registry
+{
+public:
+	enum { shards = 8 };
+
+	Registry() : _shards() {}
+
+	Registry( Registry const& ) = delete;
+	Registry& operator =( Registry const& ) = delete;
+
+	/*! \brief Inserts the object and returns false if it has been inserted before. */
+	bool insert(T *item)
+	{
+		Shard &s = this->shard(item);
+		std::lock_guard<std::mutex> lock(s.mutex);
+		return s.items.insert(item).second;
+	}
+
+	/*! \brief Removes the object and returns false if it has not been inserted. */
+	bool erase(T *item)
+	{
+		Shard &s = this->shard(item);
+		std::lock_guard<std::mutex> lock(s.mutex);
+		return s.items.erase(item) > 0;
+	}
+
+	/*! \brief Returns true if the object has been inserted. */
+	bool contains(const T *item) const
+	{
+		const Shard &s = this->shard(item);
+		std::lock_guard<std::mutex> lock(s.mutex);
+		return s.items.find(const_cast<T*>(item)) != s.items.end();
+	}
+
+	/*! \brief Returns a copy of all inserted objects. */
+	std::set<T*> items() const
+	{
+		std::set<T*> all;
+		for(const Shard &s : this->_shards){
+			std::lock_guard<std::mutex> lock(s.mutex);
+			all.insert(s.items.begin(), s.items.end());
+		}
+		return all;
+	}
+
+	/*! \brief Removes all objects and returns them. */
+	std::set<T*> take()
+	{
+		std::set<T*> all;
+		for(Shard &s : this->_shards){
+			std::lock_guard<std::mutex> lock(s.mutex);
+			all.insert(s.items.begin(), s.items.end());
+			s.items.clear();
+		}
+		return all;
+	}
+
+	/*! \brief Returns the number of inserted objects. */
+	size_t size() const
+	{
+		size_t n = 0;
+		for(const Shard &s : this->_shards){
+			std::lock_guard<std::mutex> lock(s.mutex);
+			n += s.items.size();
+		}
+		return n;
+	}
+
+private:
+
+	struct Shard
+	{
+		Shard() : mutex(), items() {}
+		mutable std::mutex mutex;
+		std::set<T*> items;
+	};
+
+	Shard& shard(const T *item) { return _shards[index(item)]; }
+	const Shard& shard(const T *item) const { return _shards[index(item)]; }
+
+	// objects are at least 16 byte aligned if allocated on the heap.
+	static size_t index(const T *item) { return (reinterpret_cast<std::uintptr_t>(item) >> 4) % shards; }
+
+	Shard _shards[shards];
+};
+
+
+/*! \class ActiveObject ocl_registry.h "inc/ocl_registry.h"
+  * \brief Active object which can be set for each thread separately.
+  *
+  * The object set by a thread is only seen by this thread. Threads
+  * which have never set an object see the object of the thread which
+  * has set one first, usually the main thread. Reading the active object does not lock.
+  * Each thread finds its slot with a hash lookup. Slots of destructed instances are
+  * removed from a thread the next time it sets an object of a new instance.
+  */
+template<class T>
+class ActiveObject
+{
+public:
+
+	ActiveObject() : _serial(enroll()), _shared(nullptr), _mutex(), _owner(), _slots() {}
+
+	~ActiveObject()
+	{
+		Serials &s = serials();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		s.alive.erase(this->_serial);
+	}
+
+	ActiveObject( ActiveObject const& ) = delete;
+	ActiveObject& operator =( ActiveObject const& ) = delete;
+
+	/*! \brief Returns the active object of the calling thread or null if there is none. */
+	T* get() const
+	{
+		const Slot *slot = this->local();
+		return slot ? slot->object.load(std::memory_order_acquire) : this->_shared.load(std::memory_order_acquire);
+	}
+
+	/*! \brief Sets the active object of the calling thread.
+	  *
+	  * The object is also seen by all threads without an own one
+	  * if the calling thread is the first which has set an object.
+	  */
+	void set(T *object)
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		Slot *slot = this->local();
+		if(slot == nullptr){
+			prune();
+			this->_slots.emplace_back(new Slot(object));
+			slot = this->_slots.back().get();
+			locals().emplace(this->_serial, slot);
+		}
+		slot->object.store(object, std::memory_order_release);
+		if(this->_owner == std::thread::id()) this->_owner = std::this_thread::get_id();
+		if(this->_owner == std::this_thread::get_id()) this->_shared.store(object, std::memory_order_release);
+	}
+
+	/*! \brief Unsets the object for all threads if it is active. */
+	void reset(T *object)
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		for(auto &slot : this->_slots){
+			T *expected = object;
+			slot->object.compare_exchange_strong(expected, nullptr);
+		}
+		T *expected = object;
+		this->_shared.compare_exchange_strong(expected, nullptr);
+	}
+
+	/*! \brief Unsets the active objects of all threads. */
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		for(auto &slot : this->_slots)
+			slot->object.store(nullptr);
+		this->_shared.store(nullptr);
+	}
+
+private:
+
+	struct Slot
+	{
+		explicit Slot(T *o) : object(o) {}
+		std::atomic<T*> object;
+	};
+
+	// slots of the calling thread for all ActiveObject instances identified by their serial numbers.
+	typedef std::unordered_map<unsigned long, Slot*> Locals;
+
+	// serial numbers of all living ActiveObject instances.
+	struct Serials
+	{
+		Serials() : mutex(), next(0), alive() {}
+		std::mutex mutex;
+		unsigned long next;
+		std::set<unsigned long> alive;
+	};
+
+	static Locals& locals()
+	{
+		static thread_local Locals l;
+		return l;
+	}
+
+	// never destructed so that instances with static storage duration can still be destructed.
+	static Serials& serials()
+	{
+		static Serials *s = new Serials();
+		return *s;
+	}
+
+	static unsigned long enroll()
+	{
+		Serials &s = serials();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		s.alive.insert(++s.next);
+		return s.next;
+	}
+
+	// removes the slots of destructed instances from the calling thread.
+	static void prune()
+	{
+		Serials &s = serials();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		Locals &l = locals();
+		for(auto it = l.begin(); it != l.end(); )
+			it = s.alive.count(it->first) ? std::next(it) : l.erase(it);
+	}
+
+	Slot* local() const
+	{
+		const Locals &l = locals();
+		const auto it = l.find(this->_serial);
+		return it == l.end() ? nullptr : it->second;
+	}
+
+	const unsigned long _serial;  /**< Never reused so that slots of destructed instances are not found. */
+	std::atomic<T*> _shared;      /**< Active object for threads without an own one. */
+	std::mutex _mutex;
+	std::thread::id _owner;       /**< Thread whose object is seen by threads without an own one. */
+	std::vector< std::unique_ptr<Slot> > _slots;
+};
+
+}
+
+#endif
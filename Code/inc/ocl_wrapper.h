@@ -29,18 +29,32 @@
 */
 
 #include <ocl_buffer.h>
+#include <ocl_bundle.h>
+#include <ocl_completion_queue.h>
 #include <ocl_query.h>
 #include <ocl_context.h>
+#include <ocl_coroutine.h>
+#include <ocl_dependency_tracker.h>
 #include <ocl_device.h>
+#include <ocl_device_clock.h>
+#include <ocl_device_info.h>
+#include <ocl_device_partition.h>
+#include <ocl_device_selector.h>
 #include <ocl_device_type.h>
 #include <ocl_event.h>
 #include <ocl_event_list.h>
 #include <ocl_kernel.h>
 #include <ocl_memory.h>
+#include <ocl_module.h>
+#include <ocl_multi_device_launcher.h>
 #include <ocl_platform.h>
+#include <ocl_platform_info.h>
+#include <ocl_profiler.h>
 #include <ocl_program.h>
 #include <ocl_queue.h>
+#include <ocl_queue_pool.h>
 #include <ocl_image.h>
+#include <ocl_image_pool.h>
 #include <ocl_sampler.h>
 
 #endif
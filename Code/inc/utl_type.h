@@ -121,12 +121,13 @@ public:
 
 	const Type* operator()() const;
 
+	/*! \brief Returns the Type for T. The lookup is performed only once per T. */
 	template <class T>
 	static const Type& type(){
-		for(auto __t : _allTypes) { if(*__t == typeid(T)) return *__t; }
-		assert(0);
-		throw std::runtime_error(std::string("Type with id ") + typeid(T).name() + " not found");
+		static const Type& __t = type(typeid(T));
+		return __t;
 	}
+	static const Type& type(const std::type_info&);
 private:
 	std::string _name;
 	const std::type_info* _info;
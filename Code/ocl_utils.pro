@@ -3,6 +3,7 @@ QMAKESPEC =
 TARGET = main
 CONFIG += console
 CONFIG -= app_bundle
+CONFIG(release, debug|release): DEFINES += NDEBUG OCL_CHECKED=0
 TEMPLATE = app
 
 
@@ -16,31 +17,60 @@ SOURCES += \
 	src/ocl_query.cpp \
 	src/ocl_program.cpp \
 	src/ocl_context.cpp \
+	src/ocl_dependency_tracker.cpp \
 	src/ocl_kernel.cpp \
 	src/ocl_image.cpp \
+	src/ocl_image_pool.cpp \
 	src/ocl_platform.cpp \
+	src/ocl_platform_info.cpp \
+	src/ocl_profiler.cpp \
 	src/ocl_device.cpp \
+	src/ocl_device_clock.cpp \
+	src/ocl_device_info.cpp \
+	src/ocl_device_partition.cpp \
+	src/ocl_device_selector.cpp \
 	src/ocl_device_type.cpp \        
 	src/ocl_queue.cpp \
+	src/ocl_queue_pool.cpp \
 	src/ocl_buffer.cpp \
+	src/ocl_bundle.cpp \
+	src/ocl_completion_queue.cpp \
 	src/ocl_memory.cpp \
+	src/ocl_module.cpp \
+	src/ocl_multi_device_launcher.cpp \
 	src/ocl_event.cpp \
 	src/ocl_event_list.cpp
 	
 HEADERS += \
 	inc/ocl_wrapper.h \
 	inc/ocl_query.h \
+	inc/ocl_config.h \
 	inc/ocl_program.h \
 	inc/ocl_context.h \
+	inc/ocl_coroutine.h \
+	inc/ocl_dependency_tracker.h \
 	inc/ocl_kernel.h \
 	inc/ocl_image.h \
+	inc/ocl_image_pool.h \
 	inc/ocl_platform.h \
+	inc/ocl_platform_info.h \
+	inc/ocl_profiler.h \
 	inc/ocl_device.h \
+	inc/ocl_device_clock.h \
+	inc/ocl_device_info.h \
+	inc/ocl_device_partition.h \
+	inc/ocl_device_selector.h \
 	inc/ocl_device_type.h \        
 	inc/ocl_queue.h \
+	inc/ocl_queue_pool.h \
+	inc/ocl_registry.h \
 	inc/ocl_event.h \
 	inc/ocl_buffer.h \
+	inc/ocl_bundle.h \
+	inc/ocl_completion_queue.h \
 	inc/ocl_memory.h \
+	inc/ocl_module.h \
+	inc/ocl_multi_device_launcher.h \
 	inc/ocl_event_list.h
 
 
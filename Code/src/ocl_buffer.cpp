@@ -193,10 +193,13 @@ void ocl::Buffer::recreate(size_t size_bytes)
   */
 void ocl::Buffer::copyTo ( size_t thisOffset, size_t size_bytes, const Buffer & dest, size_t destOffset, const ocl::EventList &list) const
 {
-	if(this->context() != dest.context()) throw std::runtime_error("context of this and dest must be equal");
-	if(this->id() == dest.id()) throw std::runtime_error("This and Other Buffer ids must not be equal");
-	OPENCL_SAFE_CALL( clEnqueueCopyBuffer (this->activeQueue().id(), this->id(), dest.id(), thisOffset, destOffset, size_bytes, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	OCL_ASSERT(this->context() == dest.context(), "context of this and dest must be equal");
+	OCL_ASSERT(this->id() != dest.id(), "This and Other Buffer ids must not be equal");
+	const ocl::Queue &queue = this->activeQueue();
+	this->execute(list, Memory::ReadOnly, &dest, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueCopyBuffer (queue.id(), this->id(), dest.id(), thisOffset, destOffset, size_bytes, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /*! \brief Copies asynchronously from this Buffer to the destination Buffer.
@@ -210,11 +213,17 @@ void ocl::Buffer::copyTo ( size_t thisOffset, size_t size_bytes, const Buffer &
   */
 ocl::Event ocl::Buffer::copyToAsync( size_t thisOffset, size_t size_bytes, const Buffer & dest, size_t destOffset, const ocl::EventList &list)
 {
-	if(this->context() != dest.context()) throw std::runtime_error("context of this and dest must be equal");
+	OCL_ASSERT(this->context() == dest.context(), "context of this and dest must be equal");
 	cl_event event_id;
-	OPENCL_SAFE_CALL ( clEnqueueCopyBuffer (this->activeQueue().id(), this->id(), dest.id(), thisOffset, destOffset, size_bytes,
-											list.size(), list.events().data(), &event_id) );
-	return ocl::Event(event_id, this->context());
+	const ocl::Queue &queue = this->activeQueue();
+	ocl::Event event = this->enqueue(list, Memory::ReadOnly, &dest, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL ( clEnqueueCopyBuffer (queue.id(), this->id(), dest.id(), thisOffset, destOffset, size_bytes,
+												events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, size_bytes);
+	this->context()->track(queue, event);
+	return event;
 }
 
 
@@ -231,12 +240,14 @@ ocl::Event ocl::Buffer::copyToAsync( size_t thisOffset, size_t size_bytes, const
   */
 void ocl::Buffer::copyTo (const ocl::Queue& queue, size_t thisOffset, size_t size_bytes, const Buffer & dest, size_t destOffset, const ocl::EventList &list) const
 {
-	if(this->context() != dest.context()) throw std::runtime_error("context of this and dest must be equal");
-	if(*this->context() != queue.context()) throw std::runtime_error("context of this and dest must be equal");
-	if(this->id() == dest.id()) throw std::runtime_error("This and Other Buffer ids must not be equal");
+	OCL_ASSERT(this->context() == dest.context(), "context of this and dest must be equal");
+	OCL_ASSERT(*this->context() == queue.context(), "context of this and dest must be equal");
+	OCL_ASSERT(this->id() != dest.id(), "This and Other Buffer ids must not be equal");
 
-	OPENCL_SAFE_CALL( clEnqueueCopyBuffer (queue.id(), this->id(), dest.id(), thisOffset, destOffset, size_bytes, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	this->execute(list, Memory::ReadOnly, &dest, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueCopyBuffer (queue.id(), this->id(), dest.id(), thisOffset, destOffset, size_bytes, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /*! \brief Copies asynchronously from this Buffer to the destination Buffer.
@@ -251,13 +262,17 @@ void ocl::Buffer::copyTo (const ocl::Queue& queue, size_t thisOffset, size_t siz
   */
 ocl::Event ocl::Buffer::copyToAsync(const ocl::Queue& queue, size_t thisOffset, size_t size_bytes, const Buffer & dest, size_t destOffset, const ocl::EventList &list)
 {
-	if(this->context() !=dest.context()) throw std::runtime_error("context of this and dest must be equal");
-	if(*this->context() != queue.context()) throw std::runtime_error("context of this and dest must be equal");
+	OCL_ASSERT(this->context() == dest.context(), "context of this and dest must be equal");
+	OCL_ASSERT(*this->context() == queue.context(), "context of this and dest must be equal");
 
 	cl_event event_id;
-	OPENCL_SAFE_CALL ( clEnqueueCopyBuffer (queue.id(), this->id(), dest.id(), thisOffset, destOffset, size_bytes,
-											list.size(), list.events().data(), &event_id) );
-	return ocl::Event(event_id, this->context());
+	ocl::Event event = this->enqueue(list, Memory::ReadOnly, &dest, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL ( clEnqueueCopyBuffer (queue.id(), this->id(), dest.id(), thisOffset, destOffset, size_bytes,
+												events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, size_bytes);
+	return event;
 }
 
 
@@ -272,13 +287,17 @@ ocl::Event ocl::Buffer::copyToAsync(const ocl::Queue& queue, size_t thisOffset,
   */
 void * ocl::Buffer::map ( size_t offset, size_t size_bytes, Memory::Access access ) const
 {
-	if(!this->activeQueue().device().isCpu()) throw std::runtime_error("Device " + this->activeQueue().device().name() + " is not a cpu!");
+	const ocl::Queue &queue = this->activeQueue();
+	if(!queue.device().isCpu()) throw std::runtime_error("Device " + queue.device().name() + " is not a cpu!");
 	cl_int status;
 	cl_map_flags flags = access;
-	void *pointer = clEnqueueMapBuffer(this->activeQueue().id(), this->id(), CL_TRUE, flags, offset, size_bytes,  0, NULL, NULL, &status);
-	OPENCL_SAFE_CALL (status ) ;
-	if(pointer == nullptr) throw std::runtime_error("could not map buffer");
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	void *pointer = nullptr;
+	this->execute(ocl::EventList(), access, nullptr, [&](const ocl::EventList &events){
+		pointer = clEnqueueMapBuffer(queue.id(), this->id(), CL_TRUE, flags, offset, size_bytes,  events.size(), events.data(), NULL, &status);
+		OPENCL_SAFE_CALL (status ) ;
+		if(pointer == nullptr) throw std::runtime_error("could not map buffer");
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 	return pointer;
 }
 
@@ -293,13 +312,17 @@ void * ocl::Buffer::map ( size_t offset, size_t size_bytes, Memory::Access acces
   */
 void * ocl::Buffer::map ( Memory::Access access ) const
 {
-	if(!this->activeQueue().device().isCpu()) throw std::runtime_error("Device " + this->activeQueue().device().name() + " is not a cpu!");
+	const ocl::Queue &queue = this->activeQueue();
+	if(!queue.device().isCpu()) throw std::runtime_error("Device " + queue.device().name() + " is not a cpu!");
 	cl_int status;
 	cl_map_flags flags = access;
-	void *pointer = clEnqueueMapBuffer(this->activeQueue().id(), this->id(), CL_TRUE, flags, 0, this->size_bytes(),  0, NULL, NULL, &status);
-	OPENCL_SAFE_CALL (status ) ;
-	if(pointer == nullptr) throw std::runtime_error("could not map buffer");
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	void *pointer = nullptr;
+	this->execute(ocl::EventList(), access, nullptr, [&](const ocl::EventList &events){
+		pointer = clEnqueueMapBuffer(queue.id(), this->id(), CL_TRUE, flags, 0, this->size_bytes(),  events.size(), events.data(), NULL, &status);
+		OPENCL_SAFE_CALL (status ) ;
+		if(pointer == nullptr) throw std::runtime_error("could not map buffer");
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 	return pointer;
 }
 
@@ -320,11 +343,17 @@ ocl::Event ocl::Buffer::mapAsync ( void ** host_mem, size_t offset, size_t size_
 	cl_event event_id;
 	cl_int status;
 	cl_map_flags flags = access;
-	*host_mem = clEnqueueMapBuffer(this->activeQueue().id(), this->id(), CL_FALSE, flags, offset, size_bytes,
-								   list.size(), list.events().data(), &event_id, &status);
-	OPENCL_SAFE_CALL (status ) ;
-	if(*host_mem == nullptr) throw std::runtime_error("could not map buffer");
-	return ocl::Event(event_id, this->context());
+	const ocl::Queue &queue = this->activeQueue();
+	ocl::Event event = this->enqueue(list, access, nullptr, [&](const ocl::EventList &events) -> ocl::Event {
+		*host_mem = clEnqueueMapBuffer(queue.id(), this->id(), CL_FALSE, flags, offset, size_bytes,
+									   events.size(), events.data(), &event_id, &status);
+		OPENCL_SAFE_CALL (status ) ;
+		if(*host_mem == nullptr) throw std::runtime_error("could not map buffer");
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, size_bytes);
+	this->context()->track(queue, event);
+	return event;
 }
 
 /*! \brief Transfers data from this Buffer to the host memory.
@@ -336,9 +365,12 @@ ocl::Event ocl::Buffer::mapAsync ( void ** host_mem, size_t offset, size_t size_
 */
 void ocl::Buffer::read ( size_t offset, void * host_mem, size_t size_bytes, const EventList & list ) const
 {
-	if(host_mem == nullptr) throw std::runtime_error("host_mem should not be nullptr");
-	OPENCL_SAFE_CALL ( clEnqueueReadBuffer(this->activeQueue().id(), this->id(), CL_TRUE, offset, size_bytes, host_mem, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	OCL_ASSERT(host_mem != nullptr, "host_mem should not be nullptr");
+	const ocl::Queue &queue = this->activeQueue();
+	this->execute(list, Memory::ReadOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL ( clEnqueueReadBuffer(queue.id(), this->id(), CL_TRUE, offset, size_bytes, host_mem, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /*! \brief Transfers data from this Buffer to the host memory.
@@ -349,9 +381,12 @@ void ocl::Buffer::read ( size_t offset, void * host_mem, size_t size_bytes, cons
 */
 void ocl::Buffer::read ( void * host_mem, size_t size_bytes, const EventList & list) const
 {
-	if(host_mem == nullptr) throw std::runtime_error("host_mem should not be nullptr");
-	OPENCL_SAFE_CALL ( clEnqueueReadBuffer(this->activeQueue().id(), this->id(), CL_TRUE, 0, size_bytes, host_mem, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	OCL_ASSERT(host_mem != nullptr, "host_mem should not be nullptr");
+	const ocl::Queue &queue = this->activeQueue();
+	this->execute(list, Memory::ReadOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL ( clEnqueueReadBuffer(queue.id(), this->id(), CL_TRUE, 0, size_bytes, host_mem, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /*! \brief Transfers data from this Buffer to the host memory.
@@ -365,10 +400,12 @@ void ocl::Buffer::read ( void * host_mem, size_t size_bytes, const EventList & l
 */
 void ocl::Buffer::read (const ocl::Queue& queue, size_t offset, void * host_mem, size_t size_bytes, const EventList & list ) const
 {
-	if(host_mem == nullptr) throw std::runtime_error("host_mem should not be nullptr");
-	if(*this->context() != queue.context()) throw std::runtime_error("context of queue and this must be equal");
-	OPENCL_SAFE_CALL ( clEnqueueReadBuffer(queue.id(), this->id(), CL_TRUE, offset, size_bytes, host_mem, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	OCL_ASSERT(host_mem != nullptr, "host_mem should not be nullptr");
+	OCL_ASSERT(*this->context() == queue.context(), "context of queue and this must be equal");
+	this->execute(list, Memory::ReadOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL ( clEnqueueReadBuffer(queue.id(), this->id(), CL_TRUE, offset, size_bytes, host_mem, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /*! \brief Transfers data from this Buffer to the host memory.
@@ -381,10 +418,12 @@ void ocl::Buffer::read (const ocl::Queue& queue, size_t offset, void * host_mem,
 */
 void ocl::Buffer::read (const ocl::Queue& queue, void * host_mem, size_t size_bytes, const EventList & list) const
 {
-	if(host_mem == nullptr) throw std::runtime_error("host_mem should not be nullptr");
-	if(*this->context() != queue.context()) throw std::runtime_error("context of queue and this must be equal");
-	OPENCL_SAFE_CALL ( clEnqueueReadBuffer(queue.id(), this->id(), CL_TRUE, 0, size_bytes, host_mem, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	OCL_ASSERT(host_mem != nullptr, "host_mem should not be nullptr");
+	OCL_ASSERT(*this->context() == queue.context(), "context of queue and this must be equal");
+	this->execute(list, Memory::ReadOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL ( clEnqueueReadBuffer(queue.id(), this->id(), CL_TRUE, 0, size_bytes, host_mem, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 
@@ -401,9 +440,15 @@ ocl::Event
 ocl::Buffer::readAsync (size_t offset, void *host_mem, size_t size_bytes, const ocl::EventList & list) const
 {
 	cl_event event_id;
-	if(host_mem == nullptr) throw std::runtime_error("host_mem should not be nullptr");
-	OPENCL_SAFE_CALL ( clEnqueueReadBuffer(this->activeQueue().id(), this->id(), CL_FALSE, offset, size_bytes, host_mem, list.size(), list.events().data(), &event_id) );
-	return Event(event_id, this->context());
+	OCL_ASSERT(host_mem != nullptr, "host_mem should not be nullptr");
+	const ocl::Queue &queue = this->activeQueue();
+	ocl::Event event = this->enqueue(list, Memory::ReadOnly, nullptr, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL ( clEnqueueReadBuffer(queue.id(), this->id(), CL_FALSE, offset, size_bytes, host_mem, events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, size_bytes);
+	this->context()->track(queue, event);
+	return event;
 }
 
 /*! \brief Transfers data from this Buffer to the host memory.
@@ -421,10 +466,14 @@ ocl::Event
 ocl::Buffer::readAsync (const ocl::Queue& queue, size_t offset, void *host_mem, size_t size_bytes, const ocl::EventList & list) const
 {
 	cl_event event_id;
-	if(host_mem == nullptr) throw std::runtime_error("host_mem should not be nullptr");
-	if(*this->context() != queue.context()) throw std::runtime_error("context of queue and this must be equal");
-	OPENCL_SAFE_CALL ( clEnqueueReadBuffer(queue.id(), this->id(), CL_FALSE, offset, size_bytes, host_mem, list.size(), list.events().data(), &event_id) );
-	return Event(event_id, this->context());
+	OCL_ASSERT(host_mem != nullptr, "host_mem should not be nullptr");
+	OCL_ASSERT(*this->context() == queue.context(), "context of queue and this must be equal");
+	ocl::Event event = this->enqueue(list, Memory::ReadOnly, nullptr, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL ( clEnqueueReadBuffer(queue.id(), this->id(), CL_FALSE, offset, size_bytes, host_mem, events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, size_bytes);
+	return event;
 }
 
 /*! \brief Transfers data from host memory to this Buffer.
@@ -435,9 +484,12 @@ ocl::Buffer::readAsync (const ocl::Queue& queue, size_t offset, void *host_mem,
 */
 void ocl::Buffer::write (const void * host_mem, size_t size_bytes, const EventList & list ) const
 {
-	if(host_mem == nullptr) throw std::runtime_error("host_mem should not be nullptr");
-	OPENCL_SAFE_CALL (  clEnqueueWriteBuffer(this->activeQueue().id(), this->id(), CL_TRUE, 0, size_bytes, host_mem, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	OCL_ASSERT(host_mem != nullptr, "host_mem should not be nullptr");
+	const ocl::Queue &queue = this->activeQueue();
+	this->execute(list, Memory::WriteOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL (  clEnqueueWriteBuffer(queue.id(), this->id(), CL_TRUE, 0, size_bytes, host_mem, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /*! \brief Transfers data from host_memory to this Buffer.
@@ -449,9 +501,12 @@ void ocl::Buffer::write (const void * host_mem, size_t size_bytes, const EventLi
 */
 void ocl::Buffer::write (size_t offset, const void * host_mem, size_t size_bytes, const EventList & list ) const
 {
-	if(host_mem == nullptr) throw std::runtime_error("host_mem should not be nullptr");
-	OPENCL_SAFE_CALL (  clEnqueueWriteBuffer(this->activeQueue().id(), this->id(), CL_TRUE, offset, size_bytes, host_mem, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	OCL_ASSERT(host_mem != nullptr, "host_mem should not be nullptr");
+	const ocl::Queue &queue = this->activeQueue();
+	this->execute(list, Memory::WriteOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL (  clEnqueueWriteBuffer(queue.id(), this->id(), CL_TRUE, offset, size_bytes, host_mem, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /*! \brief Transfers data from host memory to this Buffer.
@@ -464,10 +519,12 @@ void ocl::Buffer::write (size_t offset, const void * host_mem, size_t size_bytes
 */
 void ocl::Buffer::write (const ocl::Queue& queue, const void * host_mem, size_t size_bytes, const EventList & list ) const
 {
-	if(host_mem == nullptr) throw std::runtime_error("host_mem should not be nullptr");
-	if(*this->context() != queue.context()) throw std::runtime_error("context of queue and this must be equal");
-	OPENCL_SAFE_CALL (  clEnqueueWriteBuffer(queue.id(), this->id(), CL_TRUE, 0, size_bytes, host_mem, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	OCL_ASSERT(host_mem != nullptr, "host_mem should not be nullptr");
+	OCL_ASSERT(*this->context() == queue.context(), "context of queue and this must be equal");
+	this->execute(list, Memory::WriteOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL (  clEnqueueWriteBuffer(queue.id(), this->id(), CL_TRUE, 0, size_bytes, host_mem, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /*! \brief Transfers data from host_memory to this Buffer.
@@ -481,10 +538,12 @@ void ocl::Buffer::write (const ocl::Queue& queue, const void * host_mem, size_t
 */
 void ocl::Buffer::write (const ocl::Queue& queue, size_t offset, const void * host_mem, size_t size_bytes, const EventList & list ) const
 {
-	if(host_mem == nullptr) throw std::runtime_error("host_mem should not be nullptr");
-	if(*this->context() != queue.context()) throw std::runtime_error("context of queue and this must be equal");
-	OPENCL_SAFE_CALL (  clEnqueueWriteBuffer(queue.id(), this->id(), CL_TRUE, offset, size_bytes, host_mem, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	OCL_ASSERT(host_mem != nullptr, "host_mem should not be nullptr");
+	OCL_ASSERT(*this->context() == queue.context(), "context of queue and this must be equal");
+	this->execute(list, Memory::WriteOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL (  clEnqueueWriteBuffer(queue.id(), this->id(), CL_TRUE, offset, size_bytes, host_mem, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 
@@ -500,10 +559,16 @@ void ocl::Buffer::write (const ocl::Queue& queue, size_t offset, const void * ho
 ocl::Event ocl::Buffer::writeAsync (size_t offset, const void * host_mem, size_t size_bytes, const ocl::EventList & list) const
 {
 	cl_event event_id;
-	if(host_mem == nullptr) throw std::runtime_error("host_mem should not be nullptr");
-	OPENCL_SAFE_CALL ( clEnqueueWriteBuffer(this->activeQueue().id(), this->id(), CL_FALSE, offset, size_bytes, host_mem,
-											list.size(), list.events().data(), &event_id) );
-	return Event(event_id, this->context());
+	OCL_ASSERT(host_mem != nullptr, "host_mem should not be nullptr");
+	const ocl::Queue &queue = this->activeQueue();
+	ocl::Event event = this->enqueue(list, Memory::WriteOnly, nullptr, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL ( clEnqueueWriteBuffer(queue.id(), this->id(), CL_FALSE, offset, size_bytes, host_mem,
+												events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, size_bytes);
+	this->context()->track(queue, event);
+	return event;
 }
 
 /*! \brief Transfers data from host memory to this Buffer.
@@ -520,11 +585,15 @@ ocl::Event ocl::Buffer::writeAsync (size_t offset, const void * host_mem, size_t
 ocl::Event ocl::Buffer::writeAsync (const ocl::Queue& queue, size_t offset, const void * host_mem, size_t size_bytes, const ocl::EventList & list) const
 {
 	cl_event event_id;
-	if(host_mem == nullptr) throw std::runtime_error("host_mem should not be nullptr");
-	if(*this->context() != queue.context()) throw std::runtime_error("context of queue and this must be equal");
-	OPENCL_SAFE_CALL ( clEnqueueWriteBuffer(queue.id(), this->id(), CL_FALSE, offset, size_bytes, host_mem,
-											list.size(), list.events().data(), &event_id) );
-	return Event(event_id, this->context());
+	OCL_ASSERT(host_mem != nullptr, "host_mem should not be nullptr");
+	OCL_ASSERT(*this->context() == queue.context(), "context of queue and this must be equal");
+	ocl::Event event = this->enqueue(list, Memory::WriteOnly, nullptr, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL ( clEnqueueWriteBuffer(queue.id(), this->id(), CL_FALSE, offset, size_bytes, host_mem,
+												events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, size_bytes);
+	return event;
 }
 
 /*! \brief Copies data from other Buffer to this Buffer.
@@ -577,6 +646,6 @@ cl_int ocl::Buffer::acquireAccess(Queue &q)
 #ifdef __OPENGL__
 cl_int ocl::Buffer::releaseAccess(Queue &q, const EventList& list) {
 	cl_event event_id;
-	return clEnqueueReleaseGLObjects(q.id(), 1, &this->_id, list.size(), list.events().data(), &event_id);
+	return clEnqueueReleaseGLObjects(q.id(), 1, &this->_id, list.size(), list.data(), &event_id);
 }
 #endif
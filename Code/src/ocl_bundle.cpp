@@ -0,0 +1,223 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cstring>
+#include <iterator>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+#include <ocl_bundle.h>
+#include <ocl_device.h>
+
+namespace {
+
+const char magic[4] = { 'O', 'C', 'L', 'B' };
+
+void put(std::vector<unsigned char> &out, uint64_t value, size_t bytes)
+{
+	for(size_t i = 0; i < bytes; ++i)
+		out.push_back(static_cast<unsigned char>(value >> (8*i)));
+}
+
+void put(std::vector<unsigned char> &out, const std::string &value)
+{
+	put(out, value.size(), 4);
+	out.insert(out.end(), value.begin(), value.end());
+}
+
+/*! \brief Reads little-endian values and strings from a serialized Bundle. */
+class Reader
+{
+public:
+	Reader(const unsigned char *data, size_t size) : _data(data), _size(size), _pos(0) {}
+	Reader(const Reader&) = delete;
+	Reader& operator=(const Reader&) = delete;
+
+	uint64_t get(size_t bytes)
+	{
+		require(bytes);
+		uint64_t value = 0;
+		for(size_t i = 0; i < bytes; ++i)
+			value |= uint64_t(_data[_pos++]) << (8*i);
+		return value;
+	}
+
+	std::string string()
+	{
+		const size_t length = size_t(get(4));
+		require(length);
+		std::string value(reinterpret_cast<const char*>(_data + _pos), length);
+		_pos += length;
+		return value;
+	}
+
+	std::vector<unsigned char> bytes()
+	{
+		const size_t length = size_t(get(4));
+		require(length);
+		std::vector<unsigned char> value(_data + _pos, _data + _pos + length);
+		_pos += length;
+		return value;
+	}
+
+private:
+	void require(size_t bytes) const
+	{
+		if(_size - _pos < bytes) throw std::runtime_error( "Bundle is truncated.");
+	}
+
+	const unsigned char *_data;
+	size_t _size;
+	size_t _pos;
+};
+
+}
+
+/*! \brief Instantiates an empty Bundle. */
+ocl::Bundle::Bundle() :
+	_binaries()
+{
+}
+
+/*! \brief Instantiates this Bundle from serialized data, e.g. from an embedded array.
+  *
+  * Throws if the data is not a Bundle or has been written in another format version.
+*/
+ocl::Bundle::Bundle(const unsigned char *data, size_t size) :
+	_binaries()
+{
+	if(size < sizeof magic || std::memcmp(data, magic, sizeof magic) != 0)
+		throw std::runtime_error( "Data is not a Bundle.");
+
+	Reader reader(data + sizeof magic, size - sizeof magic);
+	if(reader.get(4) != format) throw std::runtime_error( "Bundle has been written in an unsupported format version.");
+
+	const size_t count = size_t(reader.get(4));
+	for(size_t i = 0; i < count; ++i){
+		Binary b;
+		b.device = reader.string();
+		b.version = reader.string();
+		b.driver = reader.string();
+		b.options = reader.string();
+		b.source = reader.get(8);
+		b.data = reader.bytes();
+		_binaries.push_back(std::move(b));
+	}
+}
+
+/*! \brief Instantiates this Bundle from a stream written with write(). */
+ocl::Bundle::Bundle(std::istream &stream) :
+	_binaries()
+{
+	if(stream.fail()) throw std::runtime_error( "Error while opening bundle.");
+	std::vector<unsigned char> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	*this = Bundle(data.data(), data.size());
+}
+
+/*! \brief Adds the Binary to this Bundle.
+  *
+  * A Binary for the same Device, versions, options and source is replaced.
+*/
+void ocl::Bundle::add(const Binary &binary)
+{
+	for(auto &b : _binaries){
+		if(b.device == binary.device && b.version == binary.version && b.driver == binary.driver &&
+		   b.options == binary.options && b.source == binary.source){
+			b = binary;
+			return;
+		}
+	}
+	_binaries.push_back(binary);
+}
+
+/*! \brief Adds all Binary objects of the specified Bundle to this Bundle. */
+void ocl::Bundle::add(const Bundle &bundle)
+{
+	for(const auto &b : bundle._binaries)
+		this->add(b);
+}
+
+/*! \brief Returns the Binary matching the Device, build options and source hash or null if there is none. */
+const ocl::Bundle::Binary* ocl::Bundle::find(const Device &device, const std::string &options, uint64_t source) const
+{
+	const std::string name = device.name();
+	for(const auto &b : _binaries){
+		if(b.source == source && b.options == options && b.device == name &&
+		   b.version == device.version() && b.driver == device.driverVersion())
+			return &b;
+	}
+	return nullptr;
+}
+
+/*! \brief Returns all Binary objects of this Bundle. */
+const std::vector<ocl::Bundle::Binary>& ocl::Bundle::binaries() const
+{
+	return _binaries;
+}
+
+/*! \brief Returns true if this Bundle has no Binary. */
+bool ocl::Bundle::empty() const
+{
+	return _binaries.empty();
+}
+
+/*! \brief Returns the number of Binary objects of this Bundle. */
+size_t ocl::Bundle::size() const
+{
+	return _binaries.size();
+}
+
+/*! \brief Returns this Bundle in its serialized little-endian format. */
+std::vector<unsigned char> ocl::Bundle::serialize() const
+{
+	std::vector<unsigned char> out(magic, magic + sizeof magic);
+	put(out, format, 4);
+	put(out, _binaries.size(), 4);
+	for(const auto &b : _binaries){
+		put(out, b.device);
+		put(out, b.version);
+		put(out, b.driver);
+		put(out, b.options);
+		put(out, b.source, 8);
+		put(out, b.data.size(), 4);
+		out.insert(out.end(), b.data.begin(), b.data.end());
+	}
+	return out;
+}
+
+/*! \brief Writes this Bundle in its serialized format to the stream. */
+void ocl::Bundle::write(std::ostream &stream) const
+{
+	const std::vector<unsigned char> data = this->serialize();
+	stream.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+}
+
+/*! \brief Returns the 64-bit FNV-1a hash of the source.
+  *
+  * The hash does not depend on the compiler or platform so that
+  * Bundle objects can be created and used on different machines.
+*/
+uint64_t ocl::Bundle::hash(const std::string &source)
+{
+	uint64_t h = 14695981039346656037ull;
+	for(const char c : source){
+		h ^= static_cast<unsigned char>(c);
+		h *= 1099511628211ull;
+	}
+	return h;
+}
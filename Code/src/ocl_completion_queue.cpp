@@ -0,0 +1,139 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cstdlib>
+
+#include <ocl_completion_queue.h>
+
+
+/*! \brief Returns the CompletionQueue of the process.
+  *
+  * The CompletionQueue is never destructed so that driver threads
+  * can post callbacks at any time. It is shut down at program exit.
+  */
+ocl::CompletionQueue& ocl::CompletionQueue::instance()
+{
+	static CompletionQueue *queue = new CompletionQueue;
+	return *queue;
+}
+
+/*! \brief Instantiates this CompletionQueue, starts its thread and shuts it down at program exit. */
+ocl::CompletionQueue::CompletionQueue() :
+	_mutex(), _condition(), _tasks(), _stop(false), _errorHandler(), _thread()
+{
+	_thread = std::thread(&CompletionQueue::run, this);
+	std::atexit([]{ CompletionQueue::instance().shutdown(); });
+}
+
+/*! \brief Shuts this CompletionQueue down. */
+ocl::CompletionQueue::~CompletionQueue()
+{
+	this->shutdown();
+}
+
+/*! \brief Executes the remaining tasks, joins the thread and rejects all tasks posted afterwards.
+  *
+  * Called at program exit. Must not be called by a task.
+  */
+void ocl::CompletionQueue::shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_condition.notify_one();
+	if(_thread.joinable() && !this->isCompletionThread()) _thread.join();
+}
+
+/*! \brief Returns true if this CompletionQueue has been shut down. */
+bool ocl::CompletionQueue::isShutdown() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _stop;
+}
+
+/*! \brief Appends the task which is executed on the thread of this CompletionQueue.
+  *
+  * Can be called from any thread including driver callback threads.
+  * Returns false and discards the task if this CompletionQueue has been shut down.
+  */
+bool ocl::CompletionQueue::post(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if(_stop) return false;
+		_tasks.push_back(std::move(task));
+	}
+	_condition.notify_one();
+	return true;
+}
+
+/*! \brief Returns the number of tasks which have not been started yet. */
+size_t ocl::CompletionQueue::pending() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _tasks.size();
+}
+
+/*! \brief Returns true if called from the thread of this CompletionQueue. */
+bool ocl::CompletionQueue::isCompletionThread() const
+{
+	return std::this_thread::get_id() == _thread.get_id();
+}
+
+/*! \brief Sets the function which is called on the thread of this CompletionQueue with exceptions thrown by tasks.
+  *
+  * Exceptions are discarded if no ErrorHandler is set, which is the default.
+  */
+void ocl::CompletionQueue::setErrorHandler(ErrorHandler handler)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_errorHandler = std::move(handler);
+}
+
+/*! \brief Executes the posted tasks in order until this CompletionQueue is shut down.
+  *
+  * Exceptions thrown by a task are passed to the ErrorHandler and do not stop the thread.
+  */
+void ocl::CompletionQueue::run()
+{
+	for(;;){
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condition.wait(lock, [this]{ return _stop || !_tasks.empty(); });
+			if(_tasks.empty()) return;
+			task = std::move(_tasks.front());
+			_tasks.pop_front();
+		}
+		try{
+			task();
+		}
+		catch(...){
+			ErrorHandler handler;
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				handler = _errorHandler;
+			}
+			try{
+				if(handler) handler(std::current_exception());
+			}
+			catch(...){
+			}
+		}
+	}
+}
@@ -29,6 +29,9 @@
 #include <ocl_program.h>
 #include <ocl_kernel.h>
 #include <ocl_queue.h>
+#include <ocl_queue_pool.h>
+#include <ocl_dependency_tracker.h>
+#include <ocl_profiler.h>
 #include <ocl_platform.h>
 #include <ocl_device.h>
 #include <ocl_device_type.h>
@@ -47,7 +50,7 @@
 	* \param shared if true, creates a shared Context for OpenGL interoperability.
   */
 ocl::Context::Context(cl_context id, bool shared) :
-    _id(id), _programs(), _queues(), _events(), _memories(), _samplers(), _devices(), _activeQueue(NULL), _activeProgram(NULL)
+    _id(id), _programs(), _queues(), _events(), _memories(), _samplers(), _devices(), _activeQueue(), _activeQueuePool(), _activePoolQueue(), _activeProgram(), _dependencyTracker(NULL), _profiler(NULL), _imageFormatsMutex(), _imageFormats()
 {
 	if(_id == 0) throw std::runtime_error("Context not valid");
 
@@ -73,7 +76,7 @@ ocl::Context::Context(cl_context id, bool shared) :
 	* \param shared if true, creates a shared Context for OpenGL interoperability.
   */
 ocl::Context::Context(const ocl::Device&  device, bool shared) :
-    _id(NULL), _programs(), _queues(), _events(), _memories(), _samplers(), _devices(), _activeQueue(NULL), _activeProgram(NULL)
+    _id(NULL), _programs(), _queues(), _events(), _memories(), _samplers(), _devices(), _activeQueue(), _activeQueuePool(), _activePoolQueue(), _activeProgram(), _dependencyTracker(NULL), _profiler(NULL), _imageFormatsMutex(), _imageFormats()
 {
 		_devices.push_back(device);
 	this->create(shared);
@@ -90,7 +93,7 @@ ocl::Context::Context(const ocl::Device&  device, bool shared) :
 	* \param shared if true, creates a shared Context for OpenGL interoperability.
   */
 ocl::Context::Context(const ocl::Device&  device1, const ocl::Device& device2, bool shared) :
-    _id(NULL), _programs(), _queues(), _events(), _memories(), _samplers(), _devices(), _activeQueue(NULL), _activeProgram(NULL)
+    _id(NULL), _programs(), _queues(), _events(), _memories(), _samplers(), _devices(), _activeQueue(), _activeQueuePool(), _activePoolQueue(), _activeProgram(), _dependencyTracker(NULL), _profiler(NULL), _imageFormatsMutex(), _imageFormats()
 {
 		_devices.push_back(device1);
 		_devices.push_back(device2);
@@ -103,7 +106,7 @@ ocl::Context::Context(const ocl::Device&  device1, const ocl::Device& device2, b
   * Also provide an active Queue.
   */
 ocl::Context::Context() :
-    _id(NULL), _programs(), _queues(), _events(), _memories(), _samplers(), _devices(), _activeQueue(NULL), _activeProgram(NULL)
+    _id(NULL), _programs(), _queues(), _events(), _memories(), _samplers(), _devices(), _activeQueue(), _activeQueuePool(), _activePoolQueue(), _activeProgram(), _dependencyTracker(NULL), _profiler(NULL), _imageFormatsMutex(), _imageFormats()
 {}
 
 
@@ -116,7 +119,7 @@ ocl::Context::Context() :
 	* \param shared if true, creates a shared Context for OpenGL interoperability.
   */
 ocl::Context::Context(const std::vector<Device> & devices, bool shared) :
-		_id(NULL), _programs(), _queues(), _events(), _memories(), _samplers(), _devices(devices), _activeQueue(NULL), _activeProgram(NULL)
+		_id(NULL), _programs(), _queues(), _events(), _memories(), _samplers(), _devices(devices), _activeQueue(), _activeQueuePool(), _activePoolQueue(), _activeProgram(), _dependencyTracker(NULL), _profiler(NULL), _imageFormatsMutex(), _imageFormats()
 {
 	if(devices.empty()) throw std::runtime_error("No Devices specified. Cannot create context without devices.");
 	this->create(shared);
@@ -132,7 +135,7 @@ ocl::Context::Context(const std::vector<Device> & devices, bool shared) :
 	* \param shared if true, creates a shared Context for OpenGL interoperability.
   */
 ocl::Context::Context(const ocl::Platform &p, bool shared) :
-    _id(NULL), _programs(), _queues(), _events(), _memories(), _samplers(), _devices(), _activeQueue(NULL), _activeProgram(NULL)
+    _id(NULL), _programs(), _queues(), _events(), _memories(), _samplers(), _devices(), _activeQueue(), _activeQueuePool(), _activePoolQueue(), _activeProgram(), _dependencyTracker(NULL), _profiler(NULL), _imageFormatsMutex(), _imageFormats()
 {
     this->_devices = p.devices();
 	this->create(shared);
@@ -256,31 +259,17 @@ void ocl::Context::release()
 {
     if(this->_id == 0) return;
 
-    for(auto it = _programs.begin(); it != _programs.end();){
-        ocl::Program *p = *it; ++it;
-        this->release(p);
-    }
-    for(auto it = _queues.begin(); it != _queues.end();){
-        ocl::Queue *q = *it; ++it;
-        this->release(q);
-    }
-    for(auto it = _events.begin(); it != _events.end();){
-        ocl::Event *e = *it; ++it;
-        this->release(e);
-    }
-    for(auto it = _memories.begin(); it != _memories.end();){
-        ocl::Memory *m = *it; ++it;
-        this->release(m);
-    }
-    for(auto it = _samplers.begin(); it != _samplers.end();){
-        ocl::Sampler *m = *it; ++it;
-        this->release(m);
-    }
-    
+    for(auto p : _programs.take()) p->release();
+    for(auto q : _queues.take()) q->release();
+    for(auto e : _events.take()) e->release();
+    for(auto m : _memories.take()) m->release();
+    for(auto s : _samplers.take()) s->release();
+
     OPENCL_SAFE_CALL( clReleaseContext( _id ) );
 
-    this->_activeProgram = 0;
-    this->_activeQueue = 0;
+    this->_activeProgram.clear();
+    this->_activeQueue.clear();
+    this->_activePoolQueue.clear();
     this->_id = 0;
 }
 
@@ -315,7 +304,7 @@ void ocl::Context::insert(ocl::Memory *mem)
 {
 	if(mem == 0) throw std::runtime_error( "Memory not valid");
 	if(*mem->context() != *this) throw std::runtime_error( "Memory has a different context.");
-    _memories.insert(mem);
+    this->_memories.insert(mem);
 }
 
 /*! \brief Releases a Memory if it belongs to this Context.
@@ -329,8 +318,7 @@ void ocl::Context::insert(ocl::Memory *mem)
 void ocl::Context::release(ocl::Memory *mem)
 {
 	if(mem == 0)  throw std::runtime_error("Memory not valid");
-    if(_memories.find(mem) == _memories.end()) return;
-    _memories.erase(mem);
+    if(!this->_memories.erase(mem)) return;
     mem->release();
 }
 
@@ -345,8 +333,7 @@ void ocl::Context::release(ocl::Memory *mem)
 void ocl::Context::remove(ocl::Memory *mem)
 {
 	if(mem == 0)  throw std::runtime_error( "Memory not valid");
-    if(_memories.find(mem) == _memories.end()) return;
-    _memories.erase(mem);
+    this->_memories.erase(mem);
 }
 
 /*! \brief Inserts a Sampler.
@@ -360,7 +347,6 @@ void ocl::Context::remove(ocl::Memory *mem)
 void ocl::Context::insert(ocl::Sampler *sampler)
 {
 	if(sampler == 0)  throw std::runtime_error("Sampler not valid.");
-    if(this->has(*sampler)) return;
 	if(sampler->context() != *this)  throw std::runtime_error( "Cannot insert Sampler with a different Context and this Context");
     this->_samplers.insert(sampler);
 }
@@ -376,8 +362,7 @@ void ocl::Context::insert(ocl::Sampler *sampler)
 void ocl::Context::release(ocl::Sampler *sampler)
 {
 	if(sampler == 0)  throw std::runtime_error( "Sampler not valid");
-    if(_samplers.find(sampler) == _samplers.end()) return;
-    _samplers.erase(sampler);
+    if(!this->_samplers.erase(sampler)) return;
     sampler->release();
 }
 
@@ -391,8 +376,7 @@ void ocl::Context::release(ocl::Sampler *sampler)
 void ocl::Context::remove(ocl::Sampler *sampler)
 {
 	if(sampler == 0)  throw std::runtime_error( "Sampler not valid");
-    if(_samplers.find(sampler) == _samplers.end()) return;
-    _samplers.erase(sampler);
+    this->_samplers.erase(sampler);
 }
 
 /*! \brief Inserts a Queue.
@@ -407,7 +391,6 @@ void ocl::Context::remove(ocl::Sampler *sampler)
 void ocl::Context::insert(ocl::Queue *queue)
 {
 	if(queue == 0)  throw std::runtime_error( "Queue not valid.");
-    if(this->has(*queue)) return;
 	if(queue->context() != *this)  throw std::runtime_error("Cannot insert Queue with a different Context and this Context");
     this->_queues.insert(queue);
 }
@@ -424,12 +407,45 @@ void ocl::Context::insert(ocl::Queue *queue)
 void ocl::Context::release(ocl::Queue *queue)
 {
 	if(queue == 0)  throw std::runtime_error( "Queue not valid.");
-    if(!this->has(*queue)) return;
-    _queues.erase(queue);
-    if(queue == _activeQueue) _activeQueue = 0;
+    if(!this->_queues.erase(queue)) return;
+    this->_activeQueue.reset(queue);
+    this->_activePoolQueue.reset(queue);
     queue->release();
 }
 
+/*! \brief Removes a QueuePool from being the active Queue of this Context.
+  *
+  * Remove is called from a QueuePool when its scope ends
+  * and thus must be destructed. You do not have to call this function.
+  */
+void ocl::Context::remove(ocl::QueuePool *pool)
+{
+	if(pool == 0)  throw std::runtime_error( "QueuePool not valid");
+    this->_activeQueuePool.reset(pool);
+}
+
+/*! \brief Removes a DependencyTracker from being used by this Context.
+  *
+  * Remove is called from a DependencyTracker when its scope ends
+  * and thus must be destructed. You do not have to call this function.
+  */
+void ocl::Context::remove(ocl::DependencyTracker *tracker)
+{
+	if(tracker == 0)  throw std::runtime_error( "DependencyTracker not valid");
+    this->_dependencyTracker.compare_exchange_strong(tracker, nullptr);
+}
+
+/*! \brief Removes a Profiler from being used by this Context.
+  *
+  * Remove is called from a Profiler when its scope ends
+  * and thus must be destructed. You do not have to call this function.
+  */
+void ocl::Context::remove(ocl::Profiler *profiler)
+{
+	if(profiler == 0)  throw std::runtime_error( "Profiler not valid");
+    this->_profiler.compare_exchange_strong(profiler, nullptr);
+}
+
 /*! \brief Removes a Queue if it belongs to this Context.
   *
   * Remove is called from a Queue when its scope ends
@@ -440,9 +456,9 @@ void ocl::Context::release(ocl::Queue *queue)
 void ocl::Context::remove(ocl::Queue *queue)
 {
 	if(queue == 0)  throw std::runtime_error( "Queue not valid");
-    if(this->has(*queue)) return;
-    if(queue == _activeQueue) _activeQueue = 0;
-    _queues.erase(queue);
+    if(!this->_queues.erase(queue)) return;
+    this->_activeQueue.reset(queue);
+    this->_activePoolQueue.reset(queue);
 }
 
 
@@ -457,7 +473,6 @@ void ocl::Context::remove(ocl::Queue *queue)
 void ocl::Context::insert(ocl::Program *prog)
 {
 	if(prog == 0)  throw std::runtime_error("Program not valid.");
-    if(this->has(*prog)) return;
 	if(prog->context() != *this)  throw std::runtime_error( "Cannot insert Program with a different Context and this Context");
     this->_programs.insert(prog);
 }
@@ -474,9 +489,8 @@ void ocl::Context::insert(ocl::Program *prog)
 void ocl::Context::release(ocl::Program *prog)
 {
 	if(prog == 0)  throw std::runtime_error( "Program not valid.");
-    if(!this->has(*prog)) return;    
-    _programs.erase(prog);
-    if(prog == _activeProgram) _activeProgram = 0;
+    if(!this->_programs.erase(prog)) return;
+    this->_activeProgram.reset(prog);
     prog->release();
 }
 
@@ -490,9 +504,8 @@ void ocl::Context::release(ocl::Program *prog)
 void ocl::Context::remove(ocl::Program *prog)
 {
 	if(prog == 0)  throw std::runtime_error( "Program not valid");
-    if(!this->has(*prog)) return;
-    _programs.erase(prog);
-    if(prog == _activeProgram) _activeProgram = 0;
+    if(!this->_programs.erase(prog)) return;
+    this->_activeProgram.reset(prog);
 }
 
 /*! \brief Inserts a Event.
@@ -506,7 +519,6 @@ void ocl::Context::remove(ocl::Program *prog)
 void ocl::Context::insert(ocl::Event *event)
 {
 	if(event == 0)  throw std::runtime_error("Event not valid.");
-    if(this->has(*event)) return;
 	if(event->context() != *this)  throw std::runtime_error( "Cannot insert Event with a different Context and this Context");
     this->_events.insert(event);
 }
@@ -523,8 +535,7 @@ void ocl::Context::insert(ocl::Event *event)
 void ocl::Context::release(ocl::Event *event)
 {
 	if(event == 0)  throw std::runtime_error( "Event not valid.");
-    if(this->has(*event)) return;
-    _events.erase(event);
+    if(!this->_events.erase(event)) return;
     event->release();
 }
 
@@ -538,8 +549,7 @@ void ocl::Context::release(ocl::Event *event)
 void ocl::Context::remove(ocl::Event *event)
 {
 	if(event == 0)  throw std::runtime_error( "Event not valid");
-    if(!has(*event)) return;
-    _events.erase(event);
+    this->_events.erase(event);
 }
 
 
@@ -549,46 +559,140 @@ void ocl::Context::remove(ocl::Event *event)
   *
   * User has to set the active Queue explicitly.
   * In case no active Queue, no command can be
-  * executed.
+  * executed. The Queue set by the calling thread
+  * is returned if there is one. If a QueuePool is active,
+  * the Queue which it has selected for the calling thread
+  * is returned until rotateActiveQueue() is called so that
+  * commands without an explicit Queue remain in order.
   */
 ocl::Queue& ocl::Context::activeQueue() const
 {
-	if(this->_activeQueue == 0)  throw std::runtime_error( "No active queue present");
-    return *this->_activeQueue;
+	ocl::QueuePool *pool = this->_activeQueuePool.get();
+	if(pool != 0){
+		ocl::Queue *queue = this->_activePoolQueue.get();
+		if(queue == 0) return this->rotateActiveQueue();
+		return *queue;
+	}
+	ocl::Queue *queue = this->_activeQueue.get();
+	if(queue == 0)  throw std::runtime_error( "No active queue present");
+    return *queue;
+}
+
+/*! \brief Selects the next Queue of the active QueuePool for the calling thread and returns it.
+  *
+  * Subsequent commands without an explicit Queue are enqueued to
+  * the returned Queue. Commands enqueued before are not ordered with
+  * respect to them unless they are synchronized with Event objects.
+  */
+ocl::Queue& ocl::Context::rotateActiveQueue() const
+{
+	ocl::QueuePool *pool = this->_activeQueuePool.get();
+	if(pool == 0)  throw std::runtime_error( "No active queue pool present");
+	ocl::Queue &queue = pool->next();
+	this->_activePoolQueue.set(&queue);
+	return queue;
 }
 
 /*! \brief Sets the active Queue for this Context.
   *
   * User has to set the active Queue explicitly.
   * In case no active Queue, no command can be
-  * executed.
+  * executed. The Queue becomes active for the calling thread.
   */
 void ocl::Context::setActiveQueue(ocl::Queue &q)
 {
 	if(!this->has(q))  throw std::runtime_error( "Queue is not within this Context");
-    this->_activeQueue = &q;
+    this->_activeQueue.set(&q);
+    this->_activeQueuePool.set(0);
+}
+
+/*! \brief Sets the QueuePool as the active Queue for this Context.
+  *
+  * The QueuePool becomes active for the calling thread and selects
+  * the Queue to which commands without an explicit Queue are enqueued.
+  * See activeQueue() and rotateActiveQueue().
+  */
+void ocl::Context::setActiveQueue(ocl::QueuePool &pool)
+{
+	if(&pool.context() != this)  throw std::runtime_error( "QueuePool is not within this Context");
+    this->_activeQueuePool.set(&pool);
+    this->rotateActiveQueue();
+}
+
+/*! \brief Returns the active QueuePool of the calling thread or null if there is none. */
+ocl::QueuePool* ocl::Context::activeQueuePool() const
+{
+	return this->_activeQueuePool.get();
+}
+
+/*! \brief Notifies the active QueuePool about a command enqueued on the active Queue.
+  *
+  * Called by commands without an explicit Queue so that the
+  * QueuePool counts them as in flight. You do not have to call this function.
+  */
+void ocl::Context::track(const ocl::Queue &queue, const ocl::Event &event)
+{
+	ocl::QueuePool *pool = this->_activeQueuePool.get();
+	if(pool != 0) pool->track(queue, event);
+}
+
+/*! \brief Sets the DependencyTracker for this Context.
+  *
+  * Kernel executions and Memory transfers within this Context
+  * then wait for the commands using the same Memory objects.
+  */
+void ocl::Context::setDependencyTracker(ocl::DependencyTracker &tracker)
+{
+	if(&tracker.context() != this)  throw std::runtime_error( "DependencyTracker is not within this Context");
+    this->_dependencyTracker.store(&tracker);
+}
+
+/*! \brief Returns the DependencyTracker of this Context or null if there is none. */
+ocl::DependencyTracker* ocl::Context::dependencyTracker() const
+{
+	return this->_dependencyTracker.load();
+}
+
+/*! \brief Sets the Profiler for this Context.
+  *
+  * Kernel executions and asynchronous Memory commands within
+  * this Context are then recorded by the Profiler.
+  */
+void ocl::Context::setProfiler(ocl::Profiler &profiler)
+{
+	if(&profiler.context() != this)  throw std::runtime_error( "Profiler is not within this Context");
+    this->_profiler.store(&profiler);
+}
+
+/*! \brief Returns the Profiler of this Context or null if there is none. */
+ocl::Profiler* ocl::Context::profiler() const
+{
+	return this->_profiler.load();
 }
 
 
 /*! \brief Returns the active Program for this Context.
   *
   * User has to set the active Queue explicitly.
+  * The Program set by the calling thread is returned if there is one.
   */
 ocl::Program& ocl::Context::activeProgram() const
 {
-	if(this->_activeProgram == 0)  throw std::runtime_error( "No active queue present");
-    return *this->_activeProgram;
+	ocl::Program *program = this->_activeProgram.get();
+	if(program == 0)  throw std::runtime_error( "No active queue present");
+    return *program;
 }
 
 /*! \brief Sets the active Program for this Context.
   *
-  * User has to set the active Program explicitly.
+  * User has to set the active Program explicitly. The Program becomes active
+  * for the calling thread.
   */
 void ocl::Context::setActiveProgram(Program &p)
 {
 	if(!this->has(p))  throw std::runtime_error( "Program is not within this Context");
 	if(!p.isBuilt())  throw std::runtime_error( "Program not yet created.");
-    this->_activeProgram = &p;
+    this->_activeProgram.set(&p);
 }
 
 
@@ -611,48 +715,60 @@ bool ocl::Context::has(const DeviceType t) const
 /*! \brief Returns true if this Context has the specified Sampler. */
 bool ocl::Context::has(const ocl::Sampler& s) const
 {
-    return this->_samplers.find(const_cast<ocl::Sampler*>(&s)) != this->_samplers.end();
+    return this->_samplers.contains(&s);
 }
 
 
 /*! \brief Returns true if this Context has the specified Queue. */
 bool ocl::Context::has(const ocl::Queue& q) const
 {
-    return this->_queues.find(const_cast<ocl::Queue*>(&q)) != this->_queues.end();
+    return this->_queues.contains(&q);
 }
 
 /*! \brief Returns true if this Context has the specified Program. */
 bool ocl::Context::has(const ocl::Program& p) const
 {
-    return this->_programs.find(const_cast<ocl::Program*>(&p)) != this->_programs.end();
+    return this->_programs.contains(&p);
 }
 
 /*! \brief Returns true if this Context has the specified Event. */
 bool ocl::Context::has(const ocl::Event& e) const
 {
-    return this->_events.find(const_cast<ocl::Event*>(&e)) != this->_events.end();
+    return this->_events.contains(&e);
+}
+
+/*! \brief Returns true if this Context has the specified Memory. */
+bool ocl::Context::has(const ocl::Memory& m) const
+{
+    return this->_memories.contains(&m);
 }
 
 
 
-/*! \brief Returns all Memory s for this Context. */
-const std::set<ocl::Memory*>& ocl::Context::memories() const
+/*! \brief Returns a copy of all Event s for this Context. */
+std::set<ocl::Event*> ocl::Context::events() const
 {
-    return this->_memories;
+    return this->_events.items();
 }
 
-/*! \brief Returns all Memory s for this Context. */
-const std::set<ocl::Sampler*>& ocl::Context::samplers() const
+/*! \brief Returns a copy of all Memory s for this Context. */
+std::set<ocl::Memory*> ocl::Context::memories() const
 {
-    return this->_samplers;
+    return this->_memories.items();
+}
+
+/*! \brief Returns a copy of all Sampler s for this Context. */
+std::set<ocl::Sampler*> ocl::Context::samplers() const
+{
+    return this->_samplers.items();
 }
 
 
 
-/*! \brief Returns all Queue s for this Context. */
-const std::set<ocl::Queue*>& ocl::Context::queues() const
+/*! \brief Returns a copy of all Queue s for this Context. */
+std::set<ocl::Queue*> ocl::Context::queues() const
 {
-    return this->_queues;
+    return this->_queues.items();
 }
 
 /*! \brief Returns all Device s for this Context. */
@@ -671,6 +787,47 @@ std::vector<cl_device_id> ocl::Context::cl_devices() const
 }
 
 
+/*! \brief Returns the image formats supported by all Device objects of this Context.
+  *
+  * The formats are queried once for each image type and access and cached.
+  * The returned reference stays valid as long as this Context.
+  * Only the access qualifiers of the flags, e.g. CL_MEM_READ_ONLY, are considered.
+  *
+  * \param type is the image type, e.g. CL_MEM_OBJECT_IMAGE2D.
+  * \param flags are the flags with which the image is created.
+  */
+const std::vector<cl_image_format>& ocl::Context::imageFormats(cl_mem_object_type type, cl_mem_flags flags) const
+{
+	if(this->_id == 0) throw std::runtime_error("context not created");
+	flags &= (CL_MEM_READ_WRITE | CL_MEM_WRITE_ONLY | CL_MEM_READ_ONLY);
+	if(flags == 0) flags = CL_MEM_READ_WRITE;
+
+	std::lock_guard<std::mutex> lock(this->_imageFormatsMutex);
+	const auto key = std::make_pair(type, flags);
+	auto it = this->_imageFormats.find(key);
+	if(it == this->_imageFormats.end()){
+		cl_uint count = 0;
+		OPENCL_SAFE_CALL( clGetSupportedImageFormats(this->_id, flags, type, 0, NULL, &count) );
+		std::vector<cl_image_format> formats(count);
+		if(count > 0) OPENCL_SAFE_CALL( clGetSupportedImageFormats(this->_id, flags, type, count, formats.data(), NULL) );
+		it = this->_imageFormats.insert(std::make_pair(key, formats)).first;
+	}
+	return it->second;
+}
+
+/*! \brief Returns true if the image format is supported for the image type and access.
+  *
+  * See imageFormats().
+  */
+bool ocl::Context::supportsImageFormat(const cl_image_format &format, cl_mem_object_type type, cl_mem_flags flags) const
+{
+	const std::vector<cl_image_format> &formats = this->imageFormats(type, flags);
+	auto equal = [&format](const cl_image_format &f){
+		return f.image_channel_order == format.image_channel_order && f.image_channel_data_type == format.image_channel_data_type;
+	};
+	return std::find_if(formats.begin(), formats.end(), equal) != formats.end();
+}
+
 /*! \brief True if a context is already created. */
 bool ocl::Context::created() const
 {
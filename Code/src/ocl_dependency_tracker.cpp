@@ -0,0 +1,169 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+
+#include <ocl_dependency_tracker.h>
+#include <ocl_context.h>
+#include <ocl_event_list.h>
+
+
+/*! \brief Instantiates this DependencyTracker for the Context.
+  *
+  * Call Context::setDependencyTracker in order to use it.
+  */
+ocl::DependencyTracker::DependencyTracker(Context &ctxt) :
+	_context(&ctxt), _mutex(), _states()
+{
+}
+
+/*! \brief Destructs this DependencyTracker and removes it from its Context. */
+ocl::DependencyTracker::~DependencyTracker()
+{
+	_context->remove(this);
+}
+
+/*! \brief Enqueues a command using the Memory objects and returns its Event.
+  *
+  * The command is called with the events of the list together with the events of the
+  * commands on which it depends. Its Event is recorded before other commands using
+  * the Memory objects can be enqueued with this DependencyTracker.
+  *
+  * \param uses are the Memory objects read or written by the command.
+  * \param list contains events for which the command has to wait in addition.
+  * \param command enqueues the command and returns its Event.
+  */
+ocl::Event ocl::DependencyTracker::enqueue(const Uses &uses, const EventList &list, const Command &command)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	const Event event = command(this->waitList(uses, list));
+	this->record(uses, event);
+	return event;
+}
+
+/*! \brief Executes a blocking command using the Memory objects.
+  *
+  * The command is called with the events of the list together with the events of the
+  * commands on which it depends and has to complete before it returns.
+  *
+  * \param uses are the Memory objects read or written by the command.
+  * \param list contains events for which the command has to wait in addition.
+  * \param command executes the command and waits for its completion.
+  */
+void ocl::DependencyTracker::execute(const Uses &uses, const EventList &list, const BlockingCommand &command)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	command(this->waitList(uses, list));
+	this->completed(uses);
+}
+
+/*! \brief Returns the events for which a command using the Memory objects has to wait.
+  *
+  * The events of the EventList are included. Each event is contained once.
+  * The DependencyTracker must be locked by the caller.
+  *
+  * \param uses are the Memory objects read or written by the command.
+  * \param list contains events for which the command has to wait in addition.
+  */
+ocl::EventList ocl::DependencyTracker::waitList(const Uses &uses, const EventList &list) const
+{
+	EventList events(list);
+	std::set<cl_event> contained(list.data(), list.data() + list.size());
+	for(const auto &use : uses){
+		const auto it = _states.find(use.first);
+		if(it == _states.end()) continue;
+		const State &state = it->second;
+		if(state.writer && contained.insert(state.writer->id()).second)
+			events.append(*state.writer);
+		if(use.second & Memory::WriteOnly)
+			for(const auto &reader : state.readers)
+				if(contained.insert(reader.id()).second) events.append(reader);
+	}
+	return events;
+}
+
+/*! \brief Records the Event of an enqueued command using the Memory objects.
+  *
+  * The Event becomes the last writer of written Memory objects
+  * and a reader of Memory objects which are only read.
+  * Completed events are dropped. The DependencyTracker must be locked by the caller.
+  */
+void ocl::DependencyTracker::record(const Uses &uses, const Event &event)
+{
+	for(const auto &use : uses){
+		State &state = _states[use.first];
+		if(use.second & Memory::WriteOnly){
+			state.writer.reset(new Event(event));
+			state.readers.clear();
+			continue;
+		}
+		if(state.writer && state.writer->isCompleted())
+			state.writer.reset();
+		state.readers.erase(std::remove_if(state.readers.begin(), state.readers.end(),
+		                                   [](const Event &e){ return e.isCompleted(); }), state.readers.end());
+		state.readers.push_back(event);
+	}
+}
+
+/*! \brief Records that a blocking command using the Memory objects has completed.
+  *
+  * The command has waited for all commands it depends on.
+  * Thus, there are no outstanding writers of the Memory objects
+  * and no outstanding readers of written Memory objects.
+  * The DependencyTracker must be locked by the caller.
+  */
+void ocl::DependencyTracker::completed(const Uses &uses)
+{
+	for(const auto &use : uses){
+		const auto it = _states.find(use.first);
+		if(it == _states.end()) continue;
+		if(use.second & Memory::WriteOnly) _states.erase(it);
+		else                               it->second.writer.reset();
+	}
+}
+
+/*! \brief Removes the outstanding commands of the Memory object.
+  *
+  * Called when the Memory object is released. You do not have to call this function.
+  */
+void ocl::DependencyTracker::forget(cl_mem mem)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_states.erase(mem);
+}
+
+/*! \brief Removes the outstanding commands of all Memory objects. */
+void ocl::DependencyTracker::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_states.clear();
+}
+
+/*! \brief Returns the number of Memory objects with outstanding commands. */
+size_t ocl::DependencyTracker::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _states.size();
+}
+
+/*! \brief Returns the Context of this DependencyTracker. */
+ocl::Context& ocl::DependencyTracker::context() const
+{
+	return *_context;
+}
@@ -16,7 +16,6 @@
 //along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
-#include <cstring>
 #include <memory>
 #include <stdexcept>
 
@@ -32,12 +31,9 @@
   * \param dev is a OpenCL device which is identified with cl_device_id.
   */
 ocl::Device::Device(cl_device_id dev) :
-	_id(dev), _type(ocl::device_type::ALL)
+	_id(dev), _type(ocl::device_type::ALL), _info(ocl::DeviceInfo::get(dev))
 {
-	cl_device_type t;
-	OPENCL_SAFE_CALL( clGetDeviceInfo (_id,CL_DEVICE_TYPE, sizeof(t), &t, NULL) );
-	_type = ocl::DeviceType::type(t);
-
+	_type = ocl::DeviceType::type(_info->type());
 }
 
 /*! \brief Instantiates this Device.
@@ -45,18 +41,15 @@ ocl::Device::Device(cl_device_id dev) :
   * No OpenCL device specified. Must do this later.
   */
 ocl::Device::Device() :
-	_id(0), _type(ocl::device_type::ALL)
+	_id(0), _type(ocl::device_type::ALL), _info()
 {
 
 }
 
+/*! \brief Returns true if the OpenCL version of this Device is at least major.minor. */
 bool ocl::Device::supportsVersion( int major, int minor ) const
 {
-	int mjr = 0, mnr = 0;
-
-	std::sscanf( version().c_str(), "OpenCL %i.%i", &mjr, &mnr );
-
-	return mjr > major || (mjr == major && mnr >= minor);
+	return this->info().supportsVersion(major, minor);
 }
 
 
@@ -78,7 +71,7 @@ ocl::Device::~Device()
   * \param dev Device from which this Device is created.
   */
 ocl::Device::Device(const Device& dev) :
-	_id(dev._id), _type(dev._type)
+	_id(dev._id), _type(dev._type), _info(dev._info)
 {
 	OPENCL_SAFE_CALL( clRetainDevice( _id ) );
 }
@@ -93,10 +86,11 @@ ocl::Device& ocl::Device::operator =(const ocl::Device &dev)
 {
 	if ( this != &dev )
 	{
+		if ( dev._id != nullptr ) OPENCL_SAFE_CALL( clRetainDevice( dev._id ) );
+		if ( _id != nullptr ) OPENCL_SAFE_CALL( clReleaseDevice( _id ) );
 		_id = dev._id;
 		_type = dev._type;
-
-		OPENCL_SAFE_CALL( clRetainDevice( _id ) );
+		_info = dev._info;
 	}
 
 	return *this;
@@ -105,12 +99,13 @@ ocl::Device& ocl::Device::operator =(const ocl::Device &dev)
 
 /*! \brief Sets the id of this Device
   *
-  * Note that you have to change the type if
-  * the cl_device_id does not refer to the same type.
+  * The type and the capabilities are taken from the new cl_device_id.
   * \param id new cl_device_id to be set.
   */
 void ocl::Device::setId(cl_device_id id)
 {
+	this->_info = id ? ocl::DeviceInfo::get(id) : std::shared_ptr<const ocl::DeviceInfo>();
+	this->_type = id ? ocl::DeviceType::type(this->_info->type()) : ocl::device_type::ALL;
 	this->_id = id;
 }
 
@@ -130,6 +125,16 @@ const ocl::DeviceType& ocl::Device::type() const
 	return this->_type;
 }
 
+/*! \brief Returns the capabilities of this Device
+  *
+  * The capabilities are queried once for each OpenCL device.
+  */
+const ocl::DeviceInfo& ocl::Device::info() const
+{
+	if(!this->_info) throw std::runtime_error("device not valid");
+	return *this->_info;
+}
+
 
 /*! \brief Returns true if the ids are the same.
   *
@@ -201,112 +206,88 @@ bool ocl::Device::isAccelerator() const
 /*! \brief Returns the maximum compute units for a given device. */
 size_t ocl::Device::maxComputeUnits() const
 {
-	cl_uint maxCompUnits;
-	OPENCL_SAFE_CALL(  clGetDeviceInfo (_id, CL_DEVICE_MAX_COMPUTE_UNITS , sizeof(maxCompUnits), &maxCompUnits, NULL) );
-	return size_t(maxCompUnits);
+	return this->info().maxComputeUnits();
 }
 
 /*! \brief Returns the maximum dimensions that specify the global and local work-item IDs for *this. */
 size_t ocl::Device::maxWorkItemDim() const
 {
-	cl_uint maxWorkItemDim;
-	OPENCL_SAFE_CALL( clGetDeviceInfo (_id, CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS , sizeof(maxWorkItemDim), &maxWorkItemDim, NULL) );
-	return size_t(maxWorkItemDim);
+	return this->info().maxWorkItemDim();
 }
 
 /*! \brief Returns the maximum number of work-items that can be specified in each dimension of the work-group for *this. */
 std::vector<size_t> ocl::Device::maxWorkItemSizes() const
 {
-	std::vector<size_t> a(3,0);
-	//size_t a[3];
-	OPENCL_SAFE_CALL( clGetDeviceInfo (this->id(), CL_DEVICE_MAX_WORK_ITEM_SIZES , sizeof(size_t)*3, a.data(), NULL) );
-	//std::vector<size_t> b(a, a + sizeof(a) / sizeof(int));
-	return a;
+	return this->info().maxWorkItemSizes();
 }
 
 /*! \brief Returns the maximum number of work-items in a work- group executing a kernel on a single compute unit for *this. */
 size_t ocl::Device::maxWorkGroupSize() const
 {
-	size_t a;
-	OPENCL_SAFE_CALL( clGetDeviceInfo (this->id(), CL_DEVICE_MAX_WORK_GROUP_SIZE , sizeof(a), &a, NULL) );
-	return a;
+	return this->info().maxWorkGroupSize();
 }
 
 /*! \brief Returns the maximum size in bytes of a constant buffer allocation for *this. */
 size_t ocl::Device::maxConstantBufferSize() const
 {
-	cl_ulong a;
-	OPENCL_SAFE_CALL( clGetDeviceInfo (this->id(), CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE , sizeof(a), &a, NULL) );
-	return size_t(a);
+	return this->info().maxConstantBufferSize();
 }
 
 
 /*! \brief Returns the maximum size of memory object allocation in bytes for *this . */
 size_t ocl::Device::maxMemAllocSize() const
 {
-	cl_ulong maxMemAllocSize;
-	OPENCL_SAFE_CALL(  clGetDeviceInfo (_id, CL_DEVICE_MAX_MEM_ALLOC_SIZE , sizeof(maxMemAllocSize), &maxMemAllocSize, NULL) );
-	return size_t(maxMemAllocSize);
+	return this->info().maxMemAllocSize();
 }
 
 /*! \brief Returns the global memory size in bytes for *this . */
 size_t ocl::Device::globalMemSize() const
 {
-	cl_ulong a;
-	OPENCL_SAFE_CALL(  clGetDeviceInfo (_id, CL_DEVICE_GLOBAL_MEM_SIZE , sizeof(a), &a, NULL) );
-	return size_t(a);
+	return this->info().globalMemSize();
 }
 
 /*! \brief Returns the local memory size in bytes for *this . */
 size_t ocl::Device::localMemSize() const
 {
-	cl_ulong a;
-	OPENCL_SAFE_CALL(  clGetDeviceInfo (_id, CL_DEVICE_LOCAL_MEM_SIZE , sizeof(a), &a, NULL) );
-	return size_t(a);
+	return this->info().localMemSize();
 }
 
 /*! \brief Returns the OpenCL platform on which this Device is located.*/
 cl_platform_id ocl::Device::platform() const
 {
-	cl_platform_id pl;
-	OPENCL_SAFE_CALL( clGetDeviceInfo (this->id(), CL_DEVICE_PLATFORM , sizeof(pl), &pl, NULL) );
+	cl_platform_id pl = this->info().platform();
 	if(pl == nullptr) throw std::runtime_error("platform not found");
 	return pl;
 }
 
-static std::string 
-getDeviceInfo(cl_device_id id, cl_device_info info)
+/*! \brief Returns the version of this Device .*/
+std::string ocl::Device::version() const
 {
-	size_t size = 0u;
-	OPENCL_SAFE_CALL( clGetDeviceInfo(id, info, 0u, nullptr, &size ) );
-	std::unique_ptr< char[] > buffer( new char[size] );
-
-	OPENCL_SAFE_CALL( clGetDeviceInfo(id, info,  size, buffer.get(), NULL));
-	return buffer.get();
+	return this->info().version();
 }
 
-/*! \brief Returns the version of this Device .*/
-std::string ocl::Device::version() const
+/*! \brief Returns the version of the OpenCL driver of this Device .*/
+std::string ocl::Device::driverVersion() const
 {
-	return getDeviceInfo(this->id(),CL_DEVICE_VERSION);
+	return this->info().driverVersion();
 }
 
 /*! \brief Returns the name of this Device .*/
 std::string ocl::Device::name() const
 {
-	return getDeviceInfo(this->id(),CL_DEVICE_NAME);
+	return this->info().name();
 }
 
 /*! \brief Returns the name of the vendor of this Device .*/
 std::string ocl::Device::vendor() const
 {
-	return getDeviceInfo(this->id(),CL_DEVICE_VENDOR);
+	return this->info().vendor();
 }
 
 /*! \brief Returns all extensions of this Device (support of double precision?) .*/
 std::string ocl::Device::extensions() const
 {
-	return getDeviceInfo(this->id(),CL_DEVICE_EXTENSIONS);
+	return this->info().extensions();
 }
 
 /*! \brief Prints this Device.*/
@@ -317,34 +298,16 @@ void ocl::Device::print() const
 	std::cout << "\t\tName: " <<  this->name() << std::endl;
 }
 
-static bool supportsExtension( std::string const& extensionsString, char const* extension )
-{
-	auto const len = std::strlen( extension );
-	auto p = extensionsString.c_str();
-
-	while ( *p != '\0' )
-	{
-		auto n = std::strcspn( p, " " );
-
-		if ( len == n && 0 == strncmp( p, extension, n ) ) return true;
-		p += ++n;
-	}
-
-	return false;
-}
-
-
 /*! \brief Return true if this Device supports images.*/
 bool ocl::Device::imageSupport() const
 {
-	cl_bool support = CL_FALSE;
-	OPENCL_SAFE_CALL( clGetDeviceInfo( this->id(), CL_DEVICE_IMAGE_SUPPORT, sizeof support, &support, NULL ) );
-	return support == CL_TRUE;
+	return this->info().imageSupport();
 }
 
+/*! \brief Return true if this Device supports the extension.*/
 bool ocl::Device::supportsExtension( std::string const& ext ) const
 {
-	return ::supportsExtension( extensions(), ext.c_str() );
+	return this->info().supportsExtension( ext );
 }
 
 
@@ -356,3 +319,92 @@ bool ocl::Device::doubleSupport() const
 {
 	return supportsExtension( "cl_khr_fp64" );
 }
+
+/*! \brief Returns true if this Device has been created by partitioning another Device. */
+bool ocl::Device::isSubDevice() const
+{
+	return this->info().parent() != nullptr;
+}
+
+/*! \brief Returns the Device from which this sub-device has been partitioned. */
+ocl::Device ocl::Device::parent() const
+{
+	cl_device_id id = this->info().parent();
+	if(id == nullptr) throw std::runtime_error("device is not a sub-device");
+	OPENCL_SAFE_CALL( clRetainDevice( id ) );
+	return ocl::Device(id);
+}
+
+/*! \brief Returns true if this Device can be partitioned with the partition type, e.g. CL_DEVICE_PARTITION_EQUALLY. */
+bool ocl::Device::supportsPartition(cl_device_partition_property type) const
+{
+	const std::vector<cl_device_partition_property> &types = this->info().partitionProperties();
+	return std::find(types.begin(), types.end(), type) != types.end();
+}
+
+/*! \brief Returns true if this Device can be partitioned along the affinity domain. */
+bool ocl::Device::supportsAffinityDomain(AffinityDomain domain) const
+{
+	return this->supportsPartition(CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN) &&
+	       (this->info().partitionAffinityDomain() & cl_device_affinity_domain(domain)) != 0;
+}
+
+/*! \brief Partitions this Device into as many sub-devices as possible with the same number of compute units.
+  *
+  * \param computeUnits is the number of compute units of each sub-device.
+  * \returns the sub-devices which can be used as any other Device.
+  */
+std::vector<ocl::Device> ocl::Device::partitionEqually(size_t computeUnits) const
+{
+	if(computeUnits == 0) throw std::runtime_error("number of compute units must be greater than zero");
+	if(!this->supportsPartition(CL_DEVICE_PARTITION_EQUALLY)) throw std::runtime_error("device cannot be partitioned equally");
+	return this->partition({CL_DEVICE_PARTITION_EQUALLY, cl_device_partition_property(computeUnits), 0});
+}
+
+/*! \brief Partitions this Device into sub-devices with the specified numbers of compute units.
+  *
+  * \param computeUnits contains the number of compute units for each sub-device.
+  * \returns the sub-devices in the order of the counts.
+  */
+std::vector<ocl::Device> ocl::Device::partitionByCounts(const std::vector<size_t>& computeUnits) const
+{
+	if(computeUnits.empty()) throw std::runtime_error("no compute units specified");
+	if(!this->supportsPartition(CL_DEVICE_PARTITION_BY_COUNTS)) throw std::runtime_error("device cannot be partitioned by counts");
+	std::vector<cl_device_partition_property> properties(1, CL_DEVICE_PARTITION_BY_COUNTS);
+	for(size_t count : computeUnits){
+		if(count == 0) throw std::runtime_error("number of compute units must be greater than zero");
+		properties.push_back(cl_device_partition_property(count));
+	}
+	properties.push_back(CL_DEVICE_PARTITION_BY_COUNTS_LIST_END);
+	properties.push_back(0);
+	return this->partition(properties);
+}
+
+/*! \brief Partitions this Device into sub-devices whose compute units share the affinity domain.
+  *
+  * Partitioning a dual-socket CPU along Numa returns one sub-device for each socket.
+  *
+  * \param domain is the affinity domain, e.g. Numa or L3Cache.
+  * \returns the sub-devices, one for each domain.
+  */
+std::vector<ocl::Device> ocl::Device::partitionByAffinity(AffinityDomain domain) const
+{
+	if(!this->supportsAffinityDomain(domain)) throw std::runtime_error("device cannot be partitioned along the affinity domain");
+	return this->partition({CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN, cl_device_partition_property(domain), 0});
+}
+
+/*! \brief Creates the sub-devices with the zero terminated partition properties. */
+std::vector<ocl::Device> ocl::Device::partition(const std::vector<cl_device_partition_property>& properties) const
+{
+	if(this->_id == nullptr) throw std::runtime_error("device not valid");
+	cl_uint count = 0;
+	OPENCL_SAFE_CALL( clCreateSubDevices(this->_id, properties.data(), 0, NULL, &count) );
+	std::vector<cl_device_id> ids(count, nullptr);
+	if(count > 0) OPENCL_SAFE_CALL( clCreateSubDevices(this->_id, properties.data(), count, ids.data(), NULL) );
+
+	// the sub-devices are created with a reference count of one which is owned by the Device.
+	std::vector<ocl::Device> devices;
+	devices.reserve(count);
+	for(cl_device_id id : ids) devices.push_back(ocl::Device(id));
+	return devices;
+}
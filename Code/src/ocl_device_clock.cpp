@@ -0,0 +1,185 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+#include <stdexcept>
+
+#include <ocl_device_clock.h>
+#include <ocl_context.h>
+#include <ocl_device.h>
+#include <ocl_platform_info.h>
+#include <ocl_query.h>
+#include <ocl_queue.h>
+
+
+/*! \brief Returns the nanoseconds of the time point since the epoch of the host clock. */
+static std::int64_t nanoseconds( ocl::DeviceClock::host_clock::time_point time )
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+
+/*! \brief Instantiates a DeviceClock for the Device of the Queue and calibrates it once.
+  *
+  * If the Device has no host timer, a command queue with profiling
+  * enabled is created for the markers in the Context of the Queue.
+  */
+ocl::DeviceClock::DeviceClock(const Queue &queue) :
+	_queue(&queue), _markerQueue(), _hostTimer(false), _calibrations(0), _first(), _last()
+{
+#if CL_VERSION_2_1
+	if(queue.device().supportsVersion(2, 1)){
+		cl_ulong device = 0, host = 0;
+		_hostTimer = clGetDeviceAndHostTimer(queue.device().id(), &device, &host) == CL_SUCCESS;
+	}
+#endif
+	if(!_hostTimer){
+		cl_int status = CL_SUCCESS;
+		cl_command_queue id = nullptr;
+#if CL_VERSION_2_0
+		if(ocl::PlatformInfo::get(queue.device().platform())->supportsVersion(2, 0)){
+			const cl_queue_properties properties[] = { CL_QUEUE_PROPERTIES, CL_QUEUE_PROFILING_ENABLE, 0 };
+			id = clCreateCommandQueueWithProperties(queue.context().id(), queue.device().id(), properties, &status);
+		}
+		else
+#endif
+		{
+			id = clCreateCommandQueue(queue.context().id(), queue.device().id(), CL_QUEUE_PROFILING_ENABLE, &status);
+		}
+		OPENCL_SAFE_CALL( status );
+		_markerQueue.reset(id, clReleaseCommandQueue);
+	}
+	this->calibrate();
+}
+
+/*! \brief Takes a new sample of both clocks.
+  *
+  * Blocks until the markers on the private command queue have completed
+  * if the Device has no host timer, which does not involve the Queue.
+  * The first and the last calibration determine the offset and drift.
+  * Calibrate again after a long-running workload in order to
+  * estimate the drift over a long interval.
+  */
+void ocl::DeviceClock::calibrate()
+{
+	const Sample sample = this->sample();
+	if(_calibrations == 0) _first = sample;
+	_last = sample;
+	++_calibrations;
+}
+
+/*! \brief Returns the number of calibrations. */
+size_t ocl::DeviceClock::calibrations() const
+{
+	return _calibrations;
+}
+
+/*! \brief Returns true if the device time is read with clGetDeviceAndHostTimer. */
+bool ocl::DeviceClock::hasHostTimer() const
+{
+	return _hostTimer;
+}
+
+/*! \brief Returns the device time minus the host time in nanoseconds at the last calibration. */
+double ocl::DeviceClock::offset() const
+{
+	return double(static_cast<std::int64_t>(_last.device) - _last.host);
+}
+
+/*! \brief Returns the relative rate difference of the device clock to the host clock.
+  *
+  * A drift of 1e-6 means that the device clock advances by one
+  * nanosecond more per millisecond. The drift is 0 after one calibration.
+  */
+double ocl::DeviceClock::drift() const
+{
+	if(_calibrations < 2 || _last.host == _first.host) return 0.0;
+	const double device = double(static_cast<std::int64_t>(_last.device - _first.device));
+	const double host = double(_last.host - _first.host);
+	return device / host - 1.0;
+}
+
+/*! \brief Returns the uncertainty of the last calibration in nanoseconds. */
+double ocl::DeviceClock::error() const
+{
+	return double(_last.error);
+}
+
+/*! \brief Converts a device timestamp such as Event::startTime() into host time. */
+ocl::DeviceClock::host_clock::time_point ocl::DeviceClock::toHost(cl_ulong device_ns) const
+{
+	const double elapsed = double(static_cast<std::int64_t>(device_ns) - static_cast<std::int64_t>(_last.device));
+	const std::int64_t host = _last.host + std::llround(elapsed / (1.0 + this->drift()));
+	return host_clock::time_point(std::chrono::duration_cast<host_clock::duration>(std::chrono::nanoseconds(host)));
+}
+
+/*! \brief Converts a host time point into a device timestamp. */
+cl_ulong ocl::DeviceClock::toDevice(host_clock::time_point time) const
+{
+	const double elapsed = double(nanoseconds(time) - _last.host);
+	return cl_ulong(static_cast<std::int64_t>(_last.device) + std::llround(elapsed * (1.0 + this->drift())));
+}
+
+/*! \brief Returns the Queue of this DeviceClock. */
+const ocl::Queue& ocl::DeviceClock::queue() const
+{
+	return *_queue;
+}
+
+/*! \brief Returns the sample with the smallest uncertainty out of several. */
+ocl::DeviceClock::Sample ocl::DeviceClock::sample() const
+{
+	Sample best = this->sampleOnce();
+	for(int i = 1; i < 8; ++i){
+		const Sample sample = this->sampleOnce();
+		if(sample.error < best.error) best = sample;
+	}
+	return best;
+}
+
+/*! \brief Reads the device clock between two readings of the host clock.
+  *
+  * The host time is the middle and the error half of the interval.
+  */
+ocl::DeviceClock::Sample ocl::DeviceClock::sampleOnce() const
+{
+	Sample sample;
+	std::int64_t begin = 0, end = 0;
+#if CL_VERSION_2_1
+	if(_hostTimer){
+		cl_ulong host = 0;
+		begin = nanoseconds(host_clock::now());
+		OPENCL_SAFE_CALL( clGetDeviceAndHostTimer(_queue->device().id(), &sample.device, &host) );
+		end = nanoseconds(host_clock::now());
+	}
+	else
+#endif
+	{
+		cl_event marker = 0;
+		begin = nanoseconds(host_clock::now());
+		OPENCL_SAFE_CALL( clEnqueueMarkerWithWaitList(_markerQueue.get(), 0, NULL, &marker) );
+		end = nanoseconds(host_clock::now());
+		cl_int status = clWaitForEvents(1, &marker);
+		if(status == CL_SUCCESS)
+			status = clGetEventProfilingInfo(marker, CL_PROFILING_COMMAND_QUEUED, sizeof(sample.device), &sample.device, NULL);
+		clReleaseEvent(marker);
+		OPENCL_SAFE_CALL( status );
+	}
+	sample.host = begin + (end - begin) / 2;
+	sample.error = (end - begin + 1) / 2;
+	return sample;
+}
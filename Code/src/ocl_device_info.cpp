@@ -0,0 +1,645 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#include <ocl_device_info.h>
+#include <ocl_query.h>
+
+
+template<class T>
+static T queryDeviceInfo(cl_device_id id, cl_device_info info)
+{
+	T value = T();
+	OPENCL_SAFE_CALL( clGetDeviceInfo(id, info, sizeof(value), &value, NULL) );
+	return value;
+}
+
+static size_t queryDeviceSize(cl_device_id id, cl_device_info info)
+{
+	return size_t(queryDeviceInfo<cl_uint>(id, info));
+}
+
+static size_t queryDeviceBytes(cl_device_id id, cl_device_info info)
+{
+	return size_t(queryDeviceInfo<cl_ulong>(id, info));
+}
+
+static bool queryDeviceBool(cl_device_id id, cl_device_info info)
+{
+	return queryDeviceInfo<cl_bool>(id, info) == CL_TRUE;
+}
+
+static std::string queryDeviceString(cl_device_id id, cl_device_info info)
+{
+	size_t size = 0;
+	OPENCL_SAFE_CALL( clGetDeviceInfo(id, info, 0, NULL, &size) );
+	if(size == 0) return std::string();
+	std::vector<char> buffer(size);
+	OPENCL_SAFE_CALL( clGetDeviceInfo(id, info, size, buffer.data(), NULL) );
+	return std::string(buffer.data());
+}
+
+static int versionNumber(const std::string &version, bool major)
+{
+	int mjr = 0, mnr = 0;
+	std::sscanf( version.c_str(), "OpenCL %i.%i", &mjr, &mnr );
+	return major ? mjr : mnr;
+}
+
+
+/*! \brief Queries all capabilities of the OpenCL device.
+  *
+  * Use get() in order to share the snapshot with
+  * all Device objects referring to the same OpenCL device.
+  *
+  * \param id is the OpenCL device which is queried.
+  */
+ocl::DeviceInfo::DeviceInfo(cl_device_id id) :
+	_id(id),
+	_type(queryDeviceInfo<cl_device_type>(id, CL_DEVICE_TYPE)),
+	_platform(queryDeviceInfo<cl_platform_id>(id, CL_DEVICE_PLATFORM)),
+	_name(queryDeviceString(id, CL_DEVICE_NAME)),
+	_vendor(queryDeviceString(id, CL_DEVICE_VENDOR)),
+	_version(queryDeviceString(id, CL_DEVICE_VERSION)),
+	_driverVersion(queryDeviceString(id, CL_DRIVER_VERSION)),
+	_openclCVersion(),
+	_profile(queryDeviceString(id, CL_DEVICE_PROFILE)),
+	_extensions(queryDeviceString(id, CL_DEVICE_EXTENSIONS)),
+	_extensionSet(),
+	_vendorId(queryDeviceInfo<cl_uint>(id, CL_DEVICE_VENDOR_ID)),
+	_versionMajor(versionNumber(_version, true)),
+	_versionMinor(versionNumber(_version, false)),
+	_parent(0),
+	_maxComputeUnits(queryDeviceSize(id, CL_DEVICE_MAX_COMPUTE_UNITS)),
+	_maxClockFrequency(queryDeviceSize(id, CL_DEVICE_MAX_CLOCK_FREQUENCY)),
+	_maxWorkItemSizes(queryDeviceSize(id, CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS), 0),
+	_maxWorkGroupSize(queryDeviceInfo<size_t>(id, CL_DEVICE_MAX_WORK_GROUP_SIZE)),
+	_maxParameterSize(queryDeviceInfo<size_t>(id, CL_DEVICE_MAX_PARAMETER_SIZE)),
+	_partitionMaxSubDevices(0),
+	_partitionProperties(),
+	_partitionAffinityDomain(0),
+	_preferredVectorWidth(),
+	_addressBits(queryDeviceSize(id, CL_DEVICE_ADDRESS_BITS)),
+	_memBaseAddrAlign(queryDeviceSize(id, CL_DEVICE_MEM_BASE_ADDR_ALIGN)),
+	_maxMemAllocSize(queryDeviceBytes(id, CL_DEVICE_MAX_MEM_ALLOC_SIZE)),
+	_globalMemSize(queryDeviceBytes(id, CL_DEVICE_GLOBAL_MEM_SIZE)),
+	_globalMemCacheSize(queryDeviceBytes(id, CL_DEVICE_GLOBAL_MEM_CACHE_SIZE)),
+	_globalMemCachelineSize(queryDeviceSize(id, CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE)),
+	_globalMemCacheType(queryDeviceInfo<cl_device_mem_cache_type>(id, CL_DEVICE_GLOBAL_MEM_CACHE_TYPE)),
+	_localMemSize(queryDeviceBytes(id, CL_DEVICE_LOCAL_MEM_SIZE)),
+	_localMemType(queryDeviceInfo<cl_device_local_mem_type>(id, CL_DEVICE_LOCAL_MEM_TYPE)),
+	_maxConstantBufferSize(queryDeviceBytes(id, CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE)),
+	_maxConstantArgs(queryDeviceSize(id, CL_DEVICE_MAX_CONSTANT_ARGS)),
+	_hostUnifiedMemory(false),
+	_errorCorrectionSupport(queryDeviceBool(id, CL_DEVICE_ERROR_CORRECTION_SUPPORT)),
+	_imageSupport(queryDeviceBool(id, CL_DEVICE_IMAGE_SUPPORT)),
+	_maxReadImageArgs(queryDeviceSize(id, CL_DEVICE_MAX_READ_IMAGE_ARGS)),
+	_maxWriteImageArgs(queryDeviceSize(id, CL_DEVICE_MAX_WRITE_IMAGE_ARGS)),
+	_maxSamplers(queryDeviceSize(id, CL_DEVICE_MAX_SAMPLERS)),
+	_image2dMaxSize(),
+	_image3dMaxSize(),
+	_imageMaxBufferSize(0),
+	_imagePitchAlignment(0),
+	_singleFpConfig(queryDeviceInfo<cl_device_fp_config>(id, CL_DEVICE_SINGLE_FP_CONFIG)),
+	_doubleFpConfig(0),
+	_executionCapabilities(queryDeviceInfo<cl_device_exec_capabilities>(id, CL_DEVICE_EXECUTION_CAPABILITIES)),
+#ifdef CL_VERSION_2_0
+	_queueProperties(queryDeviceInfo<cl_command_queue_properties>(id, CL_DEVICE_QUEUE_ON_HOST_PROPERTIES)),
+#else
+	_queueProperties(queryDeviceInfo<cl_command_queue_properties>(id, CL_DEVICE_QUEUE_PROPERTIES)),
+#endif
+	_svmCapabilities(0),
+	_profilingTimerResolution(queryDeviceInfo<size_t>(id, CL_DEVICE_PROFILING_TIMER_RESOLUTION)),
+	_endianLittle(queryDeviceBool(id, CL_DEVICE_ENDIAN_LITTLE)),
+	_available(queryDeviceBool(id, CL_DEVICE_AVAILABLE)),
+	_compilerAvailable(queryDeviceBool(id, CL_DEVICE_COMPILER_AVAILABLE)),
+	_linkerAvailable(false)
+{
+	if(!_maxWorkItemSizes.empty())
+		OPENCL_SAFE_CALL( clGetDeviceInfo(id, CL_DEVICE_MAX_WORK_ITEM_SIZES, sizeof(size_t)*_maxWorkItemSizes.size(), _maxWorkItemSizes.data(), NULL) );
+
+	std::istringstream extensions(_extensions);
+	for(std::string extension; extensions >> extension; )
+		_extensionSet.insert(extension);
+
+	const cl_device_info widths[6] = {
+		CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR, CL_DEVICE_PREFERRED_VECTOR_WIDTH_SHORT,
+		CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT, CL_DEVICE_PREFERRED_VECTOR_WIDTH_LONG,
+		CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT, CL_DEVICE_PREFERRED_VECTOR_WIDTH_DOUBLE };
+	for(size_t i = 0; i < 6; ++i)
+		_preferredVectorWidth[i] = queryDeviceSize(id, widths[i]);
+
+	_image2dMaxSize[0] = queryDeviceInfo<size_t>(id, CL_DEVICE_IMAGE2D_MAX_WIDTH);
+	_image2dMaxSize[1] = queryDeviceInfo<size_t>(id, CL_DEVICE_IMAGE2D_MAX_HEIGHT);
+	_image3dMaxSize[0] = queryDeviceInfo<size_t>(id, CL_DEVICE_IMAGE3D_MAX_WIDTH);
+	_image3dMaxSize[1] = queryDeviceInfo<size_t>(id, CL_DEVICE_IMAGE3D_MAX_HEIGHT);
+	_image3dMaxSize[2] = queryDeviceInfo<size_t>(id, CL_DEVICE_IMAGE3D_MAX_DEPTH);
+
+#ifdef CL_VERSION_1_1
+	if(this->supportsVersion(1, 1)){
+		_openclCVersion = queryDeviceString(id, CL_DEVICE_OPENCL_C_VERSION);
+		_preferredVectorWidth[6] = queryDeviceSize(id, CL_DEVICE_PREFERRED_VECTOR_WIDTH_HALF);
+		_hostUnifiedMemory = queryDeviceBool(id, CL_DEVICE_HOST_UNIFIED_MEMORY);
+	}
+#endif
+#ifdef CL_VERSION_1_2
+	if(this->supportsVersion(1, 2)){
+		_parent = queryDeviceInfo<cl_device_id>(id, CL_DEVICE_PARENT_DEVICE);
+		_partitionMaxSubDevices = queryDeviceSize(id, CL_DEVICE_PARTITION_MAX_SUB_DEVICES);
+		_partitionAffinityDomain = queryDeviceInfo<cl_device_affinity_domain>(id, CL_DEVICE_PARTITION_AFFINITY_DOMAIN);
+		size_t size = 0;
+		OPENCL_SAFE_CALL( clGetDeviceInfo(id, CL_DEVICE_PARTITION_PROPERTIES, 0, NULL, &size) );
+		_partitionProperties.resize(size / sizeof(cl_device_partition_property));
+		if(!_partitionProperties.empty())
+			OPENCL_SAFE_CALL( clGetDeviceInfo(id, CL_DEVICE_PARTITION_PROPERTIES, size, _partitionProperties.data(), NULL) );
+		// a single zero entry denotes that the device cannot be partitioned.
+		_partitionProperties.erase(std::remove(_partitionProperties.begin(), _partitionProperties.end(), 0), _partitionProperties.end());
+		_imageMaxBufferSize = queryDeviceInfo<size_t>(id, CL_DEVICE_IMAGE_MAX_BUFFER_SIZE);
+		_linkerAvailable = queryDeviceBool(id, CL_DEVICE_LINKER_AVAILABLE);
+	}
+	if(this->supportsVersion(1, 2) || this->supportsExtension("cl_khr_fp64"))
+		_doubleFpConfig = queryDeviceInfo<cl_device_fp_config>(id, CL_DEVICE_DOUBLE_FP_CONFIG);
+#endif
+#ifdef CL_VERSION_2_0
+	if(this->supportsVersion(2, 0)){
+		_imagePitchAlignment = queryDeviceSize(id, CL_DEVICE_IMAGE_PITCH_ALIGNMENT);
+		_svmCapabilities = queryDeviceInfo<cl_device_svm_capabilities>(id, CL_DEVICE_SVM_CAPABILITIES);
+	}
+#endif
+}
+
+// snapshots of root devices are held, snapshots of sub-devices only observed.
+struct DeviceCache
+{
+	DeviceCache() : mutex(), roots(), subDevices() {}
+	std::mutex mutex;
+	std::map< cl_device_id, std::shared_ptr<const ocl::DeviceInfo> > roots;
+	std::map< cl_device_id, std::weak_ptr<const ocl::DeviceInfo> > subDevices;
+};
+
+static DeviceCache& deviceCache()
+{
+	// never destructed so that the cache can be used during static destruction.
+	static DeviceCache *c = new DeviceCache;
+	return *c;
+}
+
+/*! \brief Returns the snapshot of the OpenCL device.
+  *
+  * Snapshots of root devices are kept until refresh() is called so that
+  * each of them is queried only once. Snapshots of sub-devices are kept only while
+  * referenced by a Device because a released sub-device id may be reused by the runtime.
+  */
+std::shared_ptr<const ocl::DeviceInfo> ocl::DeviceInfo::get(cl_device_id id)
+{
+	if(id == nullptr) throw std::runtime_error("device not valid");
+
+	DeviceCache &c = deviceCache();
+	std::lock_guard<std::mutex> lock(c.mutex);
+	auto root = c.roots.find(id);
+	if(root != c.roots.end()) return root->second;
+
+	for(auto it = c.subDevices.begin(); it != c.subDevices.end(); )
+		it = it->second.expired() ? c.subDevices.erase(it) : std::next(it);
+
+	auto sub = c.subDevices.find(id);
+	std::shared_ptr<const ocl::DeviceInfo> info = sub == c.subDevices.end() ? nullptr : sub->second.lock();
+	if(info) return info;
+
+	info = std::make_shared<const ocl::DeviceInfo>(id);
+	if(info->parent() == nullptr) c.roots[id] = info;
+	else c.subDevices[id] = info;
+	return info;
+}
+
+/*! \brief Drops the cached snapshots so that the devices are queried again.
+  *
+  * Snapshots obtained before remain valid.
+  */
+void ocl::DeviceInfo::refresh()
+{
+	DeviceCache &c = deviceCache();
+	std::lock_guard<std::mutex> lock(c.mutex);
+	c.roots.clear();
+	c.subDevices.clear();
+}
+
+/*! \brief Returns true if the version of the device is at least major.minor. */
+bool ocl::DeviceInfo::supportsVersion(int major, int minor) const
+{
+	return _versionMajor > major || (_versionMajor == major && _versionMinor >= minor);
+}
+
+/*! \brief Returns true if the device supports the extension. */
+bool ocl::DeviceInfo::supportsExtension(const std::string &extension) const
+{
+	return _extensionSet.find(extension) != _extensionSet.end();
+}
+
+/*! \brief Returns the OpenCL device. */
+cl_device_id ocl::DeviceInfo::id() const
+{
+	return _id;
+}
+
+/*! \brief Returns the type of the device. */
+cl_device_type ocl::DeviceInfo::type() const
+{
+	return _type;
+}
+
+/*! \brief Returns the platform of the device. */
+cl_platform_id ocl::DeviceInfo::platform() const
+{
+	return _platform;
+}
+
+/*! \brief Returns the parent device of a sub-device or null. */
+cl_device_id ocl::DeviceInfo::parent() const
+{
+	return _parent;
+}
+
+/*! \brief Returns the name of the device. */
+const std::string& ocl::DeviceInfo::name() const
+{
+	return _name;
+}
+
+/*! \brief Returns the vendor of the device. */
+const std::string& ocl::DeviceInfo::vendor() const
+{
+	return _vendor;
+}
+
+/*! \brief Returns the OpenCL version of the device. */
+const std::string& ocl::DeviceInfo::version() const
+{
+	return _version;
+}
+
+/*! \brief Returns the version of the OpenCL driver. */
+const std::string& ocl::DeviceInfo::driverVersion() const
+{
+	return _driverVersion;
+}
+
+/*! \brief Returns the highest OpenCL C version supported by the compiler. */
+const std::string& ocl::DeviceInfo::openclCVersion() const
+{
+	return _openclCVersion;
+}
+
+/*! \brief Returns the profile of the device. */
+const std::string& ocl::DeviceInfo::profile() const
+{
+	return _profile;
+}
+
+/*! \brief Returns all extensions of the device separated by spaces. */
+const std::string& ocl::DeviceInfo::extensions() const
+{
+	return _extensions;
+}
+
+/*! \brief Returns the unique vendor identifier. */
+cl_uint ocl::DeviceInfo::vendorId() const
+{
+	return _vendorId;
+}
+
+/*! \brief Returns the major OpenCL version of the device. */
+int ocl::DeviceInfo::versionMajor() const
+{
+	return _versionMajor;
+}
+
+/*! \brief Returns the minor OpenCL version of the device. */
+int ocl::DeviceInfo::versionMinor() const
+{
+	return _versionMinor;
+}
+
+/*! \brief Returns the number of compute units. */
+size_t ocl::DeviceInfo::maxComputeUnits() const
+{
+	return _maxComputeUnits;
+}
+
+/*! \brief Returns the maximum clock frequency in MHz. */
+size_t ocl::DeviceInfo::maxClockFrequency() const
+{
+	return _maxClockFrequency;
+}
+
+/*! \brief Returns the maximum dimensions of the work-item IDs. */
+size_t ocl::DeviceInfo::maxWorkItemDim() const
+{
+	return _maxWorkItemSizes.size();
+}
+
+/*! \brief Returns the maximum number of work-items in each dimension of a work-group. */
+const std::vector<size_t>& ocl::DeviceInfo::maxWorkItemSizes() const
+{
+	return _maxWorkItemSizes;
+}
+
+/*! \brief Returns the maximum number of work-items in a work-group. */
+size_t ocl::DeviceInfo::maxWorkGroupSize() const
+{
+	return _maxWorkGroupSize;
+}
+
+/*! \brief Returns the maximum size in bytes of all kernel arguments. */
+size_t ocl::DeviceInfo::maxParameterSize() const
+{
+	return _maxParameterSize;
+}
+
+/*! \brief Returns the maximum number of sub-devices. */
+size_t ocl::DeviceInfo::partitionMaxSubDevices() const
+{
+	return _partitionMaxSubDevices;
+}
+
+/*! \brief Returns the supported partition types, e.g. CL_DEVICE_PARTITION_EQUALLY.
+  *
+  * The list is empty if the device cannot be partitioned.
+  */
+const std::vector<cl_device_partition_property>& ocl::DeviceInfo::partitionProperties() const
+{
+	return _partitionProperties;
+}
+
+/*! \brief Returns the supported affinity domains for partitioning by affinity domain. */
+cl_device_affinity_domain ocl::DeviceInfo::partitionAffinityDomain() const
+{
+	return _partitionAffinityDomain;
+}
+
+/*! \brief Returns the preferred vector width for char. */
+size_t ocl::DeviceInfo::preferredVectorWidthChar() const
+{
+	return _preferredVectorWidth[0];
+}
+
+/*! \brief Returns the preferred vector width for short. */
+size_t ocl::DeviceInfo::preferredVectorWidthShort() const
+{
+	return _preferredVectorWidth[1];
+}
+
+/*! \brief Returns the preferred vector width for int. */
+size_t ocl::DeviceInfo::preferredVectorWidthInt() const
+{
+	return _preferredVectorWidth[2];
+}
+
+/*! \brief Returns the preferred vector width for long. */
+size_t ocl::DeviceInfo::preferredVectorWidthLong() const
+{
+	return _preferredVectorWidth[3];
+}
+
+/*! \brief Returns the preferred vector width for float. */
+size_t ocl::DeviceInfo::preferredVectorWidthFloat() const
+{
+	return _preferredVectorWidth[4];
+}
+
+/*! \brief Returns the preferred vector width for double or zero. */
+size_t ocl::DeviceInfo::preferredVectorWidthDouble() const
+{
+	return _preferredVectorWidth[5];
+}
+
+/*! \brief Returns the preferred vector width for half or zero. */
+size_t ocl::DeviceInfo::preferredVectorWidthHalf() const
+{
+	return _preferredVectorWidth[6];
+}
+
+/*! \brief Returns the size of the device address space in bits. */
+size_t ocl::DeviceInfo::addressBits() const
+{
+	return _addressBits;
+}
+
+/*! \brief Returns the alignment of memory objects in bits. */
+size_t ocl::DeviceInfo::memBaseAddrAlign() const
+{
+	return _memBaseAddrAlign;
+}
+
+/*! \brief Returns the maximum size in bytes of a memory object allocation. */
+size_t ocl::DeviceInfo::maxMemAllocSize() const
+{
+	return _maxMemAllocSize;
+}
+
+/*! \brief Returns the size of the global memory in bytes. */
+size_t ocl::DeviceInfo::globalMemSize() const
+{
+	return _globalMemSize;
+}
+
+/*! \brief Returns the size of the global memory cache in bytes. */
+size_t ocl::DeviceInfo::globalMemCacheSize() const
+{
+	return _globalMemCacheSize;
+}
+
+/*! \brief Returns the size of a global memory cache line in bytes. */
+size_t ocl::DeviceInfo::globalMemCachelineSize() const
+{
+	return _globalMemCachelineSize;
+}
+
+/*! \brief Returns the type of the global memory cache. */
+cl_device_mem_cache_type ocl::DeviceInfo::globalMemCacheType() const
+{
+	return _globalMemCacheType;
+}
+
+/*! \brief Returns the size of the local memory in bytes. */
+size_t ocl::DeviceInfo::localMemSize() const
+{
+	return _localMemSize;
+}
+
+/*! \brief Returns the type of the local memory. */
+cl_device_local_mem_type ocl::DeviceInfo::localMemType() const
+{
+	return _localMemType;
+}
+
+/*! \brief Returns the maximum size in bytes of a constant buffer. */
+size_t ocl::DeviceInfo::maxConstantBufferSize() const
+{
+	return _maxConstantBufferSize;
+}
+
+/*! \brief Returns the maximum number of constant kernel arguments. */
+size_t ocl::DeviceInfo::maxConstantArgs() const
+{
+	return _maxConstantArgs;
+}
+
+/*! \brief Returns true if the device and the host share a unified memory. */
+bool ocl::DeviceInfo::hostUnifiedMemory() const
+{
+	return _hostUnifiedMemory;
+}
+
+/*! \brief Returns true if the device corrects memory errors. */
+bool ocl::DeviceInfo::errorCorrectionSupport() const
+{
+	return _errorCorrectionSupport;
+}
+
+/*! \brief Returns true if the device supports images. */
+bool ocl::DeviceInfo::imageSupport() const
+{
+	return _imageSupport;
+}
+
+/*! \brief Returns the maximum number of image arguments which are read. */
+size_t ocl::DeviceInfo::maxReadImageArgs() const
+{
+	return _maxReadImageArgs;
+}
+
+/*! \brief Returns the maximum number of image arguments which are written. */
+size_t ocl::DeviceInfo::maxWriteImageArgs() const
+{
+	return _maxWriteImageArgs;
+}
+
+/*! \brief Returns the maximum number of samplers within a kernel. */
+size_t ocl::DeviceInfo::maxSamplers() const
+{
+	return _maxSamplers;
+}
+
+/*! \brief Returns the maximum width of a 2D image in pixels. */
+size_t ocl::DeviceInfo::image2dMaxWidth() const
+{
+	return _image2dMaxSize[0];
+}
+
+/*! \brief Returns the maximum height of a 2D image in pixels. */
+size_t ocl::DeviceInfo::image2dMaxHeight() const
+{
+	return _image2dMaxSize[1];
+}
+
+/*! \brief Returns the maximum width of a 3D image in pixels. */
+size_t ocl::DeviceInfo::image3dMaxWidth() const
+{
+	return _image3dMaxSize[0];
+}
+
+/*! \brief Returns the maximum height of a 3D image in pixels. */
+size_t ocl::DeviceInfo::image3dMaxHeight() const
+{
+	return _image3dMaxSize[1];
+}
+
+/*! \brief Returns the maximum depth of a 3D image in pixels. */
+size_t ocl::DeviceInfo::image3dMaxDepth() const
+{
+	return _image3dMaxSize[2];
+}
+
+/*! \brief Returns the maximum number of pixels of an image created from a buffer. */
+size_t ocl::DeviceInfo::imageMaxBufferSize() const
+{
+	return _imageMaxBufferSize;
+}
+
+/*! \brief Returns the row pitch alignment in pixels of an image created from a buffer. */
+size_t ocl::DeviceInfo::imagePitchAlignment() const
+{
+	return _imagePitchAlignment;
+}
+
+/*! \brief Returns the floating-point capabilities for float. */
+cl_device_fp_config ocl::DeviceInfo::singleFpConfig() const
+{
+	return _singleFpConfig;
+}
+
+/*! \brief Returns the floating-point capabilities for double or zero. */
+cl_device_fp_config ocl::DeviceInfo::doubleFpConfig() const
+{
+	return _doubleFpConfig;
+}
+
+/*! \brief Returns the execution capabilities. */
+cl_device_exec_capabilities ocl::DeviceInfo::executionCapabilities() const
+{
+	return _executionCapabilities;
+}
+
+/*! \brief Returns the command queue properties supported on the host. */
+cl_command_queue_properties ocl::DeviceInfo::queueProperties() const
+{
+	return _queueProperties;
+}
+
+/*! \brief Returns the shared virtual memory capabilities or zero. */
+cl_bitfield ocl::DeviceInfo::svmCapabilities() const
+{
+	return _svmCapabilities;
+}
+
+/*! \brief Returns the resolution of the device timer in nanoseconds. */
+size_t ocl::DeviceInfo::profilingTimerResolution() const
+{
+	return _profilingTimerResolution;
+}
+
+/*! \brief Returns true if the device is little endian. */
+bool ocl::DeviceInfo::endianLittle() const
+{
+	return _endianLittle;
+}
+
+/*! \brief Returns true if the device is available. */
+bool ocl::DeviceInfo::available() const
+{
+	return _available;
+}
+
+/*! \brief Returns true if the device has a compiler. */
+bool ocl::DeviceInfo::compilerAvailable() const
+{
+	return _compilerAvailable;
+}
+
+/*! \brief Returns true if the device has a linker. */
+bool ocl::DeviceInfo::linkerAvailable() const
+{
+	return _linkerAvailable;
+}
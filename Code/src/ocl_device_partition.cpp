@@ -0,0 +1,155 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <stdexcept>
+
+#include <ocl_device_partition.h>
+#include <ocl_context.h>
+#include <ocl_memory.h>
+#include <ocl_query.h>
+
+
+/*! \brief Instantiates this DevicePartition by partitioning the Device along the affinity domain.
+  *
+  * The Device itself is used if it cannot be partitioned along the affinity domain.
+  *
+  * \param device is the Device which is partitioned, e.g. a CPU spanning several sockets.
+  * \param domain is the affinity domain, e.g. Device::Numa or Device::L3Cache.
+  * \param properties are the properties of each Queue.
+  */
+ocl::DevicePartition::DevicePartition(const Device &device, Device::AffinityDomain domain, Queue::props properties) :
+	_device(device), _devices(), _context(), _queues()
+{
+	if(device.supportsAffinityDomain(domain))
+		_devices = device.partitionByAffinity(domain);
+	this->create(properties);
+}
+
+/*! \brief Instantiates this DevicePartition by partitioning the Device into sub-devices with the numbers of compute units.
+  *
+  * \param device is the Device which is partitioned.
+  * \param computeUnits contains the number of compute units for each sub-device.
+  * \param properties are the properties of each Queue.
+  */
+ocl::DevicePartition::DevicePartition(const Device &device, const std::vector<size_t> &computeUnits, Queue::props properties) :
+	_device(device), _devices(device.partitionByCounts(computeUnits)), _context(), _queues()
+{
+	this->create(properties);
+}
+
+/*! \brief Destructs this DevicePartition.
+  *
+  * Waits until all commands of its Queue objects are completed.
+  * The Queue objects are released before the Context and the sub-devices.
+  */
+ocl::DevicePartition::~DevicePartition()
+{
+	this->finish();
+}
+
+/*! \brief Creates the Context and one Queue for each sub-device. */
+void ocl::DevicePartition::create(Queue::props properties)
+{
+	if(_devices.empty()) _devices.push_back(_device);
+	_context.reset( new Context(_devices) );
+	for(const auto &device : _devices)
+		_queues.emplace_back( new Queue(*_context, device, properties) );
+}
+
+/*! \brief Returns the number of sub-devices. */
+size_t ocl::DevicePartition::size() const
+{
+	return _devices.size();
+}
+
+/*! \brief Returns true if the Device has been partitioned into sub-devices. */
+bool ocl::DevicePartition::isPartitioned() const
+{
+	return _devices.front() != _device;
+}
+
+/*! \brief Returns the partitioned Device. */
+const ocl::Device& ocl::DevicePartition::device() const
+{
+	return _device;
+}
+
+/*! \brief Returns the sub-device at the position. */
+const ocl::Device& ocl::DevicePartition::device(size_t pos) const
+{
+	if(pos >= _devices.size()) throw std::out_of_range("sub-device position out of range");
+	return _devices[pos];
+}
+
+/*! \brief Returns all sub-devices. */
+const std::vector<ocl::Device>& ocl::DevicePartition::devices() const
+{
+	return _devices;
+}
+
+/*! \brief Returns the Queue of the sub-device at the position.
+  *
+  * Commands of the Queue only execute on the compute units of the sub-device.
+  */
+ocl::Queue& ocl::DevicePartition::queue(size_t pos) const
+{
+	if(pos >= _queues.size()) throw std::out_of_range("sub-device position out of range");
+	return *_queues[pos];
+}
+
+/*! \brief Returns the Context of all sub-devices. */
+ocl::Context& ocl::DevicePartition::context() const
+{
+	return *_context;
+}
+
+/*! \brief Migrates the Memory to the sub-device at the position.
+  *
+  * The Memory must have been created with context(). Pin input Memory objects
+  * before their first use so that the Kernel executions of the sub-device
+  * are likely to access the memory of their own NUMA node. The migration is
+  * only a placement hint, see Memory::migrate.
+  *
+  * \param memory is a Buffer or Image which is migrated.
+  * \param pos is the position of the sub-device.
+  * \param discard is true if the content of the Memory need not be preserved, e.g. for output Memory.
+  */
+void ocl::DevicePartition::pin(const Memory &memory, size_t pos, bool discard) const
+{
+	memory.migrate(this->queue(pos), discard);
+}
+
+/*! \brief Migrates the Memory asynchronously to the sub-device at the position.
+  *
+  * \param memory is a Buffer or Image which is migrated.
+  * \param pos is the position of the sub-device.
+  * \param discard is true if the content of the Memory need not be preserved, e.g. for output Memory.
+  * \param list contains all events for which this command has to wait.
+  * \return event which can be integrated into other EventList.
+  */
+ocl::Event ocl::DevicePartition::pinAsync(const Memory &memory, size_t pos, bool discard, const EventList &list) const
+{
+	return memory.migrateAsync(this->queue(pos), discard, list);
+}
+
+/*! \brief Waits until all commands of all Queue objects are completed. */
+void ocl::DevicePartition::finish() const
+{
+	for(const auto &queue : _queues)
+		queue->finish();
+}
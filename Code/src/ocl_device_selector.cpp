@@ -0,0 +1,260 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#include <ocl_device_selector.h>
+#include <ocl_buffer.h>
+#include <ocl_context.h>
+#include <ocl_device_info.h>
+#include <ocl_event.h>
+#include <ocl_kernel.h>
+#include <ocl_program.h>
+#include <ocl_query.h>
+#include <ocl_queue.h>
+
+
+namespace kernel_strings {
+
+const std::string benchmark =
+R"(
+
+__kernel void copy(__global const float4 *a, __global float4 *b)
+{
+    const size_t i = get_global_id(0);
+    b[i] = a[i];
+}
+
+__kernel void flops(__global float *a, float b)
+{
+    float x = a[get_global_id(0)], y = 1.0f - x;
+    for(int i = 0; i < 64; ++i){
+        x = mad(x, b, y); y = mad(y, b, x);
+        x = mad(x, b, y); y = mad(y, b, x);
+        x = mad(x, b, y); y = mad(y, b, x);
+        x = mad(x, b, y); y = mad(y, b, x);
+    }
+    a[get_global_id(0)] = x + y;
+}
+
+)";
+
+}
+
+
+/*! \brief Instantiates this DeviceSelector.
+  *
+  * The compute throughput, the bandwidth and double precision support are
+  * weighted equally, the global memory size by one half.
+  *
+  * \param policy determines how the performance of a Device is obtained.
+  */
+ocl::DeviceSelector::DeviceSelector(Policy policy) :
+	_policy(policy), _compute(1.0), _bandwidth(1.0), _memory(0.5), _doubles(1.0)
+{
+}
+
+/*! \brief Sets the policy by which the performance of a Device is obtained. */
+void ocl::DeviceSelector::setPolicy(Policy policy)
+{
+	_policy = policy;
+}
+
+/*! \brief Returns the policy by which the performance of a Device is obtained. */
+ocl::DeviceSelector::Policy ocl::DeviceSelector::policy() const
+{
+	return _policy;
+}
+
+/*! \brief Sets the weights of the score.
+  *
+  * The Capabilities policy does not estimate the bandwidth, so that the bandwidth
+  * weight has no effect and scores obtained with different policies cannot be compared.
+  *
+  * \param compute is the weight of the logarithm of the GFLOP/s.
+  * \param bandwidth is the weight of the logarithm of the bandwidth in GB/s.
+  * \param memory is the weight of the logarithm of the global memory size in GB.
+  * \param doubles is added to the score if the Device supports double precision.
+  */
+void ocl::DeviceSelector::setWeights(double compute, double bandwidth, double memory, double doubles)
+{
+	if(compute < 0 || bandwidth < 0 || memory < 0 || doubles < 0) throw std::runtime_error("weights must not be negative");
+	_compute = compute;
+	_bandwidth = bandwidth;
+	_memory = memory;
+	_doubles = doubles;
+}
+
+/*! \brief Returns the performance of the Device according to the policy. */
+ocl::DeviceSelector::Measurement ocl::DeviceSelector::measurement(const Device &device) const
+{
+	return _policy == Benchmark ? benchmark(device) : estimate(device);
+}
+
+/*! \brief Returns the score of the Device.
+  *
+  * The higher the score, the faster the Device is expected to be.
+  */
+double ocl::DeviceSelector::score(const Device &device) const
+{
+	const Measurement m = this->measurement(device);
+	const double memory = double(device.globalMemSize()) / double(1 << 30);
+	return _compute   * std::log2(1.0 + m.gflops)
+	     + _bandwidth * std::log2(1.0 + m.bandwidth)
+	     + _memory    * std::log2(1.0 + memory)
+	     + (device.doubleSupport() ? _doubles : 0.0);
+}
+
+/*! \brief Returns the Device objects ordered by their score, the best first.
+  *
+  * Device objects with the same score keep their order.
+  */
+std::vector<ocl::Device> ocl::DeviceSelector::rank(const std::vector<Device> &devices) const
+{
+	std::vector< std::pair<double, size_t> > scores;
+	scores.reserve(devices.size());
+	for(size_t i = 0; i < devices.size(); ++i)
+		scores.emplace_back(this->score(devices[i]), i);
+	std::stable_sort(scores.begin(), scores.end(),
+	                 [](const std::pair<double, size_t> &a, const std::pair<double, size_t> &b){ return a.first > b.first; });
+
+	std::vector<Device> ranked;
+	ranked.reserve(devices.size());
+	for(const auto &s : scores) ranked.push_back(devices[s.second]);
+	return ranked;
+}
+
+/*! \brief Returns the Device objects of all platforms with the DeviceType ordered by their score, the best first.
+  *
+  * \param type of the Device objects. All Device objects are ranked for device_type::ALL.
+  */
+std::vector<ocl::Device> ocl::DeviceSelector::rank(const DeviceType &type) const
+{
+	std::vector<Device> devices;
+	for(cl_platform_id platform : ocl::platforms()){
+		for(cl_device_id id : ocl::devices(platform)){
+			Device device(id);
+			if(type == ocl::device_type::ALL || device == type)
+				devices.push_back(device);
+		}
+	}
+	return this->rank(devices);
+}
+
+/*! \brief Returns the Device of all platforms with the DeviceType and the highest score.
+  *
+  * \param type of the Device. All Device objects are considered for device_type::ALL.
+  */
+ocl::Device ocl::DeviceSelector::best(const DeviceType &type) const
+{
+	const std::vector<Device> ranked = this->rank(type);
+	if(ranked.empty()) throw std::runtime_error("no device available");
+	return ranked.front();
+}
+
+/*! \brief Estimates the performance of the Device from its capabilities.
+  *
+  * Each compute unit is assumed to execute one multiply-add per lane and cycle.
+  * A GPU compute unit has gpu_lanes_per_compute_unit lanes, the lanes of other Device objects
+  * correspond to the preferred vector width for floats. The bandwidth is not estimated.
+  */
+ocl::DeviceSelector::Measurement ocl::DeviceSelector::estimate(const Device &device)
+{
+	const DeviceInfo &info = device.info();
+	const size_t lanes = device.isGpu() ? size_t(gpu_lanes_per_compute_unit) : std::max<size_t>(1, info.preferredVectorWidthFloat());
+	Measurement m;
+	m.gflops = double(info.maxComputeUnits()) * double(info.maxClockFrequency()) * 1e-3 * 2.0 * double(lanes);
+	m.bandwidth = 0.0;
+	return m;
+}
+
+/*! \brief Measures the performance of the Device with a short micro-benchmark.
+  *
+  * A copy kernel measures the bandwidth and a multiply-add kernel the compute
+  * throughput. The best of three runs is taken. The benchmark runs once for
+  * each OpenCL device, further calls return the cached measurement.
+  * If the benchmark fails on the Device, e.g. because the kernels cannot be built,
+  * the estimate() is returned and cached instead.
+  */
+ocl::DeviceSelector::Measurement ocl::DeviceSelector::benchmark(const Device &device)
+{
+	static std::mutex mutex;
+	static std::map<cl_device_id, Measurement> cache;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	const auto it = cache.find(device.id());
+	if(it != cache.end()) return it->second;
+
+	Measurement m;
+	try{
+		m = run(device);
+	}
+	catch(const std::exception&){
+		m = estimate(device);
+	}
+	cache[device.id()] = m;
+	return m;
+}
+
+/*! \brief Runs the micro-benchmark of benchmark() on the Device. */
+ocl::DeviceSelector::Measurement ocl::DeviceSelector::run(const Device &device)
+{
+	const size_t local = std::min<size_t>(64, device.maxWorkGroupSize());
+	const size_t bytes = std::min<size_t>(size_t(64) << 20, device.maxMemAllocSize() / 2);
+	const size_t vectors = std::max<size_t>(1, bytes / (4 * sizeof(float)) / local) * local;
+	const size_t items = local * device.maxComputeUnits() * 64;
+
+	Context context(device);
+	Queue queue(context, device, CL_QUEUE_PROFILING_ENABLE);
+	Program program(context);
+	program << kernel_strings::benchmark;
+	program.build();
+
+	Buffer a(context, vectors * 4 * sizeof(float)), b(context, std::max(vectors * 4, items) * sizeof(float));
+	Kernel &copy = program.kernel("copy");
+	Kernel &flops = program.kernel("flops");
+	copy.setWorkSize(local, vectors);
+	flops.setWorkSize(local, items);
+
+	// seconds of the fastest of three runs.
+	auto fastest = [&queue](const std::function<Event()> &run){
+		double seconds = 0;
+		run().waitUntilCompleted();
+		for(int r = 0; r < 3; ++r){
+			Event event = run();
+			event.waitUntilCompleted();
+			const double s = double(event.finishTime() - event.startTime()) * 1e-9;
+			if(r == 0 || s < seconds) seconds = s;
+		}
+		queue.finish();
+		return seconds;
+	};
+
+	const double copySeconds = fastest([&]{ return copy(queue, a.id(), b.id()); });
+	const double flopsSeconds = fastest([&]{ return flops(queue, b.id(), 0.5f); });
+
+	Measurement m;
+	m.bandwidth = copySeconds > 0 ? 2.0 * double(vectors * 4 * sizeof(float)) / copySeconds * 1e-9 : 0.0;
+	m.gflops    = flopsSeconds > 0 ? double(items) * 64 * 8 * 2 / flopsSeconds* 1e-9 : estimate(device).gflops;
+	return m;
+}
@@ -20,6 +20,7 @@
 
 #include <ocl_platform.h>
 #include <ocl_context.h>
+#include <ocl_completion_queue.h>
 
 /*! \brief Instantiates an Event returned by an command Queue instruction.
   *
@@ -27,15 +28,19 @@
   *
   * \param id is an OpenCL event id provided by the creating command Queue instruction.
   * \param ctxt is a valid Context provided which is the same as the command queue Context.
+  *
+  * The Context of the OpenCL event is only compared if OCL_CHECKED is 1.
   */
 ocl::Event::Event(cl_event id, ocl::Context* ctxt) : _id(id), _ctxt(ctxt)
 {
-	if(this->_id   == nullptr) throw std::runtime_error("Event not valid");
-	if(this->_ctxt == nullptr) throw std::runtime_error("Context not valid");
+	OCL_ASSERT(this->_id   != nullptr, "Event not valid");
+	OCL_ASSERT(this->_ctxt != nullptr, "Context not valid");
 
+#if OCL_CHECKED
     cl_context cl_ctxt = 0;
     OPENCL_SAFE_CALL( clGetEventInfo (this->id(), CL_EVENT_CONTEXT , sizeof(cl_ctxt), &cl_ctxt, NULL));
-	if(_ctxt->id() != cl_ctxt) throw std::runtime_error("Contexts must be the same");
+	OCL_ASSERT(_ctxt->id() == cl_ctxt, "Contexts must be the same");
+#endif
 }
 
 
@@ -258,6 +263,84 @@ void ocl::Event::waitUntilCompleted() const
 	OPENCL_SAFE_CALL( clSetUserEventStatus (this->id(), CL_COMPLETE) );
 }
 
+/*! \brief Calls the callback on the thread of the CompletionQueue when the command of this Event has completed.
+  *
+  * The callback receives CL_COMPLETE or a negative error code if the command
+  * terminated abnormally. This Event is retained until the callback has been executed.
+  */
+void ocl::Event::onComplete(std::function<void(cl_int)> callback) const
+{
+	onComplete(this->_id, std::move(callback));
+}
+
+/*! \brief Calls the callback on the thread of the CompletionQueue when the command of the OpenCL event has completed.
+  *
+  * See onComplete(std::function<void(cl_int)>). The OpenCL event is retained
+  * until the callback has been executed.
+  */
+void ocl::Event::onComplete(cl_event id, std::function<void(cl_int)> callback)
+{
+	if(id == nullptr) throw std::runtime_error("id not valid");
+	std::unique_ptr< std::function<void(cl_int)> > data(new std::function<void(cl_int)>(std::move(callback)));
+	OPENCL_SAFE_CALL( clRetainEvent(id) );
+	const cl_int status = clSetEventCallback(id, CL_COMPLETE, &Event::complete, data.get());
+	if(status != CL_SUCCESS) clReleaseEvent(id);
+	OPENCL_SAFE_CALL( status );
+	data.release();
+}
+
+/*! \brief Calls the function on the thread of the CompletionQueue when the command of this Event has completed.
+  *
+  * The function is not called if the command terminated abnormally.
+  * \returns a future which becomes ready after the function has returned
+  * and which holds the exception thrown by the function or the error of the command.
+  */
+std::future<void> ocl::Event::then(std::function<void()> function) const
+{
+	auto promise = std::make_shared< std::promise<void> >();
+	std::future<void> future = promise->get_future();
+	this->onComplete([promise, function](cl_int status){
+		try{
+			OPENCL_SAFE_CALL( status < 0 ? status : CL_SUCCESS );
+			if(function) function();
+			promise->set_value();
+		}
+		catch(...){
+			promise->set_exception(std::current_exception());
+		}
+	});
+	return future;
+}
+
+/*! \brief Returns a future which becomes ready when the command of this Event has completed.
+  *
+  * The future holds an exception if the command terminated abnormally.
+  */
+std::future<void> ocl::Event::future() const
+{
+	return this->then(std::function<void()>());
+}
+
+/*! \brief Posts the callback of the Event to the CompletionQueue.
+  *
+  * Called by the OpenCL driver. The callback is dropped if the CompletionQueue
+  * has been shut down.
+  */
+void CL_CALLBACK ocl::Event::complete(cl_event id, cl_int status, void *data)
+{
+	std::function<void(cl_int)> *callback = static_cast< std::function<void(cl_int)>* >(data);
+	const bool posted = ocl::CompletionQueue::instance().post([id, status, callback]{
+		std::unique_ptr< std::function<void(cl_int)> > owner(callback);
+		clReleaseEvent(id);
+		(*owner)(status);
+	});
+	// Callbacks completing after program exit are dropped.
+	if(!posted){
+		delete callback;
+		clReleaseEvent(id);
+	}
+}
+
 /*! \brief Returns true if both Event s have the same OpenCL Event.*/
 bool ocl::Event::operator!= ( const Event & other ) const
 {
@@ -25,7 +25,7 @@
 
 /*! \brief Instantiates an EventList. */
 ocl::EventList::EventList () :
-    _events(), _ctxt(0)
+    _inline(), _heap(), _size(0), _ctxt(0)
 {
 }
 
@@ -34,9 +34,9 @@ ocl::EventList::EventList () :
   * \param event is an Event inserted the list.
   */
 ocl::EventList::EventList ( const ocl::Event & event ) :
-    _events(1,&event), _ctxt(&event.context())
+    _inline(), _heap(), _size(0), _ctxt(0)
 {
-	if(this->_ctxt == nullptr) throw std::runtime_error("context not valid");
+    this->append(event);
 }
 
 /*! \brief Instantiates an EventList.
@@ -44,29 +44,46 @@ ocl::EventList::EventList ( const ocl::Event & event ) :
   * \param other is an EventList inserted the list.
   */
 ocl::EventList::EventList ( const EventList & other ) :
-    _events(other._events), _ctxt(0)
+    _inline(), _heap(), _size(0), _ctxt(other._ctxt)
+{
+    for(size_t i = 0; i < other._size; ++i)
+        this->append(other.data()[i]);
+}
+
+/*! \brief Instantiates an EventList with the events of other.
+  *
+  * \param other is left empty.
+  */
+ocl::EventList::EventList ( EventList && other ) :
+    _inline(), _heap(std::move(other._heap)), _size(other._size), _ctxt(other._ctxt)
+{
+    std::copy(other._inline, other._inline + inline_capacity, _inline);
+    other._heap.clear();
+    other._size = 0;
+    other._ctxt = 0;
+}
+
+/*! \brief Destructs this EventList and releases its events. */
+ocl::EventList::~EventList ()
 {
-    const ocl::Event *efirst = _events.front();
-    _ctxt = &efirst->context();
-	if(this->_ctxt == nullptr) throw std::runtime_error("context not valid");
+    this->clear();
 }
 
 /*! \brief Appends an Event to this EventList.
   *
   * Context of the Event and EventList must be the same.
+  * The OpenCL event is retained so that the Event may go out of scope.
   *
   * \param event to be inserted into the EventList.
-  *
-  * \warning The event object must still be in scope!!!!
   */
 void ocl::EventList::append ( const ocl::Event & event )
 {
-    if(this->_events.empty()) {
+    if(event.id() == nullptr) throw std::runtime_error("event not valid");
+    if(this->_size == 0)
         _ctxt = &event.context();
-		if(this->_ctxt == nullptr) throw std::runtime_error("context not valid");
-    }
-    this->_events.push_back(&event);
-
+    else if(*this->_ctxt != event.context())
+        throw std::runtime_error("context not valid");
+    this->append(event.id());
 }
 
 /*! \brief Appends an EventList to this EventList.
@@ -77,44 +94,90 @@ void ocl::EventList::append ( const ocl::Event & event )
   */
 void ocl::EventList::append ( const ocl::EventList & other )
 {
-    for(auto it = other._events.begin(); it != other._events.end(); ++it)
-    {
-        const ocl::Event *e = *it;
-		if(*this->_ctxt != e->context()) throw std::runtime_error("context not valid");
+    if(other._size == 0) return;
+    if(this->_size == 0)
+        _ctxt = other._ctxt;
+    else if(*this->_ctxt != *other._ctxt)
+        throw std::runtime_error("context not valid");
+    const size_t n = other._size;
+    for(size_t i = 0; i < n; ++i)
+        this->append(other.data()[i]);
+}
+
+/*! \brief Retains and appends the OpenCL event.
+  *
+  * The events are moved to the heap once the inline storage is full.
+  */
+void ocl::EventList::append ( cl_event id )
+{
+    OPENCL_SAFE_CALL( clRetainEvent(id) );
+    if(this->_heap.empty() && this->_size < inline_capacity){
+        this->_inline[this->_size++] = id;
+        return;
+    }
+    if(this->_heap.empty()){
+        this->_heap.reserve(2 * inline_capacity);
+        this->_heap.assign(this->_inline, this->_inline + this->_size);
     }
-    this->_events.insert(this->_events.end(), other._events.begin(), other._events.end());
+    this->_heap.push_back(id);
+    ++this->_size;
+}
+
+/*! \brief Returns the storage of the events. */
+cl_event* ocl::EventList::begin ()
+{
+    return this->_heap.empty() ? this->_inline : this->_heap.data();
 }
 
 /*! \brief Returns the specified Event. */
-const ocl::Event& ocl::EventList::at ( size_t index ) const
+ocl::Event ocl::EventList::at ( size_t index ) const
 {
-    return *this->_events.at(index);
+    if(index >= this->_size) throw std::out_of_range("EventList index out of range");
+    const cl_event id = this->data()[index];
+    OPENCL_SAFE_CALL( clRetainEvent(id) );
+    return ocl::Event(id, this->_ctxt);
 }
 
 /*! \brief Returns true if the specified Event is within this EventList. */
 bool ocl::EventList::contains ( const ocl::Event & event ) const
 {
-    return (std::find(this->_events.begin(), this->_events.end(), &event) != this->_events.end());
+    const cl_event *first = this->data();
+    return this->_size > 0 && std::find(first, first + this->_size, event.id()) != first + this->_size;
 }
 
 /*! \brief Returns true if this EventList is empty. */
 bool ocl::EventList::isEmpty () const
 {
-    return this->_events.empty();
+    return this->_size == 0;
 }
 
-/*! \brief Returns the specified Event from this EventList. */
+/*! \brief Removes the specified Event from this EventList. */
 void ocl::EventList::remove ( const ocl::Event & event)
 {
-    auto it = std::find(this->_events.begin(), this->_events.end(), &event);
-    if(it == this->_events.end()) return;
-    this->_events.erase(it);
+    cl_event *first = this->begin();
+    cl_event *it = std::find(first, first + this->_size, event.id());
+    if(it == first + this->_size) return;
+    OPENCL_SAFE_CALL( clReleaseEvent(*it) );
+    std::copy(it + 1, first + this->_size, it);
+    --this->_size;
+    if(!this->_heap.empty()) this->_heap.pop_back();
 }
 
 /*! \brief Returns the number of Event objects within this EventList. */
 size_t ocl::EventList::size () const
 {
-    return this->_events.size();
+    return this->_size;
+}
+
+/*! \brief Removes and releases all events of this EventList. */
+void ocl::EventList::clear ()
+{
+    const cl_event *first = this->data();
+    for(size_t i = 0; i < this->_size; ++i)
+        clReleaseEvent(first[i]);
+    this->_heap.clear();
+    this->_size = 0;
+    this->_ctxt = 0;
 }
 
 /*! \brief Returns the Context of this EventList.
@@ -125,14 +188,34 @@ size_t ocl::EventList::size () const
   */
 ocl::Context& ocl::EventList::context() const
 {
+    if(this->_ctxt == nullptr) throw std::runtime_error("context not valid");
     return *this->_ctxt;
 }
 
+/*! \brief Returns the contiguous OpenCL events of this EventList or null if it is empty.
+  *
+  * Can be passed as event wait list to OpenCL together with size().
+  */
+const cl_event* ocl::EventList::data() const
+{
+    if(this->_size == 0) return nullptr;
+    return this->_heap.empty() ? this->_inline : this->_heap.data();
+}
+
 /*! \brief Waits until all Event objects within this EventList are completed. */
 void ocl::EventList::waitUntilCompleted() const
 {
-    for(const ocl::Event *event : this->_events)
-        event->waitUntilCompleted();
+    if(this->_size == 0) return;
+    OPENCL_SAFE_CALL( clWaitForEvents(this->_size, this->data()) );
+}
+
+/*! \brief Returns a future which becomes ready when all Event objects within this EventList are completed.
+  *
+  * See when_all(const EventList&).
+  */
+std::future<void> ocl::EventList::future() const
+{
+    return ocl::when_all(*this);
 }
 
 /*! \brief Appends the Event into this EventList.
@@ -155,26 +238,100 @@ ocl::EventList & ocl::EventList::operator<< ( const EventList & other )
 	return *this;
 }
 
-/*! \brief Appends the Event into this EventList.
+/*! \brief Replaces the events of this EventList by those of other.
   *
   * \returns this EventList
   */
 ocl::EventList & ocl::EventList::operator= ( const EventList & other )
 {
-    _ctxt = other._ctxt;
-    this->_events.assign(other._events.begin(), other._events.end());
-	return *this;
+    if(this == &other) return *this;
+    EventList copy(other);
+    return *this = std::move(copy);
+}
+
+/*! \brief Replaces the events of this EventList by those of other.
+  *
+  * \returns this EventList
+  */
+ocl::EventList & ocl::EventList::operator= ( EventList && other )
+{
+    if(this == &other) return *this;
+    this->clear();
+    std::copy(other._inline, other._inline + inline_capacity, this->_inline);
+    this->_heap = std::move(other._heap);
+    this->_size = other._size;
+    this->_ctxt = other._ctxt;
+    other._heap.clear();
+    other._size = 0;
+    other._ctxt = 0;
+    return *this;
 }
 
-/*! \brief Returns the EventList with OpenCL events
+/*! \brief Returns a copy of the OpenCL events of this EventList
   *
-  * \returns this EventList with OpenCL events
+  * Use data() in order to pass the events to OpenCL without copying.
   */
 std::vector<cl_event> ocl::EventList::events() const
 {
-    std::vector<cl_event> e;
-    for(const ocl::Event *event : this->_events){
-        e.push_back(event->id());
+    const cl_event *first = this->data();
+    return std::vector<cl_event>(first, first + this->_size);
+}
+
+/*! \brief Returns a future which becomes ready when all Event objects of the list are completed.
+  *
+  * The future holds an exception if one of the commands terminated abnormally.
+  * The future of an empty list is ready immediately.
+  */
+std::future<void> ocl::when_all(const EventList &list)
+{
+    auto promise = std::make_shared< std::promise<void> >();
+    std::future<void> future = promise->get_future();
+    if(list.isEmpty()) { promise->set_value(); return future; }
+
+    // All callbacks are executed on the thread of the CompletionQueue.
+    auto remaining = std::make_shared<size_t>(list.size());
+    auto done = std::make_shared<bool>(false);
+    for(size_t i = 0; i < list.size(); ++i){
+        list.at(i).onComplete([promise, remaining, done](cl_int status){
+            if(*done) return;
+            if(status < 0){
+                *done = true;
+                try{ OPENCL_SAFE_CALL( status ); }
+                catch(...){ promise->set_exception(std::current_exception()); }
+            }
+            else if(--*remaining == 0){
+                *done = true;
+                promise->set_value();
+            }
+        });
+    }
+    return future;
+}
+
+/*! \brief Returns a future which becomes ready when the first Event of the list is completed.
+  *
+  * The future holds the position of the Event within the list or
+  * an exception if its command terminated abnormally.
+  */
+std::future<size_t> ocl::when_any(const EventList &list)
+{
+    if(list.isEmpty()) throw std::runtime_error("EventList must not be empty");
+    auto promise = std::make_shared< std::promise<size_t> >();
+    std::future<size_t> future = promise->get_future();
+
+    auto done = std::make_shared<bool>(false);
+    for(size_t i = 0; i < list.size(); ++i){
+        list.at(i).onComplete([promise, done, i](cl_int status){
+            if(*done) return;
+            *done = true;
+            try{
+                OPENCL_SAFE_CALL( status < 0 ? status : CL_SUCCESS );
+                promise->set_value(i);
+            }
+            catch(...){
+                promise->set_exception(std::current_exception());
+            }
+        });
     }
-	return e;
+    return future;
 }
@@ -23,6 +23,7 @@
 #include <ocl_device.h>
 #include <ocl_queue.h>
 #include <ocl_image.h>
+#include <ocl_buffer.h>
 
 #include <cassert>
 
@@ -111,6 +112,42 @@ ocl::Image::Image(Context &ctxt, unsigned int texture, unsigned long texture_tar
 }
 
 
+/**
+ * \brief ocl::Image::Image Instantiates an 1D-Image over the memory of a Buffer.
+ *
+ * The Image is a view of the Buffer and no memory is allocated. See Image::create(const Buffer&, ChannelType, ChannelOrder, Access).
+ *
+ * \param ctxt Context of the Buffer.
+ * \param buffer Buffer whose memory is accessed by the Image.
+ * \param type Channeltype of the image.
+ * \param order Channelorder of the image.
+ */
+ocl::Image::Image(Context& ctxt, const Buffer &buffer, ChannelType type, ChannelOrder order, Access access)
+	:Memory(ctxt)
+{
+	this->create(buffer, type, order, access);
+}
+
+/**
+ * \brief ocl::Image::Image Instantiates a 2D-Image over the memory of a Buffer.
+ *
+ * The Image is a view of the Buffer and no memory is allocated. See Image::create(const Buffer&, size_t, size_t, size_t, ChannelType, ChannelOrder, Access).
+ *
+ * \param ctxt Context of the Buffer.
+ * \param buffer Buffer whose memory is accessed by the Image.
+ * \param width Width of the 2D-Image.
+ * \param height Height of the 2D-Image.
+ * \param row_pitch Bytes between the rows of the 2D-Image or zero for width times the pixel size.
+ * \param type Channeltype of the image.
+ * \param order Channelorder of the image.
+ */
+ocl::Image::Image(Context& ctxt, const Buffer &buffer, size_t width, size_t height, size_t row_pitch, ChannelType type, ChannelOrder order, Access access)
+	:Memory(ctxt)
+{
+	this->create(buffer, width, height, row_pitch, type, order, access);
+}
+
+
 /**
  * \brief ocl::Image::~Image Empty deconstructor.
  */
@@ -159,6 +196,9 @@ void ocl::Image::create(size_t width, size_t height, size_t depth, ImageType ima
 
 
 	cl_mem_flags flags = access;
+	if(!this->_ctxt->supportsImageFormat(format, image_type, flags))
+		throw std::runtime_error("image format not supported by the context");
+
 	cl_image_desc desc;
 	desc.image_type = image_type;
 	desc.image_height = height;
@@ -236,6 +276,178 @@ void ocl::Image::create(size_t length, ChannelType channel_type, ChannelOrder ch
 
 
 
+/**
+ * \brief ocl::Image::create Creates an 1D-Image over the whole memory of a Buffer.
+ *
+ * No memory is allocated and no data are copied. Kernels may read the data through
+ * an image1d_buffer_t with read_imagef and through a global pointer to the Buffer.
+ * The width is the size of the Buffer divided by the pixel size.
+ * The Buffer must not be released before this Image. Note that the DependencyTracker does
+ * not order commands on the Image after commands on the Buffer and vice versa.
+ *
+ * \param buffer Buffer in the Context of this Image.
+ * \param channel_type Channeltype of the image.
+ * \param order Channelorder of the image.
+ * \param access Access of the kernels to the image.
+ */
+void ocl::Image::create(const Buffer &buffer, ChannelType channel_type, ChannelOrder order, Access access)
+{
+	if(this->_ctxt == nullptr)
+		throw std::runtime_error("Context not valid");
+	if(buffer.context() != this->_ctxt)
+		throw std::runtime_error("context of the buffer and the image must be equal");
+
+	const size_t width = buffer.size_bytes() / pixelSize(channel_type, order);
+	if(width == 0)
+		throw std::runtime_error("buffer is smaller than one pixel");
+	for(const auto &device : this->_ctxt->devices()){
+		if(!device.supportsVersion(1, 2))
+			throw std::runtime_error("images from buffers require OpenCL 1.2");
+		if(width > device.info().imageMaxBufferSize())
+			throw std::runtime_error("Image1DBuffer cannot have width " + std::to_string(width));
+	}
+
+	cl_image_format format;
+	format.image_channel_order = order;
+	format.image_channel_data_type = channel_type;
+
+	cl_mem_flags flags = access;
+	if(!this->_ctxt->supportsImageFormat(format, Image1DBuffer, flags))
+		throw std::runtime_error("image format not supported by the context");
+
+	cl_image_desc desc = cl_image_desc();
+	desc.image_type = Image1DBuffer;
+	desc.image_width = width;
+	desc.image_height = 1;
+	desc.image_depth = 1;
+	desc.image_array_size = 1;
+	desc.buffer = buffer.id();
+
+	cl_int status;
+	this->_id = clCreateImage(this->_ctxt->id(), flags, &format, &desc, NULL, &status);
+	OPENCL_SAFE_CALL(status);
+	if(this->_id == nullptr)
+		throw std::runtime_error("Context not create 1D buffer image");
+}
+
+/**
+ * \brief ocl::Image::create Creates a 2D-Image over the memory of a Buffer.
+ *
+ * No memory is allocated and no data are copied. Kernels may read the data through
+ * an image2d_t with read_imagef and through a global pointer to the Buffer.
+ * Requires OpenCL 2.0. The row pitch must be a multiple of the pitch alignment of
+ * each Device in pixels, see DeviceInfo::imagePitchAlignment().
+ * The Buffer must not be released before this Image. Note that the DependencyTracker does
+ * not order commands on the Image after commands on the Buffer and vice versa.
+ *
+ * \param buffer Buffer in the Context of this Image.
+ * \param width Width of the image.
+ * \param height Height of the image.
+ * \param row_pitch Bytes between the rows of the image or zero for width times the pixel size.
+ * \param channel_type Channeltype of the image.
+ * \param order Channelorder of the image.
+ * \param access Access of the kernels to the image.
+ */
+void ocl::Image::create(const Buffer &buffer, size_t width, size_t height, size_t row_pitch, ChannelType channel_type, ChannelOrder order, Access access)
+{
+	if(this->_ctxt == nullptr)
+		throw std::runtime_error("Context not valid");
+	if(buffer.context() != this->_ctxt)
+		throw std::runtime_error("context of the buffer and the image must be equal");
+
+	const size_t pixel = pixelSize(channel_type, order);
+	if(row_pitch == 0) row_pitch = width * pixel;
+	if(width == 0 || height == 0)
+		throw std::runtime_error("Image2D cannot have width " + std::to_string(width) + " or height " + std::to_string(height));
+	if(row_pitch < width * pixel || row_pitch % pixel != 0)
+		throw std::runtime_error("row pitch " + std::to_string(row_pitch) + " is not valid");
+	if(row_pitch * height > buffer.size_bytes())
+		throw std::runtime_error("buffer is smaller than the image");
+	for(const auto &device : this->_ctxt->devices()){
+		if(!device.supportsVersion(2, 0))
+			throw std::runtime_error("2D images from buffers require OpenCL 2.0");
+		const size_t alignment = device.info().imagePitchAlignment();
+		if(alignment > 0 && (row_pitch / pixel) % alignment != 0)
+			throw std::runtime_error("row pitch must be a multiple of " + std::to_string(alignment) + " pixels");
+	}
+
+	cl_image_format format;
+	format.image_channel_order = order;
+	format.image_channel_data_type = channel_type;
+
+	cl_mem_flags flags = access;
+	if(!this->_ctxt->supportsImageFormat(format, Image2D, flags))
+		throw std::runtime_error("image format not supported by the context");
+
+	cl_image_desc desc = cl_image_desc();
+	desc.image_type = Image2D;
+	desc.image_width = width;
+	desc.image_height = height;
+	desc.image_depth = 1;
+	desc.image_array_size = 1;
+	desc.image_row_pitch = row_pitch;
+	desc.buffer = buffer.id();
+
+	cl_int status;
+	this->_id = clCreateImage(this->_ctxt->id(), flags, &format, &desc, NULL, &status);
+	OPENCL_SAFE_CALL(status);
+	if(this->_id == nullptr)
+		throw std::runtime_error("Context not create 2D image from buffer");
+}
+
+/**
+ * \brief ocl::Image::pixelSize Returns the size of a pixel in bytes.
+ *
+ * \param channel_type Channeltype of the image.
+ * \param order Channelorder of the image.
+ */
+size_t ocl::Image::pixelSize(ChannelType channel_type, ChannelOrder order)
+{
+	// packed formats store all channels of a pixel in one element.
+	switch(channel_type){
+		case UNormShort3: case UNormShort4: return 2;
+		case UNormInt4: return 4;
+		default: break;
+	}
+
+	size_t channels = 4;
+	switch(order){
+		case R: case A: case Intensity: case Luminance: channels = 1; break;
+		case RG: channels = 2; break;
+		case RGB: channels = 3; break;
+		case RGBA: case ARGB: channels = 4; break;
+	}
+
+	size_t bytes = 4;
+	switch(channel_type){
+		case SNormInt8: case UNormInt8: case SignedInt8: case UnsignedInt8: bytes = 1; break;
+		case HalfFloat: case SNormInt16: case UNormInt16: case SignedInt16: case UnsignedInt16: bytes = 2; break;
+		default: bytes = 4; break;
+	}
+	return channels * bytes;
+}
+
+
+/**
+ * \brief ocl::Image::supported Returns true if Image objects with the format can be created in the Context.
+ *
+ * The supported formats are queried once for each image type and access. See Context::imageFormats().
+ *
+ * \param ctxt Context in which the Image is created.
+ * \param image_type ImageType of the image.
+ * \param channel_type Channeltype of the image.
+ * \param order Channelorder of the image.
+ * \param access Access of the kernels to the image.
+ */
+bool ocl::Image::supported(const Context &ctxt, ImageType image_type, ChannelType channel_type, ChannelOrder order, Access access)
+{
+	cl_image_format format;
+	format.image_channel_order = order;
+	format.image_channel_data_type = channel_type;
+	return ctxt.supportsImageFormat(format, image_type, access);
+}
+
+
 /**
  * \brief ocl::Image::create Creates an OpenCL Image from an OpenGL texture.
  * \param texture OpenGL-ID of the texture.
@@ -288,11 +500,14 @@ void ocl::Image::recreate(size_t width, size_t height, ChannelType type, Channel
  */
 void ocl::Image::copyTo(size_t *src_origin, const size_t *region, const Image & dest, size_t *dest_origin, const EventList & list ) const
 {
-	if(this->id() == dest.id()) throw std::runtime_error("images ids must be equal");
-	if(this->context() != dest.context()) throw std::runtime_error("images contexts must be equal");
+	OCL_ASSERT(this->id() != dest.id(), "images ids must be equal");
+	OCL_ASSERT(this->context() == dest.context(), "images contexts must be equal");
 
-	OPENCL_SAFE_CALL( clEnqueueCopyImage(this->activeQueue().id(), this->id(), dest.id(), src_origin, dest_origin, region, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	const ocl::Queue &queue = this->activeQueue();
+	this->execute(list, Memory::ReadOnly, &dest, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueCopyImage(queue.id(), this->id(), dest.id(), src_origin, dest_origin, region, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /**
@@ -307,13 +522,19 @@ void ocl::Image::copyTo(size_t *src_origin, const size_t *region, const Image &
  */
 ocl::Event ocl::Image::copyToAsync(size_t *src_origin, const size_t *region, const Image &dest, size_t *dest_origin, const EventList &list)
 {
-	if(this->id() == dest.id()) throw std::runtime_error("images ids must be equal");
-	if(this->context() != dest.context()) throw std::runtime_error("images contexts must be equal");
+	OCL_ASSERT(this->id() != dest.id(), "images ids must be equal");
+	OCL_ASSERT(this->context() == dest.context(), "images contexts must be equal");
 	cl_event event_id;
-	OPENCL_SAFE_CALL( clEnqueueCopyImage(this->activeQueue().id(), this->id(), dest.id(),
-										 src_origin, dest_origin, region, list.size(),
-										 list.events().data(), &event_id) );
-	return ocl::Event(event_id, this->context());
+	const ocl::Queue &queue = this->activeQueue();
+	ocl::Event event = this->enqueue(list, Memory::ReadOnly, &dest, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL( clEnqueueCopyImage(queue.id(), this->id(), dest.id(),
+											 src_origin, dest_origin, region, events.size(),
+											 events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, region);
+	this->context()->track(queue, event);
+	return event;
 }
 
 
@@ -331,12 +552,14 @@ ocl::Event ocl::Image::copyToAsync(size_t *src_origin, const size_t *region, con
  */
 void ocl::Image::copyTo(const Queue &queue, size_t *src_origin, const size_t *region, const Image &dest, size_t *dest_origin, const EventList &list) const
 {
-	if(this->id() == dest.id()) throw std::runtime_error("images ids must be equal");
-	if(this->context() != dest.context()) throw std::runtime_error("images contexts must be equal");
-	if(queue.context() != *this->context()) throw std::runtime_error("context of queue and this must be equal");
+	OCL_ASSERT(this->id() != dest.id(), "images ids must be equal");
+	OCL_ASSERT(this->context() == dest.context(), "images contexts must be equal");
+	OCL_ASSERT(queue.context() == *this->context(), "context of queue and this must be equal");
 
-	OPENCL_SAFE_CALL( clEnqueueCopyImage(queue.id(), this->id(), dest.id(), src_origin, dest_origin, region, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	this->execute(list, Memory::ReadOnly, &dest, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueCopyImage(queue.id(), this->id(), dest.id(), src_origin, dest_origin, region, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /**
@@ -352,13 +575,17 @@ void ocl::Image::copyTo(const Queue &queue, size_t *src_origin, const size_t *re
  */
 ocl::Event ocl::Image::copyToAsync(const Queue &queue, size_t *src_origin, const size_t *region, const Image &dest, size_t *dest_origin, const EventList &list)
 {
-	if(this->context() != dest.context()) throw std::runtime_error("images contexts must be equal");
-	if(queue.context() != *this->context()) throw std::runtime_error("context of queue and this must be equal");
+	OCL_ASSERT(this->context() == dest.context(), "images contexts must be equal");
+	OCL_ASSERT(queue.context() == *this->context(), "context of queue and this must be equal");
 	cl_event event_id;
-	OPENCL_SAFE_CALL( clEnqueueCopyImage(queue.id(), this->id(), dest.id(),
-										 src_origin, dest_origin, region, list.size(),
-										 list.events().data(), &event_id) );
-	return ocl::Event(event_id, this->context());
+	ocl::Event event = this->enqueue(list, Memory::ReadOnly, &dest, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL( clEnqueueCopyImage(queue.id(), this->id(), dest.id(),
+											 src_origin, dest_origin, region, events.size(),
+											 events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, region);
+	return event;
 }
 
 /**
@@ -373,14 +600,18 @@ ocl::Event ocl::Image::copyToAsync(const Queue &queue, size_t *src_origin, const
  */
 void * ocl::Image::map(size_t *origin, const size_t *region, Memory::Access access) const
 {
-	if(!this->activeQueue().device().isCpu()) throw std::runtime_error("Device " + this->activeQueue().device().name() + " is not a cpu!");
+	const ocl::Queue &queue = this->activeQueue();
+	if(!queue.device().isCpu()) throw std::runtime_error("Device " + queue.device().name() + " is not a cpu!");
 	cl_int status;
 	cl_map_flags flags = access;
-	void *pointer = clEnqueueMapImage(this->activeQueue().id(), this->id(), CL_TRUE, flags,
-									  origin, region, 0, 0, 0, NULL, NULL, &status);
-	OPENCL_SAFE_CALL (status ) ;
-	if(pointer == nullptr) throw std::runtime_error("Could not map image!");
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	void *pointer = nullptr;
+	this->execute(ocl::EventList(), access, nullptr, [&](const ocl::EventList &events){
+		pointer = clEnqueueMapImage(queue.id(), this->id(), CL_TRUE, flags,
+										  origin, region, 0, 0, events.size(), events.data(), NULL, &status);
+		OPENCL_SAFE_CALL (status ) ;
+		if(pointer == nullptr) throw std::runtime_error("Could not map image!");
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 	return pointer;
 }
 
@@ -398,15 +629,21 @@ void * ocl::Image::map(size_t *origin, const size_t *region, Memory::Access acce
  */
 ocl::Event ocl::Image::mapAsync(void **ptr, size_t *origin, const size_t *region, Memory::Access access, const EventList &list) const
 {
-	if(!this->activeQueue().device().isCpu()) throw std::runtime_error("Device " + this->activeQueue().device().name() + " is not a cpu!");
+	const ocl::Queue &queue = this->activeQueue();
+	if(!queue.device().isCpu()) throw std::runtime_error("Device " + queue.device().name() + " is not a cpu!");
 	cl_int status;
 	cl_event event_id;
 	cl_map_flags flags = access;
-	*ptr = clEnqueueMapImage(this->activeQueue().id(), this->id(), CL_TRUE, flags,
-							 origin, region, 0, 0, list.size(), list.events().data(), &event_id, &status);
-	OPENCL_SAFE_CALL (status ) ;
-	if(ptr == nullptr) throw std::runtime_error("could not map image");
-	return ocl::Event(event_id, this->context());
+	ocl::Event event = this->enqueue(list, access, nullptr, [&](const ocl::EventList &events) -> ocl::Event {
+		*ptr = clEnqueueMapImage(queue.id(), this->id(), CL_TRUE, flags,
+								 origin, region, 0, 0, events.size(), events.data(), &event_id, &status);
+		OPENCL_SAFE_CALL (status ) ;
+		if(ptr == nullptr) throw std::runtime_error("could not map image");
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, region);
+	this->context()->track(queue, event);
+	return event;
 }
 
 
@@ -420,9 +657,12 @@ ocl::Event ocl::Image::mapAsync(void **ptr, size_t *origin, const size_t *region
  */
 void ocl::Image::read(size_t *origin,  void *ptr_to_host_data, const size_t *region, const EventList &list) const
 {
-	if(ptr_to_host_data == nullptr) throw std::runtime_error("data = nullptr");
-	OPENCL_SAFE_CALL( clEnqueueReadImage(this->activeQueue().id(), this->id(), CL_TRUE, origin, region, 0, 0, ptr_to_host_data, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	OCL_ASSERT(ptr_to_host_data != nullptr, "data = nullptr");
+	const ocl::Queue &queue = this->activeQueue();
+	this->execute(list, Memory::ReadOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueReadImage(queue.id(), this->id(), CL_TRUE, origin, region, 0, 0, ptr_to_host_data, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /**
@@ -434,10 +674,13 @@ void ocl::Image::read(size_t *origin,  void *ptr_to_host_data, const size_t *reg
  */
 void ocl::Image::read(void *ptr_to_host_data, const size_t *region, const EventList &list) const
 {
-	if(ptr_to_host_data == nullptr) throw std::runtime_error("data = nullptr");
+	OCL_ASSERT(ptr_to_host_data != nullptr, "data = nullptr");
 	std::vector<size_t> origin = {0, 0, 0};
-	OPENCL_SAFE_CALL( clEnqueueReadImage(this->activeQueue().id(), this->id(), CL_TRUE, origin.data(), region, 0, 0, ptr_to_host_data, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	const ocl::Queue &queue = this->activeQueue();
+	this->execute(list, Memory::ReadOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueReadImage(queue.id(), this->id(), CL_TRUE, origin.data(), region, 0, 0, ptr_to_host_data, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /**
@@ -452,10 +695,16 @@ void ocl::Image::read(void *ptr_to_host_data, const size_t *region, const EventL
  */
 ocl::Event ocl::Image::readAsync(size_t *origin, void *ptr_to_host_data, const size_t *region, const EventList &list) const
 {
-	if(ptr_to_host_data == nullptr) throw std::runtime_error("data = nullptr");
+	OCL_ASSERT(ptr_to_host_data != nullptr, "data = nullptr");
 	cl_event event_id;
-	OPENCL_SAFE_CALL( clEnqueueReadImage(this->activeQueue().id(), this->id(), CL_FALSE, origin, region, 0, 0, ptr_to_host_data, list.size(), list.events().data(), &event_id) );
-	return ocl::Event(event_id, this->context());
+	const ocl::Queue &queue = this->activeQueue();
+	ocl::Event event = this->enqueue(list, Memory::ReadOnly, nullptr, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL( clEnqueueReadImage(queue.id(), this->id(), CL_FALSE, origin, region, 0, 0, ptr_to_host_data, events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, region);
+	this->context()->track(queue, event);
+	return event;
 }
 
 
@@ -471,11 +720,13 @@ ocl::Event ocl::Image::readAsync(size_t *origin, void *ptr_to_host_data, const s
  */
 void ocl::Image::read(const Queue& queue, const size_t *origin, void *ptr_to_host_data, const size_t *region, const EventList &list) const
 {
-	if(ptr_to_host_data == nullptr) throw std::runtime_error("data = nullptr");
-	if(queue.context() != *this->context()) throw std::runtime_error("Context of queue and this must be equal");
+	OCL_ASSERT(ptr_to_host_data != nullptr, "data = nullptr");
+	OCL_ASSERT(queue.context() == *this->context(), "Context of queue and this must be equal");
 
-	OPENCL_SAFE_CALL( clEnqueueReadImage(queue.id(), this->id(), CL_TRUE, origin, region, 0, 0, ptr_to_host_data, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	this->execute(list, Memory::ReadOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueReadImage(queue.id(), this->id(), CL_TRUE, origin, region, 0, 0, ptr_to_host_data, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /**
@@ -489,11 +740,13 @@ void ocl::Image::read(const Queue& queue, const size_t *origin, void *ptr_to_hos
  */
 void ocl::Image::read(const Queue& queue, void *ptr_to_host_data, const size_t *region, const EventList &list) const
 {
-	if(ptr_to_host_data == nullptr) throw std::runtime_error("data = nullptr");
-	if(queue.context() != *this->context()) throw std::runtime_error("Context of queue and this must be equal");
+	OCL_ASSERT(ptr_to_host_data != nullptr, "data = nullptr");
+	OCL_ASSERT(queue.context() == *this->context(), "Context of queue and this must be equal");
 	const size_t origin[3] = {0, 0, 0};
-	OPENCL_SAFE_CALL( clEnqueueReadImage(queue.id(), this->id(), CL_TRUE, origin, region, 0, 0, ptr_to_host_data, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	this->execute(list, Memory::ReadOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueReadImage(queue.id(), this->id(), CL_TRUE, origin, region, 0, 0, ptr_to_host_data, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /**
@@ -510,11 +763,15 @@ void ocl::Image::read(const Queue& queue, void *ptr_to_host_data, const size_t *
  */
 ocl::Event ocl::Image::readAsync(const Queue &queue, size_t *origin, void *ptr_to_host_data, const size_t *region, const EventList &list) const
 {
-	if(ptr_to_host_data == nullptr) throw std::runtime_error("data = nullptr");
-	if(queue.context() != *this->context()) throw std::runtime_error("Context of queue and this must be equal");
+	OCL_ASSERT(ptr_to_host_data != nullptr, "data = nullptr");
+	OCL_ASSERT(queue.context() == *this->context(), "Context of queue and this must be equal");
 	cl_event event_id;
-	OPENCL_SAFE_CALL( clEnqueueReadImage(queue.id(), this->id(), CL_FALSE, origin, region, 0, 0, ptr_to_host_data, list.size(), list.events().data(), &event_id) );
-	return ocl::Event(event_id, this->context());
+	ocl::Event event = this->enqueue(list, Memory::ReadOnly, nullptr, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL( clEnqueueReadImage(queue.id(), this->id(), CL_FALSE, origin, region, 0, 0, ptr_to_host_data, events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, region);
+	return event;
 }
 
 /**
@@ -527,9 +784,12 @@ ocl::Event ocl::Image::readAsync(const Queue &queue, size_t *origin, void *ptr_t
  */
 void ocl::Image::write(size_t *origin, const void *ptr_to_host_data, const size_t *region, const EventList &list) const
 {
-	if(ptr_to_host_data == nullptr) throw std::runtime_error("data = nullptr");
-	OPENCL_SAFE_CALL( clEnqueueWriteImage(this->activeQueue().id(), this->id(), CL_TRUE, origin, region, 0, 0, ptr_to_host_data, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	OCL_ASSERT(ptr_to_host_data != nullptr, "data = nullptr");
+	const ocl::Queue &queue = this->activeQueue();
+	this->execute(list, Memory::WriteOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueWriteImage(queue.id(), this->id(), CL_TRUE, origin, region, 0, 0, ptr_to_host_data, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /**
@@ -541,10 +801,13 @@ void ocl::Image::write(size_t *origin, const void *ptr_to_host_data, const size_
  */
 void ocl::Image::write(const void *ptr_to_host_data, const size_t *region, const EventList &list) const
 {
-	if(ptr_to_host_data == nullptr) throw std::runtime_error("data = nullptr");
+	OCL_ASSERT(ptr_to_host_data != nullptr, "data = nullptr");
 	std::vector<size_t> origin = {0, 0, 0};
-	OPENCL_SAFE_CALL( clEnqueueWriteImage(this->activeQueue().id(), this->id(), CL_TRUE, origin.data(), region, 0, 0, ptr_to_host_data, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+	const ocl::Queue &queue = this->activeQueue();
+	this->execute(list, Memory::WriteOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueWriteImage(queue.id(), this->id(), CL_TRUE, origin.data(), region, 0, 0, ptr_to_host_data, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /**
@@ -559,10 +822,16 @@ void ocl::Image::write(const void *ptr_to_host_data, const size_t *region, const
  */
 ocl::Event ocl::Image::writeAsync(size_t *origin, const void *ptr_to_host_data, const size_t *region, const EventList &list) const
 {
-	if(ptr_to_host_data == nullptr) throw std::runtime_error("data = nullptr");
+	OCL_ASSERT(ptr_to_host_data != nullptr, "data = nullptr");
 	cl_event event_id;
-	OPENCL_SAFE_CALL( clEnqueueWriteImage(this->activeQueue().id(), this->id(), CL_FALSE, origin, region, 0, 0, ptr_to_host_data, list.size(), list.events().data(), &event_id) );
-	return ocl::Event(event_id, this->context());
+	const ocl::Queue &queue = this->activeQueue();
+	ocl::Event event = this->enqueue(list, Memory::WriteOnly, nullptr, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL( clEnqueueWriteImage(queue.id(), this->id(), CL_FALSE, origin, region, 0, 0, ptr_to_host_data, events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, region);
+	this->context()->track(queue, event);
+	return event;
 }
 
 
@@ -578,10 +847,12 @@ ocl::Event ocl::Image::writeAsync(size_t *origin, const void *ptr_to_host_data,
  */
 void ocl::Image::write(const Queue& queue, size_t *origin, const void *ptr_to_host_data, const size_t *region, const EventList &list) const
 {
-	if(ptr_to_host_data == nullptr) throw std::runtime_error("data = nullptr");
-	if(queue.context() != *this->context()) throw std::runtime_error("Context of queue and this must be equal");
-	OPENCL_SAFE_CALL( clEnqueueWriteImage(queue.id(), this->id(), CL_TRUE, origin, region, 0, 0, ptr_to_host_data, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	OCL_ASSERT(ptr_to_host_data != nullptr, "data = nullptr");
+	OCL_ASSERT(queue.context() == *this->context(), "Context of queue and this must be equal");
+	this->execute(list, Memory::WriteOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueWriteImage(queue.id(), this->id(), CL_TRUE, origin, region, 0, 0, ptr_to_host_data, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /**
@@ -595,11 +866,13 @@ void ocl::Image::write(const Queue& queue, size_t *origin, const void *ptr_to_ho
  */
 void ocl::Image::write(const Queue& queue, const void *ptr_to_host_data, const size_t *region, const EventList &list) const
 {
-	if(ptr_to_host_data == nullptr) throw std::runtime_error("data = nullptr");
-	if(queue.context() != *this->context()) throw std::runtime_error("Context of queue and this must be equal");
+	OCL_ASSERT(ptr_to_host_data != nullptr, "data = nullptr");
+	OCL_ASSERT(queue.context() == *this->context(), "Context of queue and this must be equal");
 	size_t const origin[] = {0, 0, 0};
-	OPENCL_SAFE_CALL( clEnqueueWriteImage(queue.id(), this->id(), CL_TRUE, origin, region, 0, 0, ptr_to_host_data, list.size(), list.events().data(), NULL) );
-	OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	this->execute(list, Memory::WriteOnly, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueWriteImage(queue.id(), this->id(), CL_TRUE, origin, region, 0, 0, ptr_to_host_data, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
 }
 
 /**
@@ -616,11 +889,15 @@ void ocl::Image::write(const Queue& queue, const void *ptr_to_host_data, const s
  */
 ocl::Event ocl::Image::writeAsync(const Queue &queue, size_t *origin, const void *ptr_to_host_data, const size_t *region, const EventList &list) const
 {
-	if(ptr_to_host_data == nullptr) throw std::runtime_error("data = nullptr");
-	if(queue.context() != *this->context()) throw std::runtime_error("Context of queue and this must be equal");
+	OCL_ASSERT(ptr_to_host_data != nullptr, "data = nullptr");
+	OCL_ASSERT(queue.context() == *this->context(), "Context of queue and this must be equal");
 	cl_event event_id;
-	OPENCL_SAFE_CALL( clEnqueueWriteImage(queue.id(), this->id(), CL_FALSE, origin, region, 0, 0, ptr_to_host_data, list.size(), list.events().data(), &event_id) );
-	return ocl::Event(event_id, this->context());
+	ocl::Event event = this->enqueue(list, Memory::WriteOnly, nullptr, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL( clEnqueueWriteImage(queue.id(), this->id(), CL_FALSE, origin, region, 0, 0, ptr_to_host_data, events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, region);
+	return event;
 }
 
 /*! \brief Acquires access to this Image.
@@ -645,5 +922,14 @@ void ocl::Image::acquireAccess(Queue &q) {
   */
 void ocl::Image::releaseAccess(Queue &q, const EventList& list) {
 	cl_event event_id;
-	OPENCL_SAFE_CALL( clEnqueueReleaseGLObjects(q.id(), 1, &this->_id, list.size(), list.events().data(), &event_id) );
+	OPENCL_SAFE_CALL( clEnqueueReleaseGLObjects(q.id(), 1, &this->_id, list.size(), list.data(), &event_id) );
+}
+
+/*! \brief Records the Event of an enqueued command transferring the region if the Context has a Profiler. */
+void ocl::Image::profile(const Event &event, const size_t *region) const
+{
+	if(this->context()->profiler() == nullptr) return;
+	size_t element_size = 0;
+	OPENCL_SAFE_CALL( clGetImageInfo(this->id(), CL_IMAGE_ELEMENT_SIZE, sizeof(element_size), &element_size, NULL) );
+	Memory::profile(event, region[0] * region[1] * region[2] * element_size);
 }
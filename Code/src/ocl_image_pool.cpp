@@ -0,0 +1,218 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <ocl_image_pool.h>
+#include <ocl_context.h>
+#include <ocl_query.h>
+
+
+static bool completed(const ocl::EventList &list)
+{
+	for(size_t i = 0; i < list.size(); ++i){
+		cl_int status = CL_COMPLETE;
+		OPENCL_SAFE_CALL( clGetEventInfo(list.data()[i], CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(status), &status, NULL) );
+		if(status > CL_COMPLETE) return false;
+	}
+	return true;
+}
+
+
+/*! \brief Instantiates this ImagePool for the Context.
+  *
+  * \param ctxt is the Context in which the Image objects are created.
+  * \param capacity is the maximum number of idle Image objects.
+  */
+ocl::ImagePool::ImagePool(Context &ctxt, size_t capacity) :
+	_state(std::make_shared<State>(ctxt, capacity))
+{
+}
+
+/*! \brief Destructs this ImagePool and releases all idle Image objects.
+  *
+  * Image objects which are still acquired are released when their last reference is dropped.
+  */
+ocl::ImagePool::~ImagePool()
+{
+	this->clear();
+}
+
+/*! \brief Returns an 1D-Image with the width, format and access.
+  *
+  * \param width Width of the 1D-Image.
+  * \param type Channeltype of the image.
+  * \param order Channelorder of the image.
+  * \param access Access of the kernels to the image.
+  */
+std::shared_ptr<ocl::Image> ocl::ImagePool::acquire(size_t width, Image::ChannelType type, Image::ChannelOrder order, Image::Access access)
+{
+	return this->acquire(Image::Image1D, width, 1, 1, type, order, access);
+}
+
+/*! \brief Returns a 2D-Image with the dimensions, format and access.
+  *
+  * \param width Width of the 2D-Image.
+  * \param height Height of the 2D-Image.
+  * \param type Channeltype of the image.
+  * \param order Channelorder of the image.
+  * \param access Access of the kernels to the image.
+  */
+std::shared_ptr<ocl::Image> ocl::ImagePool::acquire(size_t width, size_t height, Image::ChannelType type, Image::ChannelOrder order, Image::Access access)
+{
+	return this->acquire(Image::Image2D, width, height, 1, type, order, access);
+}
+
+/*! \brief Returns a 3D-Image with the dimensions, format and access.
+  *
+  * \param width Width of the 3D-Image.
+  * \param height Height of the 3D-Image.
+  * \param depth Depth of the 3D-Image.
+  * \param type Channeltype of the image.
+  * \param order Channelorder of the image.
+  * \param access Access of the kernels to the image.
+  */
+std::shared_ptr<ocl::Image> ocl::ImagePool::acquire(size_t width, size_t height, size_t depth, Image::ChannelType type, Image::ChannelOrder order, Image::Access access)
+{
+	return this->acquire(Image::Image3D, width, height, depth, type, order, access);
+}
+
+/*! \brief Returns an idle Image with the key or creates a new one.
+  *
+  * An idle Image whose commands have completed is preferred. Otherwise
+  * the commands of the returned Image are waited for.
+  */
+std::shared_ptr<ocl::Image> ocl::ImagePool::acquire(Image::ImageType imageType, size_t width, size_t height, size_t depth,
+                                                    Image::ChannelType type, Image::ChannelOrder order, Image::Access access)
+{
+	const Key key(imageType, width, height, depth, type, order, access);
+	std::unique_ptr<Image> image;
+	EventList pending;
+	{
+		std::lock_guard<std::mutex> lock(_state->mutex);
+		const auto range = _state->images.equal_range(key);
+		auto it = std::find_if(range.first, range.second, [](const std::pair<const Key, Idle> &i){ return completed(i.second.pending); });
+		if(it == range.second) it = range.first;
+		if(range.first != range.second){
+			image = std::move(it->second.image);
+			pending = std::move(it->second.pending);
+			_state->images.erase(it);
+			++_state->hits;
+		}
+		else{
+			++_state->misses;
+		}
+	}
+	if(!pending.isEmpty()) pending.waitUntilCompleted();
+
+	if(!image){
+		Context &ctxt = *_state->context;
+		if(imageType == Image::Image1D)      image.reset( new Image(ctxt, width, type, order, access) );
+		else if(imageType == Image::Image2D) image.reset( new Image(ctxt, width, height, type, order, access) );
+		else                                 image.reset( new Image(ctxt, width, height, depth, type, order, access) );
+	}
+
+	Recycler recycler = { _state, key, EventList() };
+	return std::shared_ptr<Image>(image.release(), recycler);
+}
+
+/*! \brief Drops the reference to the acquired Image and records the commands which may still use it.
+  *
+  * The Image returns to the pool with the commands once its last reference is dropped.
+  * Commands recorded by earlier calls for the same Image are kept.
+  *
+  * \param image is an Image acquired from an ImagePool and is reset.
+  * \param pending are the commands which may still read or write the Image.
+  */
+void ocl::ImagePool::release(std::shared_ptr<Image> &image, const EventList &pending)
+{
+	Recycler *recycler = std::get_deleter<Recycler>(image);
+	if(recycler == nullptr) throw std::runtime_error("Image not acquired from an ImagePool");
+	{
+		std::lock_guard<std::mutex> lock(_state->mutex);
+		recycler->pending << pending;
+	}
+	image.reset();
+}
+
+/*! \brief Returns the Image to the pool or deletes it if the pool is full or destructed. */
+void ocl::ImagePool::Recycler::operator()(Image *image) const
+{
+	std::unique_ptr<Image> owned(image);
+	std::shared_ptr<State> s = state.lock();
+	if(!s) return;
+	std::lock_guard<std::mutex> lock(s->mutex);
+	if(s->images.size() < s->capacity){
+		Idle idle = { std::move(owned), pending };
+		s->images.insert(std::make_pair(key, std::move(idle)));
+	}
+}
+
+/*! \brief Sets the maximum number of idle Image objects and releases the surplus. */
+void ocl::ImagePool::setCapacity(size_t capacity)
+{
+	std::lock_guard<std::mutex> lock(_state->mutex);
+	_state->capacity = capacity;
+	while(_state->images.size() > capacity)
+		_state->images.erase(_state->images.begin());
+}
+
+/*! \brief Returns the maximum number of idle Image objects. */
+size_t ocl::ImagePool::capacity() const
+{
+	std::lock_guard<std::mutex> lock(_state->mutex);
+	return _state->capacity;
+}
+
+/*! \brief Returns the number of idle Image objects. */
+size_t ocl::ImagePool::idle() const
+{
+	std::lock_guard<std::mutex> lock(_state->mutex);
+	return _state->images.size();
+}
+
+/*! \brief Returns the number of acquisitions which have been served by an idle Image. */
+size_t ocl::ImagePool::hits() const
+{
+	std::lock_guard<std::mutex> lock(_state->mutex);
+	return _state->hits;
+}
+
+/*! \brief Returns the number of acquisitions for which a new Image has been created. */
+size_t ocl::ImagePool::misses() const
+{
+	std::lock_guard<std::mutex> lock(_state->mutex);
+	return _state->misses;
+}
+
+/*! \brief Releases all idle Image objects. */
+void ocl::ImagePool::clear()
+{
+	std::multimap<Key, Idle> images;
+	{
+		std::lock_guard<std::mutex> lock(_state->mutex);
+		images.swap(_state->images);
+	}
+}
+
+/*! \brief Returns the Context in which the Image objects are created. */
+ocl::Context& ocl::ImagePool::context() const
+{
+	return *_state->context;
+}
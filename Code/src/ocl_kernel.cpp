@@ -26,6 +26,9 @@
 #include <typeinfo>
 #include <cmath>
 #include <cassert>
+#include <cctype>
+#include <cstdint>
+#include <map>
 
 
 #include <ocl_program.h>
@@ -34,6 +37,10 @@
 #include <ocl_kernel.h>
 #include <ocl_queue.h>
 #include <ocl_event_list.h>
+#include <ocl_dependency_tracker.h>
+#include <ocl_profiler.h>
+#include <ocl_buffer.h>
+#include <ocl_image.h>
 
 #include <utl_type.h>
 
@@ -42,7 +49,7 @@
 
 /*! \brief Instantiates an empty Kernel object without a kernel function.*/
 ocl::Kernel::Kernel() :
-	_program(0),  _id(0), _workDim(1), _kernelfunc(), _name(), _memlocs()
+	_program(0),  _id(0), _workDim(1), _globalOffset(), _kernelfunc(), _name(), _memlocs(), _access(), _memArgs()
 {
 }
 
@@ -50,16 +57,16 @@ ocl::Kernel::Kernel() :
   *
   * Note that it is assumed that the Program is instantiating
   * this Kernel. Thus it is assumed that comments are erased and
-  * that the Kernel is not templated any more. The Program
-  * should not be built yet.
+  * that the Kernel is not templated any more. If the Program
+  * is already built, this Kernel is created when the Program is linked again.
   */
 ocl::Kernel::Kernel(const ocl::Program &p, const std::string &kernel) :
-	_program(&p), _id(0), _workDim(1), _kernelfunc(), _name(), _memlocs()
+	_program(&p), _id(0), _workDim(1), _globalOffset(), _kernelfunc(), _name(), _memlocs(), _access(), _memArgs()
 {
-	if(_program->isBuilt()) throw std::runtime_error("Program is already built.");
 	this->_kernelfunc = kernel;
 	this->_name = this->extractName(kernel);
 	this->_memlocs = this->extractMemlocs(kernel);
+	this->_access = this->extractAccess(kernel);
 }
 
 /*! \brief Instantiates this Kernel given the kernel function within a string.
@@ -70,11 +77,12 @@ ocl::Kernel::Kernel(const ocl::Program &p, const std::string &kernel) :
   * Kernel and built it.
   */
 ocl::Kernel::Kernel(const std::string &kernel) :
-	_program(0), _id(0), _workDim(1), _kernelfunc(), _name(), _memlocs()
+	_program(0), _id(0), _workDim(1), _globalOffset(), _kernelfunc(), _name(), _memlocs(), _access(), _memArgs()
 {
 	this->_kernelfunc = kernel;
 	this->_name = this->extractName(kernel);
 	this->_memlocs = this->extractMemlocs(kernel);
+	this->_access = this->extractAccess(kernel);
 }
 
 /*! \brief Instantiates this Kernel given a Program, the kernel function within a string and a Type.
@@ -84,7 +92,7 @@ ocl::Kernel::Kernel(const std::string &kernel) :
   * The Program should not be built yet.
 */
 ocl::Kernel::Kernel(const ocl::Program &p, const std::string &kernel, const utl::Type & type) :
-	_program(&p), _id(0), _workDim(1), _kernelfunc(), _name(), _memlocs()
+	_program(&p), _id(0), _workDim(1), _globalOffset(), _kernelfunc(), _name(), _memlocs(), _access(), _memArgs()
 {
 
 	if(this->templated(kernel))  this->_kernelfunc = this->specialize(kernel, type.name());
@@ -92,9 +100,20 @@ ocl::Kernel::Kernel(const ocl::Program &p, const std::string &kernel, const utl:
 
 	this->_name = this->extractName(_kernelfunc);
 	this->_memlocs = this->extractMemlocs(_kernelfunc);
+	this->_access = this->extractAccess(_kernelfunc);
 
 }
 
+/*! \brief Instantiates this Kernel given a Program and an entry point of an intermediate language.
+  *
+  * Used for Program objects created from an intermediate language
+  * for which no kernel function string is available.
+*/
+ocl::Kernel::Kernel(const ocl::Program &p, const EntryPoint &entry) :
+	_program(&p), _id(0), _workDim(1), _globalOffset(), _kernelfunc(), _name(entry.name), _memlocs(entry.memlocs), _access(entry.access), _memArgs()
+{
+}
+
 /*! \brief Instantiates this Kernel given a Program, the kernel function within a string and a Type.
   *
   * It is assumed that comments are erased and
@@ -103,7 +122,7 @@ ocl::Kernel::Kernel(const ocl::Program &p, const std::string &kernel, const utl:
   * Kernel and built it.
 */
 ocl::Kernel::Kernel(const std::string &kernel, const utl::Type & type) :
-	_program(0), _id(0), _workDim(1), _kernelfunc(), _name(), _memlocs()
+	_program(0), _id(0), _workDim(1), _globalOffset(), _kernelfunc(), _name(), _memlocs(), _access(), _memArgs()
 {
 
 	if(this->templated(kernel))  this->_kernelfunc = this->specialize(kernel, type.name());
@@ -111,6 +130,7 @@ ocl::Kernel::Kernel(const std::string &kernel, const utl::Type & type) :
 
 	this->_name = this->extractName(_kernelfunc);
 	this->_memlocs = this->extractMemlocs(_kernelfunc);
+	this->_access = this->extractAccess(_kernelfunc);
 
 }
 
@@ -134,7 +154,7 @@ void ocl::Kernel::create()
 {
 	if(this->created()) return;
 	if(this->_program  == 0) throw std::runtime_error("program == 0");
-	if(!this->program().isBuilt())throw std::runtime_error("Program not yet built");
+	if(this->program().id() == 0)throw std::runtime_error("Program not yet built");
 	const char * __t = this->name().c_str();
 
 #if 0
@@ -161,14 +181,20 @@ void ocl::Kernel::release()
 	}
 	_globalSize[0] = 1; _globalSize[1] = 1; _globalSize[2] = 1;
 	_localSize[0] = 1; _localSize[1] = 1; _localSize[2] = 1;
+	_globalOffset[0] = 0; _globalOffset[1] = 0; _globalOffset[2] = 0;
 	_id = 0;
 	_workDim = 1;
 }
 
 
-/*! \brief Returns the OpenCL kernel ID of this Kernel. */
+/*! \brief Returns the OpenCL kernel ID of this Kernel.
+  *
+  * Waits for a pending asynchronous build of the Program
+  * which creates this Kernel if it has not been created yet.
+*/
 cl_kernel ocl::Kernel::id() const
 {
+	if(_id == 0 && _program != nullptr) _program->waitForBuild();
 	return _id;
 }
 
@@ -204,12 +230,13 @@ ocl::Context& ocl::Kernel::context() const
 */
 ocl::Event ocl::Kernel::callKernel(const Queue& queue, const EventList& list)
 {
-	if(queue.context() != this->context()) throw std::runtime_error("Context must be equal.");
+	OCL_ASSERT(queue.context() == this->context(), "Context must be equal.");
 	cl_event event_id;
-
-	OPENCL_SAFE_CALL( clEnqueueNDRangeKernel(queue.id(), this->id(), this->workDim(), 0, this->globalSize(), this->localSize(), list.size(), list.events().data(), &event_id) );
-
-	return ocl::Event(event_id, &this->context());
+	ocl::Event event = this->enqueue(list, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL( clEnqueueNDRangeKernel(queue.id(), this->id(), this->workDim(), this->workOffset(), this->globalSize(), this->localSize(), events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, &this->context());
+	});
+	return event;
 }
 
 /*! \brief Executes this Kernel and returns an Event by which the execution can be tracked.
@@ -220,10 +247,13 @@ ocl::Event ocl::Kernel::callKernel(const Queue& queue, const EventList& list)
 */
 ocl::Event ocl::Kernel::callKernel(const Queue& queue)
 {
-	if(queue.context() != this->context()) throw std::runtime_error("Context must be equal.");
+	OCL_ASSERT(queue.context() == this->context(), "Context must be equal.");
 	cl_event event_id;
-	OPENCL_SAFE_CALL( clEnqueueNDRangeKernel(queue.id(), this->id(), this->workDim(), 0, this->globalSize(), this->localSize(), 0, NULL, &event_id) );
-	return ocl::Event(event_id, &this->context());
+	ocl::Event event = this->enqueue(ocl::EventList(), [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL( clEnqueueNDRangeKernel(queue.id(), this->id(), this->workDim(), this->workOffset(), this->globalSize(), this->localSize(), events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, &this->context());
+	});
+	return event;
 }
 
 /*! \brief Executes this Kernel and returns an Event by which the execution can be tracked.
@@ -238,9 +268,39 @@ ocl::Event ocl::Kernel::callKernel()
 	cl_event event_id;
 
 	const ocl::Queue &queue = this->program().context().activeQueue();
+	ocl::Event event = this->enqueue(ocl::EventList(), [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL( clEnqueueNDRangeKernel(queue.id(), this->id(), this->workDim(), this->workOffset(), this->globalSize(), this->localSize(), events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, &this->context());
+	});
+	this->context().track(queue, event);
+	return event;
+}
+
+/*! \brief Enqueues the execution of this Kernel and returns its Event.
+  *
+  * The command is called with the list itself if the Context has no DependencyTracker
+  * so that no events are copied. Otherwise, it is called with the events of the list
+  * together with the events of the commands using the Memory arguments on which the
+  * execution depends, and its Event is recorded by the DependencyTracker.
+  * The Event is also recorded by the Profiler of the Context if there is one.
+*/
+ocl::Event ocl::Kernel::enqueue(const EventList &list, const std::function<Event(const EventList&)> &command) const
+{
+	ocl::DependencyTracker *tracker = this->context().dependencyTracker();
+	ocl::Event event = tracker == nullptr ? command(list) : tracker->enqueue(this->uses(), list, command);
 
-	OPENCL_SAFE_CALL( clEnqueueNDRangeKernel(queue.id(), this->id(), this->workDim(), 0, this->globalSize(), this->localSize(), 0, NULL, &event_id) );
-	return ocl::Event(event_id, &this->context());
+	ocl::Profiler *profiler = this->context().profiler();
+	if(profiler != nullptr) profiler->record(event, this->name());
+	return event;
+}
+
+/*! \brief Returns the Memory arguments of this Kernel together with their Access. */
+ocl::DependencyTracker::Uses ocl::Kernel::uses() const
+{
+	ocl::DependencyTracker::Uses uses;
+	for(size_t i = 0; i < _memArgs.size(); ++i)
+		if(_memArgs[i] != nullptr) uses.push_back(std::make_pair(_memArgs[i], this->access(i)));
+	return uses;
 }
 
 #if 0
@@ -286,6 +346,22 @@ const size_t* ocl::Kernel::globalSize() const
 	return _globalSize;
 }
 
+/*! \brief Returns the offsets of the index space. */
+const size_t* ocl::Kernel::globalOffset() const
+{
+	return _globalOffset;
+}
+
+/*! \brief Returns the offsets of the index space or null if they are zero.
+  *
+  * OpenCL 1.0 requires null for executions without offsets.
+*/
+const size_t* ocl::Kernel::workOffset() const
+{
+	if(_globalOffset[0] == 0 && _globalOffset[1] == 0 && _globalOffset[2] == 0) return nullptr;
+	return _globalOffset;
+}
+
 /*! \brief Returns the localSize of the index space for the specified dimension.*/
 size_t ocl::Kernel::localSize(size_t pos) const
 {
@@ -337,6 +413,27 @@ void ocl::Kernel::setLocalSize(size_t localSize, size_t pos)
 	_localSize[pos] = localSize;
 }
 
+/*! \brief Returns the offset of the index space for the specified dimension.*/
+size_t ocl::Kernel::globalOffset(size_t pos) const
+{
+	if(pos >= 3) throw std::runtime_error("Cannot have more than three dims : " + std::to_string(pos));
+	return _globalOffset[pos];
+}
+
+/*! \brief Sets the offset of the index space for the specified dimension.
+  *
+  * The global IDs of the work-items in the dimension pos then
+  * start at globalOffset instead of zero. Requires OpenCL 1.1.
+  *
+  * \param globalOffset Offset of the index space at dimension pos.
+  * \param pos Specifies the dimension of the index space for which the offset is set.
+*/
+void ocl::Kernel::setGlobalOffset(size_t globalOffset, size_t pos)
+{
+	if(pos >= 3) throw std::runtime_error("Cannot have more than three dims : " + std::to_string(pos));
+	_globalOffset[pos] = globalOffset;
+}
+
 /*! \brief Sets the global size for all three dimensions.
   *
   * Note that the array provided must be equal three.
@@ -424,11 +521,40 @@ void ocl::Kernel::setWorkSize(size_t lSizeX, size_t lSizeY, size_t lSizeZ, size_
 */
 void ocl::Kernel::setArg(int pos, cl_mem data)
 {
-	if(this->numberOfArgs() <= size_t(pos)) throw std::runtime_error( "Position " + std::to_string(pos) + " <= " + std::to_string(this->numberOfArgs()));
+	OCL_ASSERT(size_t(pos) < this->numberOfArgs(), "Position " + std::to_string(pos) + " <= " + std::to_string(this->numberOfArgs()));
 	//TRUE_ASSERT(this->memoryLocation(pos) == global, "Argument must be of type GLOBAL at pos " << pos);
-	cl_int stat = clSetKernelArg(_id, pos, sizeof(cl_mem), &data);
+	cl_int stat = clSetKernelArg(this->id(), pos, sizeof(cl_mem), &data);
 	if(stat != CL_SUCCESS) cerr << "Error setting kernel "<< this->name() << " argument " << pos << endl;
 	OPENCL_SAFE_CALL( stat );
+	if(_memArgs.size() < this->numberOfArgs()) _memArgs.resize(this->numberOfArgs(), nullptr);
+	_memArgs[pos] = data;
+}
+
+/*! \brief Sets the Memory object into the argument list of this Kernel at the specified position.
+  *
+  * See setArg(int, cl_mem).
+*/
+void ocl::Kernel::setArg(int pos, const Memory &data)
+{
+	this->setArg(pos, data.id());
+}
+
+/*! \brief Sets the Buffer into the argument list of this Kernel at the specified position.
+  *
+  * See setArg(int, cl_mem).
+*/
+void ocl::Kernel::setArg(int pos, const Buffer &data)
+{
+	this->setArg(pos, data.id());
+}
+
+/*! \brief Sets the Image into the argument list of this Kernel at the specified position.
+  *
+  * See setArg(int, cl_mem).
+*/
+void ocl::Kernel::setArg(int pos, const Image &data)
+{
+	this->setArg(pos, data.id());
 }
 
 /*! \brief Sets the OpenCL sampler object into the argument list of this Kernel at the specified position.
@@ -436,10 +562,11 @@ void ocl::Kernel::setArg(int pos, cl_mem data)
 */
 void ocl::Kernel::setArg(int pos, cl_sampler data)
 {
-	if(this->numberOfArgs() <= size_t(pos)) throw std::runtime_error("Position " + std::to_string(pos) + " <= " + std::to_string(this->numberOfArgs()));
-	cl_int stat = clSetKernelArg(_id, pos, sizeof(cl_sampler), &data);
+	OCL_ASSERT(size_t(pos) < this->numberOfArgs(), "Position " + std::to_string(pos) + " <= " + std::to_string(this->numberOfArgs()));
+	cl_int stat = clSetKernelArg(this->id(), pos, sizeof(cl_sampler), &data);
 	if(stat != CL_SUCCESS) cerr << "Error setting kernel "<< this->name() << " argument " << pos << endl;
 	OPENCL_SAFE_CALL( stat );
+	if(size_t(pos) < _memArgs.size()) _memArgs[pos] = nullptr;
 }
 
 /*! \brief Sets a scalar datum into the argument list of this Kernel at the specified position.
@@ -449,20 +576,20 @@ void ocl::Kernel::setArg(int pos, cl_sampler data)
 template<class T>
 void ocl::Kernel::setArg(int pos, const T& data)
 {
-	if(this->numberOfArgs() <= size_t(pos)) throw std::runtime_error("Position " + std::to_string(pos) + " <= " + std::to_string(this->numberOfArgs()));
+	OCL_ASSERT(size_t(pos) < this->numberOfArgs(), "Position " + std::to_string(pos) + " <= " + std::to_string(this->numberOfArgs()));
 
 	cl_int stat ;
 
 	if(this->memoryLocation(pos) == host)
 	{
-		stat = clSetKernelArg(_id, pos, sizeof(T), (void*)&data);
+		stat = clSetKernelArg(this->id(), pos, sizeof(T), (void*)&data);
 	}
 	else if(this->memoryLocation(pos) == local)
 	{
 		if(typeid(data) != typeid(size_t)) throw std::runtime_error("data: " + std::to_string(data) + " at pos " + std::to_string(pos) + " must be of type size_t");
 
 		// TODO This is a hack and should be better implemented using compile time type erasure.
-		stat = clSetKernelArg(_id, pos, static_cast<size_t>( data ), NULL);
+		stat = clSetKernelArg(this->id(), pos, static_cast<size_t>( data ), NULL);
 	}
 	else
 	{
@@ -472,6 +599,7 @@ void ocl::Kernel::setArg(int pos, const T& data)
 	if(stat != CL_SUCCESS) cerr << "Error setting kernel "<< name() << " at pos = " << pos << ", arg = " << data << endl;
 	
 	OPENCL_SAFE_CALL( stat );
+	if(size_t(pos) < _memArgs.size()) _memArgs[pos] = nullptr;
 }
 
 template void ocl::Kernel::setArg<int>   (int pos, const int& data);
@@ -506,9 +634,15 @@ ocl::Kernel::mem_loc ocl::Kernel::memoryLocation(size_t pos) const
 	return this->_memlocs.at(pos);
 }
 
+/*! \brief Returns how this Kernel accesses the Memory argument at the specified position. */
+ocl::Memory::Access ocl::Kernel::access(size_t pos) const
+{
+	return this->_access.at(pos);
+}
+
 bool ocl::Kernel::templated(const std::string &kernel)
 {
-	return !ocl::Kernel::extractParameter(kernel).empty();
+	return !ocl::Kernel::templateDeclarations(kernel).empty();
 }
 
 std::vector<ocl::Kernel::mem_loc> ocl::Kernel::extractMemlocs(const std::string & kernel)
@@ -548,6 +682,167 @@ std::vector<ocl::Kernel::mem_loc> ocl::Kernel::extractMemlocs(const std::string
 	return locs;
 }
 
+/*! \brief Extracts how the kernel function accesses its arguments.
+  *
+  * Arguments declared const, __constant or read_only are only read,
+  * arguments declared write_only are only written. All other
+  * arguments are read and written.
+  */
+std::vector<ocl::Memory::Access> ocl::Kernel::extractAccess(const std::string & kernel)
+{
+	const size_t start = kernel.find("(", kernel.find("void")) + 1;
+	const size_t end   = kernel.find(")", start);
+	if(start == 0 || end == std::string::npos) throw std::runtime_error("Function not correctly defined.");
+
+	std::vector<Memory::Access> access;
+	std::istringstream arguments(kernel.substr(start, end - start));
+	std::string argument;
+	while(std::getline(arguments, argument, ',')){
+		// Qualifiers behind the last pointer declarator refer to the pointer itself.
+		const std::string type = argument.substr(0, argument.rfind('*'));
+		std::set<std::string> words;
+		std::string word;
+		for(char c : type + " "){
+			if(std::isalnum(static_cast<unsigned char>(c)) || c == '_') { word += c; continue; }
+			if(!word.empty()) words.insert(word);
+			word.clear();
+		}
+		if(words.empty()) continue;
+		if(words.count("const") || words.count("__constant") || words.count("constant") || words.count("read_only") || words.count("__read_only"))
+			access.push_back(Memory::ReadOnly);
+		else if(words.count("write_only") || words.count("__write_only"))
+			access.push_back(Memory::WriteOnly);
+		else
+			access.push_back(Memory::ReadWrite);
+	}
+	return access;
+}
+
+/*! \brief Returns the kernel functions of a SPIR-V module together with the memory locations and access of their arguments.
+  *
+  * Memory locations are derived from the storage classes of pointer
+  * arguments and from image, sampler and pipe types of the entry points.
+  * Pointer arguments are accessed as declared by the NonWritable and
+  * NonReadable decorations, images by their access qualifier.
+  * Throws if the data is not a SPIR-V module or if an argument
+  * has a storage class that cannot be passed to a kernel.
+*/
+std::vector<ocl::Kernel::EntryPoint> ocl::Kernel::extractEntryPoints(const std::vector<unsigned char> &il)
+{
+	enum { OpEntryPoint = 15, OpTypeImage = 25, OpTypeSampler = 26, OpTypeSampledImage = 27, OpTypePointer = 32,
+	       OpTypeFunction = 33, OpTypePipe = 38, OpFunction = 54, OpFunctionParameter = 55, OpFunctionEnd = 56,
+	       OpDecorate = 71, OpGroupDecorate = 74 };
+	enum { UniformConstant = 0, Workgroup = 4, CrossWorkgroup = 5, Function = 7 };
+	enum { NonWritable = 24, NonReadable = 25 };
+	enum { AccessReadOnly = 0, AccessWriteOnly = 1 };
+	enum { ExecutionModelKernel = 6 };
+	const uint32_t magic = 0x07230203;
+
+	if(il.size() < 20 || il.size() % 4 != 0) throw std::runtime_error("Invalid SPIR-V module.");
+
+	std::vector<uint32_t> words(il.size() / 4);
+	for(size_t i = 0; i < words.size(); ++i)
+		words[i] = uint32_t(il[4*i]) | uint32_t(il[4*i+1]) << 8 | uint32_t(il[4*i+2]) << 16 | uint32_t(il[4*i+3]) << 24;
+	if(words[0] != magic){
+		for(auto &w : words) w = (w >> 24) | ((w >> 8) & 0xff00) | ((w << 8) & 0xff0000) | (w << 24);
+		if(words[0] != magic) throw std::runtime_error("Invalid SPIR-V module.");
+	}
+
+	std::vector< std::pair< uint32_t, std::string > > entries;
+	std::map< uint32_t, std::pair<mem_loc, Memory::Access> > typeArgs;
+	std::map< uint32_t, uint32_t > storageClasses;
+	std::map< uint32_t, Memory::Access > decorations;
+	std::map< uint32_t, std::vector< std::pair<uint32_t, uint32_t> > > parameters;
+	uint32_t function = 0;
+
+	for(size_t i = 5; i < words.size(); ){
+		const uint32_t count = words[i] >> 16, op = words[i] & 0xffff;
+		if(count == 0 || i + count > words.size()) throw std::runtime_error("Invalid SPIR-V module.");
+		const uint32_t *w = &words[i];
+
+		switch(op){
+		case OpEntryPoint:
+			if(count > 3 && w[1] == ExecutionModelKernel){
+				std::string name;
+				for(uint32_t j = 3; j < count; ++j){
+					for(int b = 0; b < 4; ++b){
+						const char c = char((w[j] >> (8*b)) & 0xff);
+						if(c == 0) { j = count; break; }
+						name += c;
+					}
+				}
+				entries.push_back(std::make_pair(w[2], name));
+			}
+			break;
+		case OpDecorate:
+			if(count > 2 && (w[2] == NonWritable || w[2] == NonReadable))
+				decorations[w[1]] = w[2] == NonWritable ? Memory::ReadOnly : Memory::WriteOnly;
+			break;
+		case OpGroupDecorate:
+			if(decorations.count(w[1]))
+				for(uint32_t j = 2; j < count; ++j) decorations[w[j]] = decorations[w[1]];
+			break;
+		case OpTypeImage:
+			typeArgs[w[1]] = std::make_pair(image, count <= 9 ? Memory::ReadWrite :
+			                                w[9] == AccessReadOnly ? Memory::ReadOnly : w[9] == AccessWriteOnly ? Memory::WriteOnly : Memory::ReadWrite);
+			break;
+		case OpTypeSampledImage:
+			typeArgs[w[1]] = std::make_pair(image, Memory::ReadOnly);
+			break;
+		case OpTypeSampler:
+			typeArgs[w[1]] = std::make_pair(sampler, Memory::ReadOnly);
+			break;
+		case OpTypePipe:
+			typeArgs[w[1]] = std::make_pair(global, w[2] == AccessReadOnly ? Memory::ReadOnly : w[2] == AccessWriteOnly ? Memory::WriteOnly : Memory::ReadWrite);
+			break;
+		case OpTypePointer:
+			storageClasses[w[1]] = w[2];
+			break;
+		case OpFunction:
+			function = w[2];
+			parameters[function];
+			break;
+		case OpFunctionParameter:
+			parameters[function].push_back(std::make_pair(w[1], w[2]));
+			break;
+		case OpFunctionEnd:
+			function = 0;
+			break;
+		}
+		i += count;
+	}
+
+	std::vector<EntryPoint> kernels;
+	for(const auto &e : entries){
+		EntryPoint kernel = { e.second, std::vector<mem_loc>(), std::vector<Memory::Access>() };
+		for(const auto &param : parameters[e.first]){
+			mem_loc loc = host;
+			Memory::Access access = Memory::ReadWrite;
+			auto type = typeArgs.find(param.first);
+			auto storage = storageClasses.find(param.first);
+			if(type != typeArgs.end()){
+				loc = type->second.first;
+				access = type->second.second;
+			}
+			else if(storage != storageClasses.end()){
+				switch(storage->second){
+				case CrossWorkgroup:  loc = global; break;
+				case Workgroup:       loc = local; break;
+				case UniformConstant: loc = constant; access = Memory::ReadOnly; break;
+				case Function:        loc = host; break;
+				default: throw std::runtime_error("Argument of kernel " + e.second + " has an unsupported storage class.");
+				}
+			}
+			auto decoration = decorations.find(param.second);
+			if(decoration != decorations.end()) access = decoration->second;
+			kernel.memlocs.push_back(loc);
+			kernel.access.push_back(access);
+		}
+		kernels.push_back(kernel);
+	}
+	return kernels;
+}
+
 std::string ocl::Kernel::extractParameter(const std::string& kernel)
 {
 	assert(!kernel.empty());
@@ -594,62 +889,206 @@ std::string ocl::Kernel::extractName(const string &kernel)
 
 std::string ocl::Kernel::specialize(const std::string& kernel, const std::string& type)//const utl::Type &type)
 {
+	if(!ocl::Kernel::templated(kernel)) return kernel;
+	return ocl::Kernel::specialize(kernel, std::vector<std::string>(1, type));
+}
 
-	const string temp_param = ocl::Kernel::extractParameter(kernel);
-
-	if(temp_param.empty()) return kernel;
-
-	string fct = kernel;
-
-	//    DEBUG_COMMENT("fct = " << fct);
-
-
+/*! \brief Returns the kernel function with all template parameters substituted by the arguments.
+  *
+  * Supports type parameters (class, typename) and non-type parameters
+  * such as int TILE. The template declaration is removed and every
+  * identifier token matching a parameter name is replaced by the
+  * corresponding argument. Identifiers that merely contain a parameter name,
+  * string literals and character literals are left untouched. The function name
+  * is extended by the mangled arguments, e.g. gemm_float_double_16.
+  *
+  * \param kernel Templated kernel function.
+  * \param arguments One argument for each template parameter in declaration order.
+*/
+std::string ocl::Kernel::specialize(const std::string& kernel, const std::vector<std::string> &arguments)
+{
 	size_t start = 0, end = 0;
+	const std::vector<std::string> declarations = ocl::Kernel::templateDeclarations(kernel, &start, &end);
+	if(declarations.empty()) throw std::runtime_error("Kernel is not templated.");
+	const std::vector<std::string> completed = ocl::Kernel::completeArguments(kernel, arguments);
+
+	const std::vector<std::string> parameters = ocl::Kernel::extractParameters(kernel);
+	std::string fct = kernel.substr(0, start) + kernel.substr(end + 1);
 
-	start = fct.find("template", start);
-	end   = fct.find(">",end,1);
-	assert(start < end); // Template not correctly defined
+	auto isIdentifier = [](char c){ return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
 
-	fct.erase(start, end - start + 2);
+	std::string result;
+	result.reserve(fct.size());
+	size_t pos = 0;
+	while(pos < fct.size()){
+		const char c = fct[pos];
+		if(c == '"' || c == '\''){
+			size_t next = pos + 1;
+			while(next < fct.size() && fct[next] != c){ if(fct[next] == '\\') ++next; ++next; }
+			result.append(fct, pos, next - pos + 1);
+			pos = next + 1;
+		}
+		else if(isIdentifier(c)){
+			size_t next = pos;
+			while(next < fct.size() && isIdentifier(fct[next])) ++next;
+			const std::string token = fct.substr(pos, next - pos);
+			auto it = std::find(parameters.begin(), parameters.end(), token);
+			if(it != parameters.end() && !std::isdigit(static_cast<unsigned char>(c)))
+				result += completed[it - parameters.begin()];
+			else
+				result += token;
+			pos = next;
+		}
+		else{
+			result += c;
+			++pos;
+		}
+	}
 
-	// #if defined OPENCL_V1_1 || defined OPENCL_V1_0
-	//if(type == "double") fct.insert(0, "#if !defined(__OPENCL_VERSION__) || __OPENCL_VERSION__ < 120\n#pragma OPENCL EXTENSION cl_khr_fp64: enable\n#endif\n");
-	// #endif
+	size_t name = result.find("void");
+	if(name == std::string::npos) throw std::runtime_error("Could not find function name.");
+	name = result.find("(", name);
+	if(name == std::string::npos) throw std::runtime_error("Could not find function name.");
+	while(name > 0 && std::isspace(static_cast<unsigned char>(result[name-1]))) --name;
+	result.insert(name, ocl::Kernel::mangle(completed));
+	return result;
+}
 
+/*! \brief Returns the arguments extended by the default arguments of the remaining template parameters.
+  *
+  * For template<class T, int TILE = 16> and the argument float, float and 16 are returned.
+  * Throws if an argument is missing for a parameter without default argument or if
+  * too many arguments are given.
+*/
+std::vector<std::string> ocl::Kernel::completeArguments(const std::string &kernel, const std::vector<std::string> &arguments)
+{
+	const std::vector<std::string> declarations = ocl::Kernel::templateDeclarations(kernel);
+	if(arguments.size() > declarations.size())
+		throw std::runtime_error("Kernel expects " + std::to_string(declarations.size()) + " template arguments but " + std::to_string(arguments.size()) + " were given.");
+
+	const std::vector<std::string> parameters = ocl::Kernel::extractParameters(kernel);
+	auto isIdentifier = [](char c){ return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+
+	std::vector<std::string> completed = arguments;
+	for(size_t i = arguments.size(); i < declarations.size(); ++i){
+		const size_t assign = declarations[i].find('=');
+		if(assign == std::string::npos)
+			throw std::runtime_error("Kernel expects " + std::to_string(declarations.size()) + " template arguments but " + std::to_string(arguments.size()) + " were given.");
+		const size_t first = declarations[i].find_first_not_of(" \t\r\n", assign + 1);
+		const size_t last = declarations[i].find_last_not_of(" \t\r\n");
+		if(first == std::string::npos) throw std::runtime_error("Template not correctly defined.");
+		const std::string value = declarations[i].substr(first, last - first + 1);
+
+		// default arguments may refer to preceding parameters.
+		std::string argument;
+		for(size_t pos = 0; pos < value.size(); ){
+			if(!isIdentifier(value[pos])){ argument += value[pos++]; continue; }
+			size_t next = pos;
+			while(next < value.size() && isIdentifier(value[next])) ++next;
+			const std::string token = value.substr(pos, next - pos);
+			const auto it = std::find(parameters.begin(), parameters.begin() + i, token);
+			argument += it != parameters.begin() + i ? completed[it - parameters.begin()] : token;
+			pos = next;
+		}
+		completed.push_back(argument);
+	}
+	return completed;
+}
 
-	size_t pos = 0;
+/*! \brief Returns the suffix that is appended to the name of a kernel function specialized with the arguments.
+  *
+  * Each argument is appended with a leading underscore. Characters which are
+  * not valid within identifiers are replaced, e.g. unsigned int becomes unsigned_int
+  * and -1 becomes m1.
+*/
+std::string ocl::Kernel::mangle(const std::vector<std::string> &arguments)
+{
+	std::string suffix;
+	for(const auto &a : arguments){
+		suffix += "_";
+		for(char c : a){
+			if(std::isalnum(static_cast<unsigned char>(c)) || c == '_') suffix += c;
+			else if(c == '-') suffix += 'm';
+			else if(c == '.') suffix += 'p';
+			else if(c == '*') suffix += "ptr";
+			else if(std::isspace(static_cast<unsigned char>(c))) { if(suffix.back() != '_') suffix += '_'; }
+		}
+	}
+	return suffix;
+}
 
-	pos = fct.find("void", pos);
-
-	pos = fct.find("(", pos, 1);
-//	assert(pos >= fct.length());
-	assert(pos < fct.length());
-	fct.insert(pos++,"_",1);
-	//fct.insert(pos,type.name());
-	fct.insert(pos,type);
-	//pos += type.name().length();
-	pos += type.length();
-
-	const string s1 = temp_param + " ";
-	const string s2 = temp_param + "*";
-	const string s3 = temp_param + "&";
-	const string s4 = temp_param + ")";
-
-	while(pos < fct.length()){
-		int pos1 = fct.find(s1, pos); if(pos1 == (int)string::npos) pos1 = fct.length();
-		int pos2 = fct.find(s2, pos); if(pos2 == (int)string::npos) pos2 = fct.length();
-		int pos3 = fct.find(s3, pos); if(pos3 == (int)string::npos) pos3 = fct.length();
-		int pos4 = fct.find(s4, pos); if(pos4 == (int)string::npos) pos4 = fct.length();
-
-		pos = std::min(std::min(std::min(pos1,pos2),pos3),pos4);
-		if(pos >= fct.length()) break;
-		fct.replace(pos, temp_param.length() , type);//type.name());
-
-		//pos += type.name().length();
-		pos += type.length();
+/*! \brief Returns the names of the template parameters of the kernel function in declaration order.
+  *
+  * For template<class T, class Acc, int TILE> the names T, Acc and TILE are returned.
+  * Returns an empty vector if the kernel function is not templated.
+*/
+std::vector<std::string> ocl::Kernel::extractParameters(const std::string& kernel)
+{
+	std::vector<std::string> names;
+	for(const auto &declaration : ocl::Kernel::templateDeclarations(kernel)){
+		const std::string d = declaration.substr(0, declaration.find('='));
+		const size_t last  = d.find_last_not_of(" \t\r\n");
+		size_t first = last;
+		while(first > 0 && (std::isalnum(static_cast<unsigned char>(d[first-1])) || d[first-1] == '_')) --first;
+		names.push_back(d.substr(first, last - first + 1));
 	}
+	return names;
+}
 
-	return fct;
+/*! \brief Returns true if the template parameter at the specified position is a type parameter.
+  *
+  * Type parameters are declared with class or typename. Other parameters
+  * such as int TILE are non-type parameters.
+*/
+bool ocl::Kernel::typeParameter(const std::string& kernel, size_t pos)
+{
+	const std::vector<std::string> declarations = ocl::Kernel::templateDeclarations(kernel);
+	if(pos >= declarations.size()) throw std::runtime_error("Template parameter " + std::to_string(pos) + " does not exist.");
+	std::istringstream stream(declarations[pos]);
+	std::string keyword;
+	stream >> keyword;
+	return keyword == "class" || keyword == "typename";
 }
 
+/*! \brief Returns the parameter declarations of the template of the kernel function.
+  *
+  * The template must precede the kernel keyword. If specified, start and end
+  * are set to the positions of the template keyword and the closing bracket.
+*/
+std::vector<std::string> ocl::Kernel::templateDeclarations(const std::string& kernel, size_t *start, size_t *end)
+{
+	std::vector<std::string> declarations;
+
+	const size_t t = kernel.find("template");
+	const size_t k = kernel.find("kernel");
+	if(t == std::string::npos || (k != std::string::npos && k < t)) return declarations;
+
+	const size_t open = kernel.find('<', t);
+	if(open == std::string::npos) throw std::runtime_error("Template not correctly defined.");
+	if(kernel.find_first_not_of(" \t\r\n", t + 8) != open) return declarations;
+
+	// Brackets are matched by depth, so that default arguments may contain '<', '>' and ','.
+	// Like in C++, a '>' within a default argument must be enclosed in parentheses.
+	size_t angles = 1, parens = 0, begin = open + 1, close = open + 1;
+	for(; close < kernel.size(); ++close){
+		const char c = kernel[close];
+		if(c == '(') ++parens;
+		else if(c == ')' && parens > 0) --parens;
+		else if(parens > 0) continue;
+		else if(c == '<') ++angles;
+		else if(c == '>' && --angles == 0) break;
+		else if(c == ',' && angles == 1){
+			declarations.push_back(kernel.substr(begin, close - begin));
+			begin = close + 1;
+		}
+	}
+	if(close == kernel.size()) throw std::runtime_error("Template not correctly defined.");
+	declarations.push_back(kernel.substr(begin, close - begin));
+
+	for(const auto &d : declarations)
+		if(d.find_first_not_of(" \t\r\n") == std::string::npos) throw std::runtime_error("Template not correctly defined.");
 
+	if(start != nullptr) *start = t;
+	if(end != nullptr) *end = close;
+	return declarations;
+}
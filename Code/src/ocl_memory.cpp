@@ -20,6 +20,9 @@
 #include <ocl_query.h>
 #include <ocl_queue.h>
 #include <ocl_platform.h>
+#include <ocl_event_list.h>
+#include <ocl_dependency_tracker.h>
+#include <ocl_profiler.h>
 
 /*! \brief Instantiates this Device Memory  within a Context with size_bytes.
   *
@@ -88,6 +91,8 @@ ocl::Memory::Memory (Memory && other ) :
 ocl::Memory::~Memory ()
 {
     this->release();
+    // a Memory without an id, e.g. if the constructor of a subclass threw, is still registered.
+    if(_ctxt != nullptr) _ctxt->remove(this);
 }
 
 /*! \brief Copies a Device Memory from another Device Memory.
@@ -172,6 +177,7 @@ void ocl::Memory::release()
 	if(this->_id == 0) return;
 
 	OPENCL_SAFE_CALL( clReleaseMemObject(_id) );
+	if(_ctxt->dependencyTracker() != nullptr) _ctxt->dependencyTracker()->forget(_id);
 	_ctxt->remove(const_cast<ocl::Memory*>(this));
 	this->_id = 0;
 }
@@ -183,11 +189,53 @@ void ocl::Memory::release()
 void ocl::Memory::unmap ( void * mapped_ptr ) const
 {
     if(map_count() > 0){
-        OPENCL_SAFE_CALL( clEnqueueUnmapMemObject (this->activeQueue().id(), this->_id, mapped_ptr, 0, NULL, NULL) );
-        OPENCL_SAFE_CALL( clFinish(this->activeQueue().id()) );
+        const ocl::Queue &queue = this->activeQueue();
+        OPENCL_SAFE_CALL( clEnqueueUnmapMemObject (queue.id(), this->_id, mapped_ptr, 0, NULL, NULL) );
+        OPENCL_SAFE_CALL( clFinish(queue.id()) );
     }
 }
 
+/*! \brief Migrates this Memory to the Device of the Queue.
+  *
+  * Use it to hint that the Memory should be placed close to a sub-device, e.g. into
+  * the NUMA node on which the sub-device is located, before the Kernel executions start.
+  * The OpenCL implementation decides where the Memory is actually placed.
+  * The operation forces that all commands within the Queue including this one are completed.
+  *
+  * \param queue is a command queue whose Device receives the Memory.
+  * \param discard is true if the content of the Memory need not be preserved, e.g. for output Memory.
+  * \param list contains all events for which this command has to wait.
+  */
+void ocl::Memory::migrate ( const ocl::Queue &queue, bool discard, const ocl::EventList &list ) const
+{
+	OCL_ASSERT(*this->context() == queue.context(), "context of this and queue must be equal");
+	const cl_mem_migration_flags flags = discard ? CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED : 0;
+	this->execute(list, Memory::ReadWrite, nullptr, [&](const ocl::EventList &events){
+		OPENCL_SAFE_CALL( clEnqueueMigrateMemObjects (queue.id(), 1, &this->_id, flags, events.size(), events.data(), NULL) );
+		OPENCL_SAFE_CALL( clFinish(queue.id()) );
+	});
+}
+
+/*! \brief Migrates this Memory asynchronously to the Device of the Queue.
+  *
+  * \param queue is a command queue whose Device receives the Memory.
+  * \param discard is true if the content of the Memory need not be preserved, e.g. for output Memory.
+  * \param list contains all events for which this command has to wait.
+  * \return event which can be integrated into other EventList.
+  */
+ocl::Event ocl::Memory::migrateAsync ( const ocl::Queue &queue, bool discard, const ocl::EventList &list ) const
+{
+	OCL_ASSERT(*this->context() == queue.context(), "context of this and queue must be equal");
+	const cl_mem_migration_flags flags = discard ? CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED : 0;
+	cl_event event_id;
+	ocl::Event event = this->enqueue(list, Memory::ReadWrite, nullptr, [&](const ocl::EventList &events) -> ocl::Event {
+		OPENCL_SAFE_CALL( clEnqueueMigrateMemObjects (queue.id(), 1, &this->_id, flags, events.size(), events.data(), &event_id) );
+		return ocl::Event(event_id, this->context());
+	});
+	this->profile(event, this->size_bytes());
+	return event;
+}
+
 /*! \brief Returns the number of mappings of the Device Memory to the host Memory.
   *
   * Each time a Buffer or Image is mapped into the host Memory, the
@@ -238,6 +286,48 @@ ocl::Queue& ocl::Memory::activeQueue() const
     return this->context()->activeQueue();
 }
 
+/*! \brief Enqueues a command using this Memory and dest and returns its Event.
+  *
+  * The command is called with the list itself if the Context has no DependencyTracker
+  * so that no events are copied. Otherwise, it is called with the events of the list
+  * together with the events of the commands using this Memory and dest on which it
+  * depends, and its Event is recorded by the DependencyTracker.
+  *
+  * \param list contains the events provided by the user.
+  * \param access specifies how the command uses this Memory.
+  * \param dest is a Memory object written by the same command such as the destination of a copy or nullptr.
+  * \param command enqueues the command and returns its Event.
+  */
+ocl::Event ocl::Memory::enqueue(const EventList &list, Access access, const Memory *dest, const std::function<Event(const EventList&)> &command) const
+{
+	ocl::DependencyTracker *tracker = this->context()->dependencyTracker();
+	if(tracker == nullptr) return command(list);
+	ocl::DependencyTracker::Uses uses(1, std::make_pair(this->id(), access));
+	if(dest != nullptr) uses.push_back(std::make_pair(dest->id(), WriteOnly));
+	return tracker->enqueue(uses, list, command);
+}
+
+/*! \brief Executes a blocking command using this Memory and dest.
+  *
+  * Same as enqueue except that the command completes before it returns.
+  */
+void ocl::Memory::execute(const EventList &list, Access access, const Memory *dest, const std::function<void(const EventList&)> &command) const
+{
+	ocl::DependencyTracker *tracker = this->context()->dependencyTracker();
+	if(tracker == nullptr){ command(list); return; }
+	ocl::DependencyTracker::Uses uses(1, std::make_pair(this->id(), access));
+	if(dest != nullptr) uses.push_back(std::make_pair(dest->id(), WriteOnly));
+	tracker->execute(uses, list, command);
+}
+
+/*! \brief Records the Event of an enqueued command transferring size_bytes if the Context has a Profiler. */
+void ocl::Memory::profile(const Event &event, size_t size_bytes) const
+{
+	ocl::Profiler *profiler = this->context()->profiler();
+	if(profiler == nullptr) return;
+	profiler->record(event, std::string(), size_bytes);
+}
+
 ///*! \brief Returns the active Device of the active Queue with which this Memory was created. */
 //const ocl::Device& ocl::Memory::activeDevice() const
 //{
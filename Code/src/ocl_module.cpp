@@ -0,0 +1,172 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+#include <ocl_module.h>
+
+
+/*! \brief Instantiates an empty Module. */
+ocl::Module::Module() :
+	_name(), _source(), _includes(), _hash(std::hash<std::string>()(std::string()))
+{
+}
+
+/*! \brief Instantiates a Module with the specified name and source.
+  *
+  * The names of the modules included by #include directives are stored.
+*/
+ocl::Module::Module(const std::string &name, const std::string &source) :
+	_name(name), _source(source), _includes(), _hash(std::hash<std::string>()(source))
+{
+	stripIncludes(source, &_includes);
+}
+
+/*! \brief Returns the name of this Module. */
+const std::string& ocl::Module::name() const
+{
+	return _name;
+}
+
+/*! \brief Returns the source of this Module. */
+const std::string& ocl::Module::source() const
+{
+	return _source;
+}
+
+/*! \brief Returns the names of the modules included by this Module. */
+const std::vector<std::string>& ocl::Module::includes() const
+{
+	return _includes;
+}
+
+/*! \brief Returns the hash of the source of this Module. */
+size_t ocl::Module::hash() const
+{
+	return _hash;
+}
+
+/*! \brief Returns the Module with the specified name from the first matching search path.
+  *
+  * The paths are searched in order followed by the working directory.
+  * Modules are cached by their path. The file is only read again if its
+  * modification time or size changed. The cached Module is kept if the
+  * content hash of the file did not change.
+*/
+std::shared_ptr<const ocl::Module> ocl::Module::load(const std::string &name, const std::vector<std::string> &paths)
+{
+	struct Entry { time_t modified; off_t size; std::shared_ptr<const Module> module; };
+	static std::mutex mutex;
+	static std::map<std::string, Entry> cache;
+
+	const std::string path = locate(name, paths);
+	if(path.empty()) throw std::runtime_error( "Could not find module " + name + " in the search paths.");
+
+	struct stat status;
+	if(stat(path.c_str(), &status) != 0) throw std::runtime_error( "Could not open module " + path);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto found = cache.find(path);
+	if(found != cache.end() && found->second.modified == status.st_mtime && found->second.size == status.st_size)
+		return found->second.module;
+
+	std::ifstream file(path.c_str());
+	if(file.fail()) throw std::runtime_error( "Could not open module " + path);
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	const std::string source = buffer.str();
+
+	if(found != cache.end() && found->second.module->hash() == std::hash<std::string>()(source)){
+		found->second.modified = status.st_mtime;
+		found->second.size = status.st_size;
+		return found->second.module;
+	}
+
+	std::shared_ptr<const Module> module = std::make_shared<Module>(name, source);
+	if(found != cache.end())
+		found->second = Entry{ status.st_mtime, status.st_size, module };
+	else
+		cache.insert(std::make_pair(path, Entry{ status.st_mtime, status.st_size, module }));
+	return module;
+}
+
+/*! \brief Returns the path of the Module file with the specified name or an empty string.
+  *
+  * The paths are searched in order followed by the working directory.
+*/
+std::string ocl::Module::locate(const std::string &name, const std::vector<std::string> &paths)
+{
+	std::vector<std::string> candidates;
+	for(const auto &p : paths)
+		candidates.push_back(p.empty() || p[p.size()-1] == '/' ? p + name : p + "/" + name);
+	candidates.push_back(name);
+
+	for(const auto &path : candidates){
+		struct stat status;
+		if(stat(path.c_str(), &status) == 0 && S_ISREG(status.st_mode)) return path;
+	}
+	return std::string();
+}
+
+/*! \brief Returns the source without #include directives.
+  *
+  * Each directive is replaced by an empty line so that line numbers
+  * of build logs are kept. If includes is not null, the names of the
+  * removed modules are appended to it in order of their appearance.
+  * If resolvable is specified, only directives naming modules for which
+  * it returns true are removed.
+*/
+std::string ocl::Module::stripIncludes(const std::string &source, std::vector<std::string> *includes,
+                                       const std::function<bool(const std::string&)> &resolvable)
+{
+	std::string result;
+	result.reserve(source.size());
+
+	size_t pos = 0;
+	while(pos < source.size()){
+		size_t end = source.find('\n', pos);
+		if(end == std::string::npos) end = source.size();
+
+		size_t i = source.find_first_not_of(" \t", pos);
+		bool directive = false;
+		if(i < end && source[i] == '#'){
+			i = source.find_first_not_of(" \t", i+1);
+			if(i < end && source.compare(i, 7, "include") == 0){
+				i = source.find_first_not_of(" \t", i+7);
+				const char close = i < end && source[i] == '<' ? '>' : '"';
+				const size_t last = i < end ? source.find(close, i+1) : std::string::npos;
+				if(i < end && (source[i] == '"' || source[i] == '<') && last < end){
+					const std::string name = source.substr(i+1, last-i-1);
+					directive = !resolvable || resolvable(name);
+					if(directive && includes) includes->push_back(name);
+				}
+			}
+		}
+
+		if(!directive) result.append(source, pos, end-pos);
+		if(end < source.size()) result += '\n';
+		pos = end + 1;
+	}
+	return result;
+}
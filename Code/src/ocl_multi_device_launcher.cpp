@@ -0,0 +1,326 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include <ocl_multi_device_launcher.h>
+#include <ocl_buffer.h>
+#include <ocl_context.h>
+#include <ocl_device.h>
+#include <ocl_query.h>
+
+
+/*! \brief Instantiates this MultiDeviceLauncher with one Queue for each Device of the Context.
+  *
+  * The Queue objects are created with profiling enabled in order to measure
+  * the throughput of each Device.
+  *
+  * \param ctxt is the Context whose Device objects execute the Kernel.
+  * \param properties are the properties of each Queue.
+  */
+ocl::MultiDeviceLauncher::MultiDeviceLauncher(Context &ctxt, Queue::props properties) :
+	_context(&ctxt), _adaptation(0.5), _slots(), _transfers(), _replicas()
+{
+	if(ctxt.devices().empty()) throw std::runtime_error( "Context has no Device");
+	for(const auto &device : ctxt.devices())
+		_slots.emplace_back( new Slot( new Queue(ctxt, device, properties | CL_QUEUE_PROFILING_ENABLE) ) );
+}
+
+/*! \brief Destructs this MultiDeviceLauncher.
+  *
+  * Waits until all commands of its Queue objects are completed.
+  */
+ocl::MultiDeviceLauncher::~MultiDeviceLauncher()
+{
+	this->finish();
+}
+
+/*! \brief Returns the number of Device objects. */
+size_t ocl::MultiDeviceLauncher::size() const
+{
+	return _slots.size();
+}
+
+/*! \brief Returns the Queue of the Device at the position. */
+ocl::Queue& ocl::MultiDeviceLauncher::queue(size_t pos) const
+{
+	if(pos >= _slots.size()) throw std::out_of_range( "MultiDeviceLauncher position out of range");
+	return *_slots[pos]->queue;
+}
+
+/*! \brief Returns the Device at the position. */
+const ocl::Device& ocl::MultiDeviceLauncher::device(size_t pos) const
+{
+	return this->queue(pos).device();
+}
+
+/*! \brief Returns the fraction of the index space executed by the Device at the position in the last call. */
+double ocl::MultiDeviceLauncher::share(size_t pos) const
+{
+	if(pos >= _slots.size()) throw std::out_of_range( "MultiDeviceLauncher position out of range");
+	return _slots[pos]->share;
+}
+
+/*! \brief Returns the measured throughput of the Device at the position in indices per nanosecond.
+  *
+  * The throughput is zero as long as no execution of the Device has been measured.
+  */
+double ocl::MultiDeviceLauncher::throughput(size_t pos) const
+{
+	if(pos >= _slots.size()) throw std::out_of_range( "MultiDeviceLauncher position out of range");
+	return _slots[pos]->throughput;
+}
+
+/*! \brief Returns the Context of this MultiDeviceLauncher. */
+ocl::Context& ocl::MultiDeviceLauncher::context() const
+{
+	return *_context;
+}
+
+/*! \brief Sets the weight of a new measurement for the throughput.
+  *
+  * The throughput is the exponential moving average of the measurements.
+  * A rate of one only considers the last measurement.
+  */
+void ocl::MultiDeviceLauncher::setAdaptation(double rate)
+{
+	if(rate <= 0.0 || rate > 1.0) throw std::runtime_error( "Adaptation rate must be within (0,1]");
+	_adaptation = rate;
+}
+
+/*! \brief Returns the weight of a new measurement for the throughput. */
+double ocl::MultiDeviceLauncher::adaptation() const
+{
+	return _adaptation;
+}
+
+/*! \brief Registers a Buffer which is written from the host before each execution.
+  *
+  * Each Device writes the slice of its part of the index space.
+  * The host data and the Buffer start at the global ID zero.
+  *
+  * \param buffer is written for each part.
+  * \param data is the host data mirroring the whole Buffer.
+  * \param bytesPerIndex is the number of bytes per index in the split dimension, e.g. the row size for 2D.
+  */
+void ocl::MultiDeviceLauncher::scatter(const Buffer &buffer, const void *data, size_t bytesPerIndex)
+{
+	if(data == nullptr || bytesPerIndex == 0) throw std::runtime_error( "Host data not valid");
+	if(*buffer.context() != *_context) throw std::runtime_error( "Buffer has a different Context");
+	this->replicate(buffer);
+	Transfer transfer = { &buffer, data, nullptr, bytesPerIndex, buffer.size_bytes() };
+	_transfers.push_back(transfer);
+}
+
+/*! \brief Registers a Buffer which is read into the host after each execution.
+  *
+  * Each Device reads the slice of its part of the index space.
+  * See scatter(const Buffer&, const void*, size_t).
+  */
+void ocl::MultiDeviceLauncher::gather(const Buffer &buffer, void *data, size_t bytesPerIndex)
+{
+	if(data == nullptr || bytesPerIndex == 0) throw std::runtime_error( "Host data not valid");
+	if(*buffer.context() != *_context) throw std::runtime_error( "Buffer has a different Context");
+	this->replicate(buffer);
+	Transfer transfer = { &buffer, nullptr, data, bytesPerIndex, buffer.size_bytes() };
+	_transfers.push_back(transfer);
+}
+
+/*! \brief Removes all registered Buffer objects. */
+void ocl::MultiDeviceLauncher::clearTransfers()
+{
+	this->finish();
+	_transfers.clear();
+	_replicas.clear();
+}
+
+/*! \brief Waits until the commands of all Queue objects are completed. */
+void ocl::MultiDeviceLauncher::finish() const
+{
+	for(const auto &slot : _slots)
+		slot->queue->finish();
+}
+
+/*! \brief Creates a Buffer of the same size for each further Device if the Buffer is not registered yet. */
+void ocl::MultiDeviceLauncher::replicate(const Buffer &buffer)
+{
+	if(_replicas.count(&buffer)) return;
+	const cl_mem_flags access = buffer.flags() & (CL_MEM_READ_WRITE | CL_MEM_WRITE_ONLY | CL_MEM_READ_ONLY);
+	std::vector< std::unique_ptr<Buffer> > &replicas = _replicas[&buffer];
+	for(size_t i = 1; i < _slots.size(); ++i)
+		replicas.emplace_back( new Buffer(*_context, buffer.size_bytes(), access ? Buffer::Access(access) : Buffer::ReadWrite) );
+}
+
+/*! \brief Returns the Buffer used by the Device at the position instead of the registered Buffer. */
+const ocl::Buffer& ocl::MultiDeviceLauncher::buffer(size_t pos, const Buffer &buffer) const
+{
+	const auto it = _replicas.find(&buffer);
+	if(pos == 0 || it == _replicas.end()) return buffer;
+	return *it->second[pos - 1];
+}
+
+/*! \brief Replaces the OpenCL memory object of a registered Buffer by the one of the Device at the position. */
+cl_mem ocl::MultiDeviceLauncher::argument(size_t pos, cl_mem mem) const
+{
+	if(pos == 0) return mem;
+	for(const auto &replica : _replicas)
+		if(replica.first->id() == mem) return replica.second[pos - 1]->id();
+	return mem;
+}
+
+/*! \brief Replaces a registered Buffer by the one of the Device at the position. */
+const ocl::Buffer& ocl::MultiDeviceLauncher::argument(size_t pos, const Buffer &buffer) const
+{
+	return this->buffer(pos, buffer);
+}
+
+/*! \brief Updates the throughput of each Device with its completed executions. */
+void ocl::MultiDeviceLauncher::measure()
+{
+	for(const auto &slot : _slots){
+		std::vector<Sample> pending;
+		for(const Sample &sample : slot->pending){
+			if(!sample.last.isCompleted()){
+				pending.emplace_back(sample.first, sample.last, sample.count);
+				continue;
+			}
+			const size_t start = sample.first.startTime(), end = sample.last.finishTime();
+			if(end <= start) continue;
+			const double measured = double(sample.count) / double(end - start);
+			slot->throughput = slot->throughput == 0.0 ? measured : (1.0 - _adaptation) * slot->throughput + _adaptation * measured;
+		}
+		slot->pending.swap(pending);
+	}
+}
+
+/*! \brief Splits the index space of the Kernel into one part for each Device.
+  *
+  * Each Device gets at least one work-group if there are enough of them.
+  * Devices which have not been measured yet are weighted with their estimated
+  * throughput scaled by the ratio of measured to estimated throughput of the others.
+*/
+std::vector<ocl::MultiDeviceLauncher::Part> ocl::MultiDeviceLauncher::partition(const Kernel &kernel)
+{
+	this->measure();
+
+	if(kernel.workDim() == 0) throw std::runtime_error( "Kernel has no work dimension");
+	const size_t dim = kernel.workDim() - 1;
+	const size_t global = kernel.globalSize(dim);
+	const size_t local = std::max<size_t>(kernel.localSize(dim), 1);
+	const size_t groups = (global + local - 1) / local;
+	const size_t n = _slots.size();
+
+	std::vector<double> weights(n);
+	double measured = 0.0, estimated = 0.0;
+	for(size_t i = 0; i < n; ++i){
+		const ocl::DeviceInfo &info = _slots[i]->queue->device().info();
+		weights[i] = double(std::max<size_t>(info.maxComputeUnits(), 1) * std::max<size_t>(info.maxClockFrequency(), 1));
+		if(_slots[i]->throughput == 0.0) continue;
+		measured += _slots[i]->throughput;
+		estimated += weights[i];
+	}
+	for(size_t i = 0; i < n; ++i){
+		if(measured == 0.0) break;
+		weights[i] = _slots[i]->throughput > 0.0 ? _slots[i]->throughput : weights[i] * measured / estimated;
+	}
+	const double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+
+	std::vector<size_t> counts(n, 0);
+	double sum = 0.0;
+	size_t assigned = 0;
+	for(size_t i = 0; i < n; ++i){
+		sum += weights[i];
+		const size_t end = i + 1 == n ? groups : std::min(groups, size_t(double(groups) * sum / total + 0.5));
+		counts[i] = end - std::min(end, assigned);
+		assigned = std::max(end, assigned);
+	}
+	if(groups >= n){
+		for(size_t i = 0; i < n; ++i){
+			if(counts[i] > 0) continue;
+			auto largest = std::max_element(counts.begin(), counts.end());
+			--*largest;
+			++counts[i];
+		}
+	}
+
+	std::vector<Part> parts;
+	size_t offset = 0;
+	for(size_t i = 0; i < n; ++i){
+		const size_t count = std::min(counts[i] * local, global - offset);
+		_slots[i]->share = global > 0 ? double(count) / double(global) : 0.0;
+		if(count == 0) continue;
+		Part part = { i, dim, kernel.globalOffset(dim), offset, count, global };
+		parts.push_back(part);
+		offset += count;
+	}
+	return parts;
+}
+
+/*! \brief Writes the slices of the scattered Buffer objects for the part. */
+ocl::EventList ocl::MultiDeviceLauncher::write(const Part &part) const
+{
+	const Queue &queue = *_slots[part.pos]->queue;
+	EventList events;
+	for(const Transfer &t : _transfers){
+		if(t.source == nullptr) continue;
+		const size_t begin = (part.base + part.offset) * t.bytesPerIndex;
+		if(begin >= t.size) continue;
+		const size_t bytes = std::min(part.count * t.bytesPerIndex, t.size - begin);
+		events << this->buffer(part.pos, *t.buffer).writeAsync(queue, begin, static_cast<const char*>(t.source) + begin, bytes);
+	}
+	return events;
+}
+
+/*! \brief Reads the slices of the gathered Buffer objects for the part after the execution.
+  *
+  * Returns the last commands of the part which are
+  * measured once they are completed.
+*/
+ocl::EventList ocl::MultiDeviceLauncher::read(const Part &part, const EventList &writes, const Event &execution)
+{
+	Slot &slot = *_slots[part.pos];
+	EventList events;
+	for(const Transfer &t : _transfers){
+		if(t.target == nullptr) continue;
+		const size_t begin = (part.base + part.offset) * t.bytesPerIndex;
+		if(begin >= t.size) continue;
+		const size_t bytes = std::min(part.count * t.bytesPerIndex, t.size - begin);
+		events << this->buffer(part.pos, *t.buffer).readAsync(*slot.queue, begin, static_cast<char*>(t.target) + begin, bytes, EventList(execution));
+	}
+	if(events.isEmpty()) events << execution;
+
+	const Event first = writes.isEmpty() ? execution : writes.at(0);
+	slot.pending.emplace_back(first, events.at(events.size() - 1), part.count);
+	return events;
+}
+
+/*! \brief Sets the index space of the Kernel to the part. */
+void ocl::MultiDeviceLauncher::setRange(Kernel &kernel, const Part &part) const
+{
+	kernel.setGlobalOffset(part.base + part.offset, part.dim);
+	kernel.setGlobalSize(part.count, part.dim);
+}
+
+/*! \brief Restores the index space of the Kernel. */
+void ocl::MultiDeviceLauncher::restore(Kernel &kernel, const std::vector<Part> &parts) const
+{
+	if(parts.empty()) return;
+	kernel.setGlobalOffset(parts.front().base, parts.front().dim);
+	kernel.setGlobalSize(parts.front().global, parts.front().dim);
+}
@@ -53,10 +53,6 @@ ocl::Platform::Platform(cl_platform_id id) :
 {
 	if(!ocl::exists(id)) throw std::runtime_error("Platform does not exist");
     this->create(id);
-    const std::vector<cl_device_id>& devs = ocl::devices(id);
-    for(auto it = devs.begin(); it != devs.end(); ++it){
-        this->_devices.push_back(ocl::Device(*it));
-    }
 }
 
 /*! \brief Instantiates this Platform which has the specified DeviceType.
@@ -97,14 +93,17 @@ ocl::Platform::Platform(const ocl::DeviceTypes &types) :
 /*! \brief Destructes this Platform.  */
 ocl::Platform::~Platform()
 {
-    for(auto c : this->_contexts)
+    for(auto c : this->_contexts.take())
         c->release();
+    active().reset(this);
 }
 
 
 /*! \brief Assigns the specified OpenCL platform to this Platform and
   *  finds all Device objects associated with this Platform.
   *
+  * The platforms and devices are enumerated once for each process. See PlatformInfo.
+  *
   * Note that this Platform should not be created before.
 */
 void ocl::Platform::create(cl_platform_id id)
@@ -113,7 +112,7 @@ void ocl::Platform::create(cl_platform_id id)
 	if(id == 0) throw std::runtime_error("Platform is not valid.");
 	if(!ocl::exists(id)) throw std::runtime_error("Platform does not exist.");
 
-	if(!this->_contexts.empty()) throw std::runtime_error("Cannot create an already created platform. Context not empty.");
+	if(this->_contexts.size() > 0) throw std::runtime_error("Cannot create an already created platform. Context not empty.");
 	if(!this->_devices.empty()) throw std::runtime_error("Cannot create an already created platform.");
 
     this->_id = id;
@@ -322,7 +321,7 @@ void ocl::Platform::print(bool print_devices,
 /*! \brief Returns true if this Platform contains the specified Context. */
 bool ocl::Platform::has(ocl::Context & ctxt) const
 {
-    return this->_contexts.find(&ctxt) != this->_contexts.end();
+    return this->_contexts.contains(&ctxt);
 }
 
 /*! \brief Sets an active Context for this Platform
@@ -332,31 +331,34 @@ bool ocl::Platform::has(ocl::Context & ctxt) const
   * are constructed without a Context. In this case
   * an active Context within the active Platform is considered.
   * These objects cannot be created without a valid Context.
+  * The Context becomes active for the calling thread.
   *
 */
 void ocl::Platform::setActiveContext(ocl::Context &ctxt)
 {
 	if(!this->has(ctxt)) throw std::runtime_error("Context not in Platform.");
-    this->_activeContext = &ctxt;
+    this->_activeContext.set(&ctxt);
 }
 
-/*! \brief Returns the active Context of this Platform. */
+/*! \brief Returns the active Context of the calling thread. */
 ocl::Context* ocl::Platform::activeContext() const
 {
-	if(_activeContext == nullptr) throw std::runtime_error("There is no active Context");
-    return this->_activeContext;
+	ocl::Context *ctxt = this->_activeContext.get();
+	if(ctxt == nullptr) throw std::runtime_error("There is no active Context");
+    return ctxt;
 }
 
-/*! \brief Returns true if the specified Context is an active Context of this Platform. */
+/*! \brief Returns true if the specified Context is the active Context of the calling thread. */
 bool ocl::Platform::isActiveContext(ocl::Context &ctxt) const
 {
-    return this->_activeContext->id() == ctxt.id();
+	ocl::Context *active = this->_activeContext.get();
+    return active != nullptr && active->id() == ctxt.id();
 }
 
-/*! \brief Returns true if this Platform has an active Context. */
+/*! \brief Returns true if this Platform has an active Context for the calling thread. */
 bool ocl::Platform::hasActiveContext() const
 {
-    return this->_activeContext != 0;
+    return this->_activeContext.get() != 0;
 }
 
 /*! \brief Inserts the specified Context into this Platform.
@@ -386,20 +388,32 @@ void ocl::Platform::insert(ocl::Context &ctxt)
 */
 bool ocl::Platform::hasActivePlatform()
 {
-    return _activePlatform != 0;
+    return active().get() != 0;
 }
 
-/*! \brief Sets an active Platform for this System. */
+/*! \brief Sets an active Platform for this System.
+  *
+  * The Platform becomes active for the calling thread.
+  */
 void ocl::Platform::setActivePlatform(Platform &plat)
 {
-    _activePlatform = &plat;
+    active().set(&plat);
 }
 
-/*! \brief Returns true if this System has an active Platform. */
+/*! \brief Returns the active Platform of the calling thread or null if there is none. */
 ocl::Platform* ocl::Platform::activePlatform()
 {
-    return _activePlatform;
+    return active().get();
 }
 
-ocl::Platform *ocl::Platform::_activePlatform = 0;
+/*! \brief Returns the active Platform objects.
+  *
+  * Constructed on first use and never destructed so that Platform
+  * objects with static storage duration may be set active and destructed.
+  */
+ocl::ActiveObject<ocl::Platform>& ocl::Platform::active()
+{
+    static ocl::ActiveObject<ocl::Platform> *platforms = new ocl::ActiveObject<ocl::Platform>();
+    return *platforms;
+}
 
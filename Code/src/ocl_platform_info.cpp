@@ -0,0 +1,224 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+
+#include <ocl_platform_info.h>
+#include <ocl_query.h>
+
+
+static std::string queryPlatformString(cl_platform_id id, cl_platform_info info)
+{
+	size_t size = 0;
+	OPENCL_SAFE_CALL( clGetPlatformInfo(id, info, 0, NULL, &size) );
+	if(size == 0) return std::string();
+	std::vector<char> buffer(size);
+	OPENCL_SAFE_CALL( clGetPlatformInfo(id, info, size, buffer.data(), NULL) );
+	return std::string(buffer.data());
+}
+
+static std::vector<cl_device_id> queryDevices(cl_platform_id id)
+{
+	cl_uint count = 0;
+	const cl_int status = clGetDeviceIDs(id, CL_DEVICE_TYPE_ALL, 0, NULL, &count);
+	if(status == CL_DEVICE_NOT_FOUND) return std::vector<cl_device_id>();
+	OPENCL_SAFE_CALL( status );
+	std::vector<cl_device_id> devices(count, nullptr);
+	if(count > 0) OPENCL_SAFE_CALL( clGetDeviceIDs(id, CL_DEVICE_TYPE_ALL, count, devices.data(), NULL) );
+	return devices;
+}
+
+static std::vector< std::shared_ptr<const ocl::PlatformInfo> > enumerate()
+{
+	cl_uint count = 0;
+	OPENCL_SAFE_CALL( clGetPlatformIDs(0, NULL, &count) );
+	std::vector<cl_platform_id> ids(count, nullptr);
+	if(count > 0) OPENCL_SAFE_CALL( clGetPlatformIDs(count, ids.data(), NULL) );
+
+	std::vector< std::shared_ptr<const ocl::PlatformInfo> > platforms;
+	for(cl_platform_id id : ids)
+		platforms.push_back(std::make_shared<const ocl::PlatformInfo>(id));
+	return platforms;
+}
+
+/*! \brief Cache of the enumerated platforms. */
+struct PlatformCache
+{
+	PlatformCache() : mutex(), enumerated(false), platforms() {}
+	std::mutex mutex;
+	bool enumerated;
+	std::vector< std::shared_ptr<const ocl::PlatformInfo> > platforms;
+};
+
+static PlatformCache& cache()
+{
+	// never destructed so that the cache can be used during static destruction.
+	static PlatformCache *c = new PlatformCache;
+	return *c;
+}
+
+
+/*! \brief Queries the OpenCL platform and the ids of its devices.
+  *
+  * The devices themselves are queried on the first call of deviceInfos() or deviceTypes().
+  * Use all() or get() in order to share the snapshot
+  * with Platform objects and the query functions.
+  *
+  * \param id is the OpenCL platform which is queried.
+  */
+ocl::PlatformInfo::PlatformInfo(cl_platform_id id) :
+	_id(id),
+	_profile(queryPlatformString(id, CL_PLATFORM_PROFILE)),
+	_version(queryPlatformString(id, CL_PLATFORM_VERSION)),
+	_name(queryPlatformString(id, CL_PLATFORM_NAME)),
+	_vendor(queryPlatformString(id, CL_PLATFORM_VENDOR)),
+	_extensions(queryPlatformString(id, CL_PLATFORM_EXTENSIONS)),
+	_versionMajor(0),
+	_versionMinor(0),
+	_devices(queryDevices(id)),
+	_deviceInfosOnce(),
+	_deviceInfos(),
+	_deviceTypesOnce(),
+	_deviceTypes(0)
+{
+	std::sscanf( _version.c_str(), "OpenCL %i.%i", &_versionMajor, &_versionMinor );
+}
+
+/*! \brief Returns the snapshots of all OpenCL platforms.
+  *
+  * The platforms are enumerated on the first call only.
+  * Concurrent first calls wait until the enumeration is completed.
+  */
+std::vector< std::shared_ptr<const ocl::PlatformInfo> > ocl::PlatformInfo::all()
+{
+	PlatformCache &c = cache();
+	std::lock_guard<std::mutex> lock(c.mutex);
+	if(!c.enumerated){
+		c.platforms = enumerate();
+		c.enumerated = true;
+	}
+	return c.platforms;
+}
+
+/*! \brief Returns the snapshot of the OpenCL platform.
+  *
+  * A platform which has not been enumerated is queried but not cached.
+  */
+std::shared_ptr<const ocl::PlatformInfo> ocl::PlatformInfo::get(cl_platform_id id)
+{
+	if(id == nullptr) throw std::runtime_error("invalid platform");
+	for(const auto &platform : all())
+		if(platform->id() == id) return platform;
+	return std::make_shared<const ocl::PlatformInfo>(id);
+}
+
+/*! \brief Enumerates all platforms and devices again.
+  *
+  * Snapshots obtained before remain valid. The capabilities of all devices are queried again.
+  */
+void ocl::PlatformInfo::refresh()
+{
+	PlatformCache &c = cache();
+	std::lock_guard<std::mutex> lock(c.mutex);
+	// release the old snapshots first so that the devices are queried again.
+	c.platforms.clear();
+	c.enumerated = false;
+	DeviceInfo::refresh();
+	c.platforms = enumerate();
+	c.enumerated = true;
+}
+
+/*! \brief Returns the OpenCL platform. */
+cl_platform_id ocl::PlatformInfo::id() const
+{
+	return _id;
+}
+
+/*! \brief Returns the profile, e.g. FULL_PROFILE. */
+const std::string& ocl::PlatformInfo::profile() const
+{
+	return _profile;
+}
+
+/*! \brief Returns the version string, e.g. OpenCL 1.2. */
+const std::string& ocl::PlatformInfo::version() const
+{
+	return _version;
+}
+
+/*! \brief Returns the name. */
+const std::string& ocl::PlatformInfo::name() const
+{
+	return _name;
+}
+
+/*! \brief Returns the vendor. */
+const std::string& ocl::PlatformInfo::vendor() const
+{
+	return _vendor;
+}
+
+/*! \brief Returns the extensions separated by spaces. */
+const std::string& ocl::PlatformInfo::extensions() const
+{
+	return _extensions;
+}
+
+/*! \brief Returns true if the version of the platform is at least major.minor. */
+bool ocl::PlatformInfo::supportsVersion(int major, int minor) const
+{
+	return _versionMajor > major || (_versionMajor == major && _versionMinor >= minor);
+}
+
+/*! \brief Returns all OpenCL devices of the platform. */
+const std::vector<cl_device_id>& ocl::PlatformInfo::devices() const
+{
+	return _devices;
+}
+
+/*! \brief Returns the snapshots of all OpenCL devices of the platform in the order of devices().
+  *
+  * The snapshots are obtained with DeviceInfo::get() on the first call.
+  */
+const std::vector< std::shared_ptr<const ocl::DeviceInfo> >& ocl::PlatformInfo::deviceInfos() const
+{
+	std::call_once(_deviceInfosOnce, [this]{
+		for(cl_device_id device : _devices)
+			_deviceInfos.push_back(ocl::DeviceInfo::get(device));
+	});
+	return _deviceInfos;
+}
+
+/*! \brief Returns the union of the types of all devices, e.g. CL_DEVICE_TYPE_CPU | CL_DEVICE_TYPE_GPU.
+  *
+  * Only the types are queried so that no DeviceInfo is created.
+  */
+cl_device_type ocl::PlatformInfo::deviceTypes() const
+{
+	std::call_once(_deviceTypesOnce, [this]{
+		for(cl_device_id device : _devices){
+			cl_device_type type = 0;
+			OPENCL_SAFE_CALL( clGetDeviceInfo(device, CL_DEVICE_TYPE, sizeof(type), &type, NULL) );
+			_deviceTypes |= type;
+		}
+	});
+	return _deviceTypes;
+}
@@ -0,0 +1,312 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+#include <ocl_profiler.h>
+#include <ocl_context.h>
+#include <ocl_device.h>
+#include <ocl_device_clock.h>
+#include <ocl_queue.h>
+#include <ocl_query.h>
+
+
+namespace {
+
+/*! \brief Timed command of the trace. */
+struct Entry
+{
+	const char *command;
+	const char *category;
+	const std::string *name;
+	size_t size_bytes;
+	size_t pid, tid;
+	cl_device_id domain; /**< Device whose clock the times are given in or null for host time. */
+	double queued, submitted, start, end;
+};
+
+/*! \brief Sets the command name and trace category of the OpenCL command type. */
+void describe(cl_command_type type, Entry &entry)
+{
+	switch(type)
+	{
+	case CL_COMMAND_NDRANGE_KERNEL       : entry.command = "ndrange kernel";       entry.category = "kernel";   break;
+	case CL_COMMAND_TASK                 : entry.command = "task";                 entry.category = "kernel";   break;
+	case CL_COMMAND_READ_BUFFER          : entry.command = "read buffer";          entry.category = "transfer"; break;
+	case CL_COMMAND_WRITE_BUFFER         : entry.command = "write buffer";         entry.category = "transfer"; break;
+	case CL_COMMAND_COPY_BUFFER          : entry.command = "copy buffer";          entry.category = "transfer"; break;
+	case CL_COMMAND_READ_IMAGE           : entry.command = "read image";           entry.category = "transfer"; break;
+	case CL_COMMAND_WRITE_IMAGE          : entry.command = "write image";          entry.category = "transfer"; break;
+	case CL_COMMAND_COPY_IMAGE           : entry.command = "copy image";           entry.category = "transfer"; break;
+	case CL_COMMAND_COPY_IMAGE_TO_BUFFER : entry.command = "copy image to buffer"; entry.category = "transfer"; break;
+	case CL_COMMAND_COPY_BUFFER_TO_IMAGE : entry.command = "copy buffer to image"; entry.category = "transfer"; break;
+	case CL_COMMAND_MAP_BUFFER           : entry.command = "map buffer";           entry.category = "map";      break;
+	case CL_COMMAND_MAP_IMAGE            : entry.command = "map image";            entry.category = "map";      break;
+	case CL_COMMAND_UNMAP_MEM_OBJECT     : entry.command = "unmap";                entry.category = "map";      break;
+	default                              : entry.command = "command";              entry.category = "other";    break;
+	}
+}
+
+/*! \brief Writes the string as JSON string. */
+void quote(std::ostream &out, const std::string &s)
+{
+	out << '"';
+	for(char c : s){
+		if(c == '"' || c == '\\') out << '\\' << c;
+		else if(static_cast<unsigned char>(c) < 0x20) out << ' ';
+		else out << c;
+	}
+	out << '"';
+}
+
+/*! \brief Returns the nanoseconds of the time point since the epoch of the host clock. */
+double nanoseconds(std::chrono::steady_clock::time_point time)
+{
+	return std::chrono::duration<double, std::nano>(time.time_since_epoch()).count();
+}
+
+/*! \brief Returns the index of the value within the values and appends it if not found. */
+template<class T>
+size_t indexOf(std::vector<T> &values, T value)
+{
+	const auto it = std::find(values.begin(), values.end(), value);
+	if(it != values.end()) return size_t(it - values.begin());
+	values.push_back(value);
+	return values.size() - 1;
+}
+
+}
+
+
+/*! \brief Instantiates this Profiler for the Context.
+  *
+  * Call Context::setProfiler in order to record commands.
+  */
+ocl::Profiler::Profiler(Context &ctxt) :
+	_context(&ctxt), _mutex(), _records(), _spans(), _clocks(), _unresolved(0), _resolveAt(64)
+{
+}
+
+/*! \brief Destructs this Profiler and removes it from its Context. */
+ocl::Profiler::~Profiler()
+{
+	_context->remove(this);
+}
+
+/*! \brief Records the Event of an enqueued command.
+  *
+  * \param event of the command which is retained until its times are queried.
+  * \param name of the Kernel or empty for other commands.
+  * \param size_bytes is the number of bytes transferred by the command.
+  */
+void ocl::Profiler::record(const Event &event, const std::string &name, size_t size_bytes)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_records.push_back(Record(event, name, size_bytes));
+	if(++_unresolved >= _resolveAt) this->resolveCompleted();
+}
+
+/*! \brief Queries the times of the completed commands and releases their Event objects.
+  *
+  * Called once the number of unresolved records has doubled so that
+  * recording stays amortized constant time.
+  */
+void ocl::Profiler::resolveCompleted()
+{
+	_unresolved = 0;
+	for(Record &record : _records)
+		if(record.event && !resolve(record, false)) ++_unresolved;
+	_resolveAt = std::max<size_t>(64, 2 * _unresolved);
+}
+
+/*! \brief Queries the times of the command of the record and releases its Event.
+  *
+  * Returns false without waiting if the command has not completed yet and wait is false.
+  */
+bool ocl::Profiler::resolve(Record &record, bool wait)
+{
+	const cl_event id = record.event->id();
+	if(wait) clWaitForEvents(1, &id);
+	cl_int status = CL_COMPLETE;
+	OPENCL_SAFE_CALL( clGetEventInfo(id, CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(status), &status, NULL) );
+	if(status > CL_COMPLETE) return false;
+
+	record.valid = status == CL_COMPLETE && clGetEventProfilingInfo(id, CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), &record.times[0], NULL) == CL_SUCCESS;
+	if(record.valid){
+		OPENCL_SAFE_CALL( clGetEventProfilingInfo(id, CL_PROFILING_COMMAND_SUBMIT, sizeof(cl_ulong), &record.times[1], NULL) );
+		OPENCL_SAFE_CALL( clGetEventProfilingInfo(id, CL_PROFILING_COMMAND_START,  sizeof(cl_ulong), &record.times[2], NULL) );
+		OPENCL_SAFE_CALL( clGetEventProfilingInfo(id, CL_PROFILING_COMMAND_END,    sizeof(cl_ulong), &record.times[3], NULL) );
+		OPENCL_SAFE_CALL( clGetEventInfo(id, CL_EVENT_COMMAND_QUEUE, sizeof(record.queue), &record.queue, NULL) );
+		OPENCL_SAFE_CALL( clGetCommandQueueInfo(record.queue, CL_QUEUE_DEVICE, sizeof(record.device), &record.device, NULL) );
+		record.type = record.event->commandType();
+	}
+	record.event.reset();
+	return true;
+}
+
+/*! \brief Records a span of the host such as the build of a Program.
+  *
+  * \param name of the span.
+  * \param begin of the span measured with std::chrono::steady_clock.
+  * \param end of the span measured with std::chrono::steady_clock.
+  */
+void ocl::Profiler::record(const std::string &name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_spans.push_back(Span(name, begin, end));
+}
+
+/*! \brief Sets the DeviceClock which converts the times of the commands on its Device into host time.
+  *
+  * The DeviceClock must outlive this Profiler or be replaced before.
+  */
+void ocl::Profiler::setClock(const DeviceClock &clock)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_clocks[clock.queue().device().id()] = &clock;
+}
+
+/*! \brief Removes all recorded commands and spans. */
+void ocl::Profiler::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_records.clear();
+	_spans.clear();
+	_unresolved = 0;
+	_resolveAt = 64;
+}
+
+/*! \brief Returns the number of recorded commands and spans. */
+size_t ocl::Profiler::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _records.size() + _spans.size();
+}
+
+/*! \brief Returns the Context of this Profiler. */
+ocl::Context& ocl::Profiler::context() const
+{
+	return *_context;
+}
+
+/*! \brief Writes the recorded commands in the Chrome trace event format.
+  *
+  * Waits until the recorded commands are completed. Commands which terminated
+  * abnormally or which have no profiling information, because their Queue
+  * has been created without CL_QUEUE_PROFILING_ENABLE, are skipped.
+  * The times are given in microseconds. Commands of a Device with a DeviceClock
+  * and host spans are given in host time relative to the first of them. Commands of
+  * all other Device objects are given in the time of their Device relative to
+  * their first command, as the clocks of different Device objects are not related.
+  * Host spans are written as separate process.
+  */
+void ocl::Profiler::write(std::ostream &out) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::vector<cl_device_id> devices;
+	std::vector<cl_command_queue> queues;
+	std::vector<size_t> queue_pids;
+	std::vector<Entry> entries;
+	entries.reserve(_records.size());
+	std::map<cl_device_id, double> origins;
+	const auto earliest = [&origins](cl_device_id domain, double ns){
+		const auto it = origins.find(domain);
+		if(it == origins.end() || ns < it->second) origins[domain] = ns;
+	};
+
+	for(Record &record : _records){
+		if(record.event) resolve(record, true);
+		if(!record.valid) continue;
+
+		Entry entry = Entry();
+		const auto clock = _clocks.find(record.device);
+		const auto time = [&clock, this](cl_ulong ns){
+			return clock == _clocks.end() ? double(ns) : nanoseconds(clock->second->toHost(ns));
+		};
+		entry.domain = clock == _clocks.end() ? record.device : cl_device_id(0);
+		entry.queued = time(record.times[0]);
+		entry.submitted = time(record.times[1]);
+		entry.start = time(record.times[2]);
+		entry.end = time(record.times[3]);
+		entry.pid = indexOf(devices, record.device);
+		entry.tid = indexOf(queues, record.queue);
+		if(entry.tid == queue_pids.size()) queue_pids.push_back(entry.pid);
+
+		describe(record.type, entry);
+		entry.name = &record.name;
+		entry.size_bytes = record.size_bytes;
+		earliest(entry.domain, entry.queued);
+		entries.push_back(entry);
+	}
+
+	for(const Span &span : _spans)
+		earliest(cl_device_id(0), nanoseconds(span.begin));
+
+	const auto us = [&origins](cl_device_id domain, double ns){ return (ns - origins[domain]) / 1000.0; };
+	const size_t host = devices.size();
+
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	const char *separator = "\n";
+	for(size_t pid = 0; pid < devices.size(); ++pid){
+		out << separator << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"args\":{\"name\":";
+		quote(out, ocl::name(devices[pid]));
+		out << "}}";
+		separator = ",\n";
+	}
+	for(size_t tid = 0; tid < queues.size(); ++tid){
+		out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << queue_pids[tid] << ",\"tid\":" << tid
+		    << ",\"args\":{\"name\":\"Queue " << tid << "\"}}";
+	}
+	if(!_spans.empty()){
+		out << separator << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << host << ",\"args\":{\"name\":\"Host\"}}";
+		separator = ",\n";
+	}
+	out << std::fixed << std::setprecision(3);
+	for(const Entry &entry : entries){
+		out << separator << "{\"name\":";
+		quote(out, entry.name->empty() ? std::string(entry.command) : *entry.name);
+		out << ",\"cat\":\"" << entry.category << "\",\"ph\":\"X\",\"pid\":" << entry.pid << ",\"tid\":" << entry.tid
+		    << ",\"ts\":" << us(entry.domain, entry.start) << ",\"dur\":" << (entry.end - entry.start) / 1000.0
+		    << ",\"args\":{\"command\":\"" << entry.command << "\",\"bytes\":" << entry.size_bytes
+		    << ",\"queued\":" << us(entry.domain, entry.queued) << ",\"submitted\":" << us(entry.domain, entry.submitted) << "}}";
+		separator = ",\n";
+	}
+	for(const Span &span : _spans){
+		out << separator << "{\"name\":";
+		quote(out, span.name);
+		out << ",\"cat\":\"host\",\"ph\":\"X\",\"pid\":" << host << ",\"tid\":0"
+		    << ",\"ts\":" << us(cl_device_id(0), nanoseconds(span.begin)) << ",\"dur\":" << (nanoseconds(span.end) - nanoseconds(span.begin)) / 1000.0 << "}";
+		separator = ",\n";
+	}
+	out << "\n]}\n";
+}
+
+/*! \brief Writes the recorded commands in the Chrome trace event format into the file.
+  *
+  * See write(std::ostream&).
+  */
+void ocl::Profiler::save(const std::string &filename) const
+{
+	std::ofstream file(filename.c_str());
+	if(!file) throw std::runtime_error("could not open " + filename);
+	this->write(file);
+}
@@ -19,12 +19,19 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <sstream>
 #include <vector>
 #include <fstream>
 #include <stdexcept>
 #include <memory>
+#include <exception>
+#include <iterator>
+#include <cctype>
+#include <cstring>
+#include <functional>
+#include <set>
 
 #include <ocl_query.h>
 #include <ocl_program.h>
@@ -125,7 +132,7 @@ ocl::CompileOption FAST_MATH("-cl-fast-relaxed-math");
 	* \param options defines a valid CompileOption for build process.
 */
 ocl::Program::Program(ocl::Context& ctxt, const utl::Types &types, const ocl::CompileOption &options) :
-	_id(NULL), _context(&ctxt), _kernels(), _types(types), _options(options), commonCodeBlocks_( 1u, std::string() )
+	_id(NULL), _context(&ctxt), _kernels(), _index(), _indexKeys(), _generation(0), _objects(), _templates(), _lazy(false), _lazyTemplates(), _typeGroups(), _variants(), _variantIndex(), _variantLimit(default_variant_limit), _sources(), _instances(), _types(types), _options(options), _includePaths(), _modules(), _included(), _il(), _specializationConstants(), _bundle(nullptr), _fromBinary(false), _deferred(false), _buildMutex(), _buildPromise(), _buildNotified(), _buildFuture(), commonCodeBlocks_()
 {
 	if(_types.empty()) throw std::runtime_error( "no types selected.");
 	_context->insert(this);
@@ -143,7 +150,7 @@ ocl::Program::Program(ocl::Context& ctxt, const utl::Types &types, const ocl::Co
 	* \param options defines a valid CompileOption for build process.
 */
 ocl::Program::Program(ocl::Context& ctxt, const ocl::CompileOption &options) :
-	_id(NULL), _context(&ctxt), _kernels(), _types(), _options(options), commonCodeBlocks_( 1u, std::string() )
+	_id(NULL), _context(&ctxt), _kernels(), _index(), _indexKeys(), _generation(0), _objects(), _templates(), _lazy(false), _lazyTemplates(), _typeGroups(), _variants(), _variantIndex(), _variantLimit(default_variant_limit), _sources(), _instances(), _types(), _options(options), _includePaths(), _modules(), _included(), _il(), _specializationConstants(), _bundle(nullptr), _fromBinary(false), _deferred(false), _buildMutex(), _buildPromise(), _buildNotified(), _buildFuture(), commonCodeBlocks_()
 {
 	_context->insert(this);
 
@@ -157,7 +164,7 @@ ocl::Program::Program(ocl::Context& ctxt, const ocl::CompileOption &options) :
 	* functions and to build it.
 */
 ocl::Program::Program() :
-	_id(NULL), _context(), _kernels(), _types(), _options(), commonCodeBlocks_( 1u, std::string() )
+	_id(NULL), _context(), _kernels(), _index(), _indexKeys(), _generation(0), _objects(), _templates(), _lazy(false), _lazyTemplates(), _typeGroups(), _variants(), _variantIndex(), _variantLimit(default_variant_limit), _sources(), _instances(), _types(), _options(), _includePaths(), _modules(), _included(), _il(), _specializationConstants(), _bundle(nullptr), _fromBinary(false), _deferred(false), _buildMutex(), _buildPromise(), _buildNotified(), _buildFuture(), commonCodeBlocks_()
 {
 	checkConstraints();
 }
@@ -166,6 +173,8 @@ ocl::Program::Program() :
 /*! \brief Destructs this Program.*/
 ocl::Program::~Program()
 {
+	if(_buildNotified.valid())
+		_buildNotified.wait();
 
 	if(_context != nullptr)
 		_context->release(this);
@@ -182,7 +191,12 @@ ocl::Program::~Program()
 */
 void ocl::Program::release()
 {
-	if(this->isBuilt()){
+	if(_buildNotified.valid())
+		_buildNotified.wait();
+	_buildNotified = std::shared_future<cl_int>();
+	_buildFuture = std::shared_future<void>();
+
+	if(_id != 0){
 		OPENCL_SAFE_CALL( clReleaseProgram (_id));
 
 		for(auto &map : _kernels){
@@ -192,6 +206,10 @@ void ocl::Program::release()
 		}
 	}
 	_id = 0;
+	_fromBinary = false;
+	_deferred = false;
+
+	releaseObjects();
 
 	//	if(_context)
 	//        _context->release(this);
@@ -216,10 +234,20 @@ void ocl::Program::removeKernels()
 		delete  _kernels.begin()->second;
 		_kernels.erase( _kernels.begin());
 	}*/
+	clearTypeGroups();
 	_kernels.clear();
-
-	commonCodeBlocks_.resize( 1u );
-	commonCodeBlocks_[0].clear();
+	_index.clear();
+	_indexKeys.clear();
+	_templates.clear();
+	_lazyTemplates.clear();
+	_sources.clear();
+	_instances.clear();
+	_included.clear();
+	_il.clear();
+	++_generation;
+	clearVariants();
+
+	commonCodeBlocks_.clear();
 
 	checkConstraints();
 }
@@ -246,6 +274,26 @@ void ocl::Program::setTypes(utl::Types&& types)
 	_types = std::move(types);
 }
 
+/*! \brief Enables or disables lazy instantiation of templated Kernel functions.
+  *
+  * In lazy mode templated Kernel functions loaded afterwards are not
+  * specialized for all Types of this Program. Instead, all of them are specialized
+  * for a Type and built together the first time a Kernel of that Type is
+  * requested with kernel(name, Type) or kernel<T>(name). Thus a single build
+  * serves all Kernel objects of a Type and unused Types are never compiled.
+  * Kernel functions which are not templated are built with build() as usual.
+*/
+void ocl::Program::setLazy(bool lazy)
+{
+	_lazy = lazy;
+}
+
+/*! \brief Returns true if templated Kernel functions are instantiated per Type on first use.*/
+bool ocl::Program::isLazy() const
+{
+	return _lazy;
+}
+
 /*! \brief Returns the Types of the Kernel objects.
   *
 */
@@ -262,6 +310,8 @@ void ocl::Program::setCompileOption(const ocl::CompileOption & o)
 {
 	if(this->isBuilt()) throw std::runtime_error( "Program already built.");
 	_options = o;
+	clearVariants();
+	clearTypeGroups();
 }
 
 
@@ -270,18 +320,348 @@ void ocl::Program::setCompileOption(const ocl::CompileOption & o)
 	*
 	* Do not forget to load Kernel objects into this
 	* Program before executing this function.
-	* This Program with all Kernel objects are built. Note that
-	* compiling and linking in seperate stages are note supported
-	* yet. Kernels built with this Program
+	* This Program with all Kernel objects are built. Use compile()
+	* and link() in order to compile and link in separate stages and
+	* buildAsync() in order to build without blocking. Kernels built with this Program
 	* can be executed on all Device objects within the Context
 	* for which this Program is built.
+	* If this Program only holds lazy templates, nothing is compiled. The
+	* build is deferred to the first use of each Type and the Program counts
+	* as built, see isBuilt().
+	* Throws if an asynchronous build of this Program is still pending.
 */
 void ocl::Program::build()
+{
+	if(this->isBuilding()) throw std::runtime_error( "Program is still being built. Call waitForBuild() first");
+	if(this->deferBuild()) return;
+
+	this->createProgram();
+
+	cl_int buildErr = clBuildProgram(_id, 0, NULL, _options().c_str(), NULL, NULL);
+	if(buildErr != CL_SUCCESS && _fromBinary) buildErr = this->rebuildFromSource();
+	checkBuild(buildErr);
+
+	this->createKernels();
+}
+
+/*! \brief Builds this Program asynchronously for all Device objects of its Context.
+	*
+	* See buildAsync(const std::vector<ocl::Device>&).
+*/
+std::shared_future<void> ocl::Program::buildAsync()
+{
+	return this->buildAsync(std::vector<ocl::Device>());
+}
+
+/*! \brief Builds this Program asynchronously for the specified Device objects.
+	*
+	* The build is handed over to the OpenCL implementation together with
+	* a notification callback, so that this function returns as soon as the
+	* implementation accepts the build. The callback only signals the end of
+	* the build, as OpenCL functions should not be called from callbacks.
+	* The build is checked and the Kernel objects are created by the thread
+	* which first waits for the returned future, calls waitForBuild() or uses
+	* a Kernel of this Program. The future holds the exception with the build
+	* log if the build failed.
+	* Specifying several Device objects compiles this Program for all of them
+	* with a single request which the implementation may process in parallel.
+	* Binaries of a Bundle are loaded synchronously for the specified Device
+	* objects and are only compiled from source if they are rejected.
+	*
+	* Throws if an asynchronous build of this Program is still pending.
+	*
+	* \param devices Device objects of the Context. If empty, all Device objects of the Context are used.
+*/
+std::shared_future<void> ocl::Program::buildAsync(const std::vector<ocl::Device> &devices)
+{
+	if(this->isBuilding()) throw std::runtime_error( "Program is still being built. Call waitForBuild() first");
+	if(this->deferBuild()){
+		std::promise<void> deferred;
+		deferred.set_value();
+		return deferred.get_future().share();
+	}
+
+	this->createProgram();
+
+	std::vector<cl_device_id> ids;
+	for(const auto &d : devices) ids.push_back(d.id());
+
+	std::shared_future<cl_int> notified;
+	{
+		std::lock_guard<std::mutex> lock(_buildMutex);
+		_buildPromise.reset(new std::promise<cl_int>());
+		notified = _buildPromise->get_future().share();
+	}
+	_buildNotified = notified;
+	_buildFuture = std::async(std::launch::deferred, [this, notified]{ this->completeBuild(notified.get()); }).share();
+
+	// Binaries only need to be loaded, the source is compiled only if they are rejected.
+	if(_fromBinary){
+		cl_int buildErr = clBuildProgram(_id, cl_uint(ids.size()), ids.empty() ? NULL : ids.data(), _options().c_str(), NULL, NULL);
+		if(buildErr != CL_SUCCESS) buildErr = this->rebuildFromSource(ids);
+		this->notifyBuild(buildErr);
+		return _buildFuture;
+	}
+
+	cl_int buildErr = clBuildProgram(_id, cl_uint(ids.size()), ids.empty() ? NULL : ids.data(), _options().c_str(), &Program::buildNotify, this);
+
+	// The callback is not guaranteed to be called if the build request has been rejected.
+	if(buildErr != CL_SUCCESS)
+		this->notifyBuild(buildErr);
+
+	return _buildFuture;
+}
+
+/*! \brief Blocks until a pending asynchronous build of this Program has finished.
+	*
+	* Creates the Kernel objects on the calling thread if no other thread
+	* did so before. Rethrows the exception of a failed build. Returns immediately
+	* if this Program has been built synchronously or not at all.
+*/
+void ocl::Program::waitForBuild() const
+{
+	if(_buildFuture.valid())
+		_buildFuture.get();
+}
+
+/*! \brief Returns true if the OpenCL implementation has not finished an asynchronous build of this Program yet. */
+bool ocl::Program::isBuilding() const
+{
+	return _buildNotified.valid() && _buildNotified.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+/*! \brief Builds the specified Program objects in parallel.
+	*
+	* All builds are started with buildAsync() before waiting for any of them
+	* so that independent Program objects are compiled concurrently.
+	* Waits for all builds and rethrows the first error that occurred.
+*/
+void ocl::Program::buildAll(const std::vector<Program*> &programs)
+{
+	std::vector< std::shared_future<void> > builds;
+	std::exception_ptr error;
+
+	for(auto *p : programs){
+		try{
+			builds.push_back(p->buildAsync());
+		}
+		catch(...){
+			if(!error) error = std::current_exception();
+		}
+	}
+
+	for(auto &b : builds){
+		try{
+			b.get();
+		}
+		catch(...){
+			if(!error) error = std::current_exception();
+		}
+	}
+
+	if(error) std::rethrow_exception(error);
+}
+
+/*! \brief Compiles each Kernel of this Program into its own program object.
+	*
+	* Compiled objects are cached together with the kernel function
+	* they have been compiled from. Only Kernel objects that are new or whose
+	* function changed since the last call are compiled again. Objects of
+	* Kernel objects which have been deleted from this Program are released.
+	* Note that every kernel function is compiled separately together with
+	* the auxiliary code of this Program. Auxiliary functions are therefore
+	* compiled with internal linkage, i.e. declared static, so that the
+	* objects do not define the same symbols. Call link() to create the executable.
+*/
+void ocl::Program::compile()
+{
+#ifdef CL_VERSION_1_2
+	if(this->_context == 0)throw std::runtime_error( "Program has no Context");
+	if(this->isIL()) throw std::runtime_error( "Separate compilation is not supported for Programs created from IL");
+	if(_kernels.empty()) throw std::runtime_error( "No kernels loaded for the program");
+
+	for(auto it = _objects.begin(); it != _objects.end(); ){
+		if(this->exists(it->first)){
+			++it;
+			continue;
+		}
+		OPENCL_SAFE_CALL( clReleaseProgram(it->second.second) );
+		it = _objects.erase(it);
+	}
+
+	for(size_t i = 0; i < _kernels.size(); ++i){
+		const auto &k = _kernels[i];
+		const std::string source = internalize(this->helpers(i)) + k->toString();
+		auto it = _objects.find(k->name());
+		if(it != _objects.end() && it->second.first == source)
+			continue;
+
+		cl_int status;
+		const char * file_char = source.c_str();
+		cl_program object = clCreateProgramWithSource(this->context().id(), 1, &file_char, NULL, &status);
+		OPENCL_SAFE_CALL(status);
+
+		try{
+			checkBuild(object, clCompileProgram(object, 0, NULL, _options().c_str(), 0, NULL, NULL, NULL, NULL));
+		}
+		catch(...){
+			clReleaseProgram(object);
+			throw;
+		}
+
+		if(it != _objects.end()){
+			OPENCL_SAFE_CALL( clReleaseProgram(it->second.second) );
+			it->second = std::make_pair(source, object);
+		}
+		else{
+			_objects.insert(std::make_pair(k->name(), std::make_pair(source, object)));
+		}
+	}
+#else
+	throw std::runtime_error( "Separate compilation requires OpenCL 1.2.");
+#endif
+}
+
+/*! \brief Links the compiled Kernel objects into the executable of this Program.
+	*
+	* Calls compile() first so that only new or changed Kernel objects are
+	* compiled. If this Program has already been built, its executable is
+	* replaced and all Kernel objects are created again. Thus editing a single
+	* kernel function costs one compilation and one link. If the link fails,
+	* the previous executable and its Kernel objects are kept. Note that the work
+	* sizes of the Kernel objects must be set again after linking.
+*/
+void ocl::Program::link()
+{
+#ifdef CL_VERSION_1_2
+	this->waitForBuild();
+	this->compile();
+
+	std::vector<cl_program> objects;
+	for(const auto &o : _objects) objects.push_back(o.second.second);
+
+	cl_int status;
+	cl_program program = clLinkProgram(this->context().id(), 0, NULL, linkOptions().c_str(), cl_uint(objects.size()), objects.data(), NULL, NULL, &status);
+	if(program == 0) OPENCL_SAFE_CALL(status);
+	try{
+		checkBuild(program, status);
+	}
+	catch(...){
+		clReleaseProgram(program);
+		throw;
+	}
+
+	if(_id != 0){
+		for(auto &k : _kernels) k->release();
+		OPENCL_SAFE_CALL( clReleaseProgram(_id) );
+	}
+	_id = program;
+	_fromBinary = false;
+
+	this->createKernels();
+#else
+	throw std::runtime_error( "Separate compilation requires OpenCL 1.2.");
+#endif
+}
+
+/*! \brief Releases all compiled Kernel objects. */
+void ocl::Program::releaseObjects()
+{
+	for(auto &o : _objects){
+		OPENCL_SAFE_CALL( clReleaseProgram(o.second.second) );
+	}
+	_objects.clear();
+}
+
+/*! \brief Returns the subset of the CompileOption that is valid for linking. */
+std::string ocl::Program::linkOptions() const
+{
+	static const char * const valid[] = { "-cl-denorms-are-zero", "-cl-no-signed-zeros",
+		"-cl-unsafe-math-optimizations", "-cl-finite-math-only", "-cl-fast-relaxed-math" };
+
+	std::istringstream options(_options());
+	std::string option, result;
+	while(options >> option){
+		if(std::find(std::begin(valid), std::end(valid), option) == std::end(valid)) continue;
+		result += option + " ";
+	}
+	return result;
+}
+
+/*! \brief Returns the auxiliary code with internal linkage for all function definitions.
+  *
+  * Each function definition at file scope which is not declared static yet
+  * is declared static, so that objects compiled separately by compile()
+  * can be linked without defining the same symbol twice.
+  * Preprocessor directives, type definitions and declarations are kept as they are.
+*/
+std::string ocl::Program::internalize(const std::string &code)
+{
+	static const char * const keep[] = { "static", "struct", "union", "enum", "typedef", "__kernel", "kernel" };
+
+	std::string result;
+	result.reserve(code.size() + 64);
+
+	size_t declaration = 0; // start of the current declaration at file scope.
+	size_t braces = 0, parens = 0, copied = 0;
+	bool lineStart = true;
+	for(size_t i = 0; i < code.size(); ++i){
+		const char c = code[i];
+
+		// skip preprocessor directives including continued lines.
+		if(c == '#' && lineStart){
+			while(i < code.size() && !(code[i] == '\n' && code[i-1] != '\\')) ++i;
+			if(braces == 0) declaration = i+1;
+			continue;
+		}
+		if(c == '\n'){ lineStart = true; continue; }
+		if(c != ' ' && c != '\t' && c != '\r') lineStart = false;
+
+		if(c == '(') ++parens;
+		else if(c == ')' && parens > 0) --parens;
+		else if(c == ';' && braces == 0 && parens == 0) declaration = i+1;
+		else if(c == '}' && braces > 0){
+			if(--braces == 0) declaration = i+1;
+		}
+		else if(c == '{'){
+			if(braces++ != 0 || parens != 0) continue;
+
+			// a function definition is the only block at file scope preceded by a parameter list.
+			const size_t prev = code.find_last_not_of(" \t\r\n", i-1);
+			if(prev == std::string::npos || prev < declaration || code[prev] != ')') continue;
+
+			const size_t start = code.find_first_not_of(" \t\r\n", declaration);
+			bool definition = true;
+			for(const char *k : keep){
+				const size_t n = std::strlen(k);
+				if(code.compare(start, n, k) == 0 && (start+n == code.size() || !(std::isalnum(static_cast<unsigned char>(code[start+n])) || code[start+n] == '_')))
+					definition = false;
+			}
+			if(!definition) continue;
+
+			result.append(code, copied, start - copied);
+			result += "static ";
+			copied = start;
+		}
+	}
+	result.append(code, copied, std::string::npos);
+	return result;
+}
+
+/*! \brief Creates the OpenCL program object from the loaded Kernel functions. */
+void ocl::Program::createProgram(bool binary)
 {
 	if(this->_context == 0)throw std::runtime_error( "Program has no Context");
 	if(this->_id != 0) throw std::runtime_error( "Program already built");
 
 	if(_kernels.empty()) throw std::runtime_error( "No kernels loaded for the program");
+
+	_fromBinary = false;
+	if(this->isIL()){
+		this->createProgramFromIL();
+		return;
+	}
+
 	std::stringstream stream;
 
 	this->print(stream);
@@ -289,18 +669,250 @@ void ocl::Program::build()
 
 	//     std::cout << t << std::endl;
 
+	_fromBinary = binary && _bundle != nullptr && this->createProgramFromBundle(t);
+	if(_fromBinary) return;
+
 	cl_int status;
 	const char * file_char = t.c_str(); // stream.str().c_str();
 	_id = clCreateProgramWithSource(this->context().id(), 1, (const char**)&file_char,   NULL, &status);
 	OPENCL_SAFE_CALL(status);
-	cl_int buildErr = clBuildProgram(_id, 0, NULL, _options().c_str(), NULL, NULL);
-	checkBuild(buildErr);
+}
+
+/*! \brief Creates the OpenCL program from the SPIR-V module and sets its specialization constants. */
+void ocl::Program::createProgramFromIL()
+{
+#ifdef CL_VERSION_2_1
+	for(const auto &d : this->context().devices())
+		if(!d.supportsVersion(2, 1)) throw std::runtime_error( "Device " + d.name() + " does not support Programs created from IL");
+
+	cl_int status;
+	_id = clCreateProgramWithIL(this->context().id(), _il.data(), _il.size(), &status);
+	OPENCL_SAFE_CALL(status);
+
+	if(_specializationConstants.empty()) return;
+#ifdef CL_VERSION_2_2
+	for(const auto &c : _specializationConstants)
+		OPENCL_SAFE_CALL( clSetProgramSpecializationConstant(_id, c.first, c.second.size(), c.second.data()) );
+#else
+	throw std::runtime_error( "Specialization constants require OpenCL 2.2.");
+#endif
+#else
+	throw std::runtime_error( "Programs created from IL require OpenCL 2.1.");
+#endif
+}
+
+/*! \brief Loads the SPIR-V module from which this Program is built instead of source.
+  *
+  * A Kernel is created for each kernel function of the module. Kernel objects
+  * are accessed and called as if they were read from source, as the memory
+  * locations of their arguments are extracted from the module.
+  * The Program must neither contain kernel functions read from source nor be built.
+  * Requires Device objects supporting OpenCL 2.1.
+*/
+void ocl::Program::loadIL(const std::vector<unsigned char> &il)
+{
+	if(this->isBuilt()) throw std::runtime_error( "Program already built");
+	if(!_kernels.empty() || !_templates.empty() || !_lazyTemplates.empty())
+		throw std::runtime_error( "Program already contains kernel functions");
+
+	const auto entryPoints = ocl::Kernel::extractEntryPoints(il);
+	_il = il;
+	for(const auto &e : entryPoints)
+		insertKernel( std::unique_ptr< ocl::Kernel >( new ocl::Kernel(*this, e) ), std::string(), nullptr );
+}
+
+/*! \brief Loads the SPIR-V module from an input stream.
+  *
+  * See loadIL(const std::vector<unsigned char>&).
+*/
+void ocl::Program::loadIL(std::istream &stream)
+{
+	if(stream.fail()) throw std::runtime_error( "Error while opening file.");
+	this->loadIL(std::vector<unsigned char>((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>()));
+}
+
+/*! \brief Returns true if this Program is created from a SPIR-V module. */
+bool ocl::Program::isIL() const
+{
+	return !_il.empty();
+}
+
+/*! \brief Sets the value of the specialization constant with the specified id.
+  *
+  * The value is applied with the next build. Respecializing a built Program
+  * only requires release() and build() which compiles the module again
+  * instead of rebuilding the source with other -D options.
+  * Requires OpenCL 2.2.
+*/
+void ocl::Program::setSpecializationConstant(cl_uint id, size_t size, const void *value)
+{
+	const unsigned char *bytes = static_cast<const unsigned char*>(value);
+	_specializationConstants[id] = std::vector<unsigned char>(bytes, bytes + size);
+}
+
+/*! \brief Removes the values of all specialization constants. */
+void ocl::Program::clearSpecializationConstants()
+{
+	_specializationConstants.clear();
+}
+
+/*! \brief Creates the OpenCL program from the binaries of the Bundle.
+  *
+  * Returns false if the Bundle has no binary matching the source and
+  * build options of this Program for each Device of its Context or if
+  * the binaries are rejected by the OpenCL implementation.
+*/
+bool ocl::Program::createProgramFromBundle(const std::string &source)
+{
+	const uint64_t hash = ocl::Bundle::hash(source);
+
+	std::vector<cl_device_id> ids;
+	std::vector<size_t> sizes;
+	std::vector<const unsigned char*> binaries;
+	for(const auto &d : this->context().devices()){
+		const ocl::Bundle::Binary *binary = _bundle->find(d, _options(), hash);
+		if(binary == nullptr || binary->data.empty()) return false;
+		ids.push_back(d.id());
+		sizes.push_back(binary->data.size());
+		binaries.push_back(binary->data.data());
+	}
+	if(ids.empty()) return false;
+
+	cl_int status;
+	cl_program program = clCreateProgramWithBinary(this->context().id(), cl_uint(ids.size()), ids.data(), sizes.data(), binaries.data(), NULL, &status);
+	if(status != CL_SUCCESS){
+		if(program != 0) clReleaseProgram(program);
+		return false;
+	}
+	_id = program;
+	return true;
+}
+
+/*! \brief Releases the OpenCL program created from binaries and builds it from source.
+  *
+  * The program is built for the specified devices or for all devices of the Context if there are none.
+*/
+cl_int ocl::Program::rebuildFromSource(const std::vector<cl_device_id> &devices)
+{
+	OPENCL_SAFE_CALL( clReleaseProgram(_id) );
+	_id = 0;
+	this->createProgram(false);
+	return clBuildProgram(_id, cl_uint(devices.size()), devices.empty() ? NULL : devices.data(), _options().c_str(), NULL, NULL);
+}
 
+/*! \brief Sets the Bundle whose binaries are preferred over the source when building.
+  *
+  * The Bundle is not copied and must outlive this Program.
+  * Pass null in order to always build from source.
+*/
+void ocl::Program::setBundle(const Bundle *bundle)
+{
+	_bundle = bundle;
+}
+
+/*! \brief Returns the Bundle of this Program or null if there is none. */
+const ocl::Bundle* ocl::Program::bundle() const
+{
+	return _bundle;
+}
+
+/*! \brief Returns true if this Program has been built from binaries of its Bundle. */
+bool ocl::Program::isBuiltFromBinary() const
+{
+	return this->isBuilt() && _fromBinary;
+}
+
+/*! \brief Returns a Bundle with the binaries of this built Program for each of its Device objects.
+  *
+  * The binaries are keyed by the source and the build options of this Program.
+*/
+ocl::Bundle ocl::Program::binaries() const
+{
+	if(_id == 0) throw std::runtime_error( "Program is not built");
+	this->waitForBuild();
+
+	std::stringstream stream;
+	this->print(stream);
+	const uint64_t hash = ocl::Bundle::hash(stream.str());
+
+	cl_uint count;
+	OPENCL_SAFE_CALL( clGetProgramInfo(_id, CL_PROGRAM_NUM_DEVICES, sizeof(count), &count, NULL) );
+	std::vector<cl_device_id> ids(count);
+	OPENCL_SAFE_CALL( clGetProgramInfo(_id, CL_PROGRAM_DEVICES, count * sizeof(cl_device_id), ids.data(), NULL) );
+	std::vector<size_t> sizes(count);
+	OPENCL_SAFE_CALL( clGetProgramInfo(_id, CL_PROGRAM_BINARY_SIZES, count * sizeof(size_t), sizes.data(), NULL) );
+
+	std::vector< std::vector<unsigned char> > data(count);
+	std::vector<unsigned char*> pointers(count);
+	for(cl_uint i = 0; i < count; ++i){
+		data[i].resize(sizes[i]);
+		pointers[i] = data[i].data();
+	}
+	OPENCL_SAFE_CALL( clGetProgramInfo(_id, CL_PROGRAM_BINARIES, count * sizeof(unsigned char*), pointers.data(), NULL) );
+
+	ocl::Bundle bundle;
+	for(cl_uint i = 0; i < count; ++i){
+		if(data[i].empty()) continue;
+		const ocl::Device device(ids[i]);
+		ocl::Bundle::Binary binary;
+		binary.device = device.name();
+		binary.version = device.version();
+		binary.driver = device.driverVersion();
+		binary.options = _options();
+		binary.source = hash;
+		binary.data = std::move(data[i]);
+		bundle.add(binary);
+	}
+	return bundle;
+}
+
+/*! \brief Creates all Kernel objects of the built Program. */
+void ocl::Program::createKernels()
+{
 	for(auto& k : _kernels){
 		k->create();
 	}
 }
 
+/*! \brief Signals the end of a pending asynchronous build.
+  *
+  * Only fulfills the promise with the status of the build request
+  * without calling any OpenCL function. Only the first call for a build has an effect.
+*/
+void ocl::Program::notifyBuild(cl_int buildErr)
+{
+	std::unique_ptr< std::promise<cl_int> > promise;
+	{
+		std::lock_guard<std::mutex> lock(_buildMutex);
+		promise = std::move(_buildPromise);
+	}
+	if(promise) promise->set_value(buildErr);
+}
+
+/*! \brief Completes an asynchronous build on the thread waiting for it.
+  *
+  * Checks the build status of all Device objects and creates the Kernel objects.
+  * Called once per build through the future returned by buildAsync().
+*/
+void ocl::Program::completeBuild(cl_int buildErr) const
+{
+	if(buildErr == CL_SUCCESS){
+		for ( auto const& device : _context->devices() ){
+			cl_build_status buildStatus = CL_BUILD_NONE;
+			OPENCL_SAFE_CALL( clGetProgramBuildInfo( _id, device.id(), CL_PROGRAM_BUILD_STATUS, sizeof buildStatus, &buildStatus, nullptr ) );
+			if(buildStatus == CL_BUILD_ERROR) buildErr = CL_BUILD_PROGRAM_FAILURE;
+		}
+	}
+	checkBuild(buildErr);
+	for(const auto &k : _kernels) k->create();
+}
+
+/*! \brief Build notification called by the OpenCL implementation. */
+void CL_CALLBACK ocl::Program::buildNotify(cl_program, void *program)
+{
+	static_cast<ocl::Program*>(program)->notifyBuild(CL_SUCCESS);
+}
+
 
 /*! \brief Returns the OpenCL ID of this Program. */
 cl_program ocl::Program::id() const
@@ -328,43 +940,107 @@ void ocl::Program::setContext(ocl::Context &c)
 
 }
 
-/*! \brief Return true if this Program is built. */
+/*! \brief Return true if this Program is built.
+  *
+  * A Program which only holds lazy templates counts as built
+  * after build() or buildAsync(), although it has no OpenCL program,
+  * as its templates are built per Type on first use.
+*/
 bool ocl::Program::isBuilt() const
 {
-	return _id != NULL;
+	return _id != NULL || _deferred;
 }
 
-/*! \brief Prints the Kernel functions of this Program. */
-void ocl::Program::print(std::ostream& out) const
+/*! \brief Marks this Program as built if it only holds lazy templates.
+  *
+  * Returns true if the build is deferred to the first use of each Type.
+*/
+bool ocl::Program::deferBuild()
 {
-#if 1
-	//	out << "Printing program:" << std::endl;
-	for(const auto &k : _kernels)
-	{
-		const ocl::Kernel &kernel = *k;
-		out << kernel.toString() << std::endl;
-	}
-	out << std::endl;
-#else
-	checkConstraints();
+	if(!_kernels.empty() || _lazyTemplates.empty()) return false;
+	if(this->_context == 0) throw std::runtime_error( "Program has no Context");
+	_deferred = true;
+	return true;
+}
 
-	auto it = commonCodeBlocks_.begin();
+namespace {
 
-	for ( auto& k : _kernels )
-	{
-		assert( k != nullptr );
-		assert( it != commonCodeBlocks_.end() );
+/*! \brief Appends the code unless it only contains whitespace or repeats emitted code.*/
+void appendCode(std::string &code, const std::string &chunk, std::set<std::string> &emitted)
+{
+	const size_t first = chunk.find_first_not_of(" \t\r\n");
+	if(first == std::string::npos) return;
+	if(!emitted.insert(chunk.substr(first, chunk.find_last_not_of(" \t\r\n") - first + 1)).second) return;
+	code += chunk;
+}
 
-		out << *it++;
-		out << k->toString();
-		out << '\n';
+/*! \brief Appends the auxiliary code block without repeating emitted code.
+  *
+  * Preprocessor directives are always appended in place, as directives
+  * such as #undef may be repeated on purpose. The code between them is
+  * skipped if the same code has been emitted before.
+*/
+void appendBlock(std::string &code, const std::string &block, std::set<std::string> &emitted)
+{
+	std::string chunk;
+	size_t pos = 0;
+	while(pos < block.size()){
+		size_t end = block.find('\n', pos);
+		// directives continue on the next line after a backslash.
+		const size_t i = block.find_first_not_of(" \t", pos);
+		const bool directive = i < block.size() && block[i] == '#';
+		while(directive && end != std::string::npos && end > 0 && block[end-1] == '\\') end = block.find('\n', end+1);
+		end = end == std::string::npos ? block.size() : end + 1;
+
+		if(directive){
+			appendCode(code, chunk, emitted);
+			chunk.clear();
+			code.append(block, pos, end - pos);
+		}
+		else
+			chunk.append(block, pos, end - pos);
+		pos = end;
 	}
+	appendCode(code, chunk, emitted);
+	if(!code.empty() && code.back() != '\n') code += '\n';
+}
 
-	if ( it != commonCodeBlocks_.end() )
+}
+
+/*! \brief Prints the auxiliary code and the Kernel functions of this Program in order of their appearance. */
+void ocl::Program::print(std::ostream& out) const
+{
+	std::set<std::string> emitted;
+	auto block = commonCodeBlocks_.begin();
+	for(size_t i = 0; i < _kernels.size(); ++i)
 	{
-		out << *it++;
+		std::string code;
+		for(; block != commonCodeBlocks_.end() && block->position <= i; ++block)
+			appendBlock(code, block->code, emitted);
+		out << code << _kernels[i]->toString() << std::endl;
 	}
-#endif
+	std::string code;
+	for(; block != commonCodeBlocks_.end(); ++block)
+		appendBlock(code, block->code, emitted);
+	out << code << std::endl;
+}
+
+/*! \brief Returns the auxiliary code outside of kernel functions preceding the Kernel at the position.
+  *
+  * Code blocks are returned in order of their appearance. Blocks
+  * which only contain whitespace or which repeat a block without
+  * preprocessor directives are skipped, so that shared auxiliary code
+  * is emitted only once. By default all blocks are returned.
+*/
+std::string ocl::Program::helpers(size_t position) const
+{
+	std::set<std::string> emitted;
+	std::string code;
+	for(const auto &block : commonCodeBlocks_){
+		if(block.position > position) break;
+		appendBlock(code, block.code, emitted);
+	}
+	return code;
 }
 
 
@@ -437,10 +1113,7 @@ std::string ocl::Program::nextKernel(const std::string &kernels, size_t pos)
 
 	size_t end = braceFinder;
 
-	if ( _kernels.empty() )
-		commonCodeBlocks_[0] = kernels.substr( pos, start - pos );
-	else
-		commonCodeBlocks_.push_back( kernels.substr( pos, start - pos ) );
+	commonCodeBlocks_.push_back( CodeBlock{ _kernels.size(), kernels.substr( pos, start - pos ) } );
 
 	return kernels.substr( start, end - start +1 );
 
@@ -456,16 +1129,130 @@ std::string ocl::Program::nextKernel(const std::string &kernels, size_t pos)
   * a Kernel object is built and stored within a map.
   * The map stores the name of the kernel function and
   * the corresponding function.
+  * Modules named by #include directives are included
+  * before the remaining code of the string is read.
   * Note that DEFINES are not supported yet.
 */
 ocl::Program& ocl::Program::operator << (const std::string &k)
 {
-	//   std::cout << "kernels: " << _kernels.size() << " blocks: " << commonCodeBlocks_.size() << std::endl;
-	//   if ( _kernels.empty() )
-	//   {
-	//     commonCodeBlocks_.resize( 0 );
-	//   }
+	this->read(this->includeModules(k));
+	return *this;
+}
+
+/*! \brief Includes the Module into this Program.
+  *
+  * The modules included by the Module are included first.
+  * A Module with the same name or the same source as an included Module is skipped.
+*/
+ocl::Program& ocl::Program::operator << (const Module &module)
+{
+	this->include(module.name(), std::make_shared<const Module>(module), std::string());
+	return *this;
+}
+
+/*! \brief Registers the Module so that it can be included by its name.
+  *
+  * Registered modules take precedence over files in the include paths.
+*/
+void ocl::Program::addModule(const Module &module)
+{
+	_modules[module.name()] = std::make_shared<const Module>(module);
+}
+
+/*! \brief Appends a directory in which included modules are searched.
+  *
+  * Modules included by a Module file are searched in the directory of that file first.
+*/
+void ocl::Program::addIncludePath(const std::string &path)
+{
+	_includePaths.push_back(path);
+}
+
+/*! \brief Returns the directories in which included modules are searched. */
+const std::vector<std::string>& ocl::Program::includePaths() const
+{
+	return _includePaths;
+}
+
+/*! \brief Includes the registered Module or the Module file with the specified name.
+  *
+  * Registered modules are identified by their name, files by their path.
+  * Files are searched in the directory first, followed by the include paths
+  * and the working directory.
+  *
+  * \param name is the name of the Module or the path of its file.
+  * \param directory is the directory of the including Module file or empty.
+*/
+void ocl::Program::include(const std::string &name, const std::string &directory)
+{
+	auto found = _modules.find(name);
+	if(found != _modules.end()){
+		this->include(name, found->second, std::string());
+		return;
+	}
+	const std::vector<std::string> paths = this->searchPaths(directory);
+	const std::string path = ocl::Module::locate(name, paths);
+	const size_t slash = path.rfind('/');
+	this->include(path, ocl::Module::load(name, paths), slash == std::string::npos ? std::string() : path.substr(0, slash + 1));
+}
+
+/*! \brief Includes the Module identified by the key unless it has already been included.
+  *
+  * A Module is skipped if a Module with the same key or with the same source
+  * has been included before. Sources are only compared if their hashes match.
+  * The modules included by the Module are searched in the directory first.
+*/
+void ocl::Program::include(const std::string &key, const std::shared_ptr< const Module > &module, const std::string &directory)
+{
+	for(const auto &m : _included){
+		if(!key.empty() && m.first == key) return;
+		if(m.second->hash() == module->hash() && m.second->source() == module->source()) return;
+	}
+	_included.push_back(std::make_pair(key, module));
+	this->read(this->includeModules(module->source(), directory));
+}
+
+/*! \brief Includes the modules named by the #include directives of the source.
+  *
+  * Returns the source without the directives of the included modules.
+  * Directives naming neither a registered Module nor a file in the
+  * directory or the include paths are kept, so that the compiler resolves them.
+  *
+  * \param source is the OpenCL C source with #include directives.
+  * \param directory is the directory of the Module file containing the source or empty.
+*/
+std::string ocl::Program::includeModules(const std::string &source, const std::string &directory)
+{
+	const std::vector<std::string> paths = this->searchPaths(directory);
+	std::vector<std::string> includes;
+	const std::string code = ocl::Module::stripIncludes(source, &includes, [this, &paths](const std::string &name){
+		return _modules.find(name) != _modules.end() || !ocl::Module::locate(name, paths).empty();
+	});
+	for(const auto &name : includes) this->include(name, directory);
+	return code;
+}
 
+/*! \brief Returns the directory followed by the include paths of this Program.
+  *
+  * The directory is omitted if it is empty.
+*/
+std::vector<std::string> ocl::Program::searchPaths(const std::string &directory) const
+{
+	if(directory.empty()) return _includePaths;
+	std::vector<std::string> paths(1, directory);
+	paths.insert(paths.end(), _includePaths.begin(), _includePaths.end());
+	return paths;
+}
+
+/*! \brief Reads kernel functions and auxiliary code without #include directives. */
+void ocl::Program::read(const std::string &k)
+{
+	if(this->isIL()) throw std::runtime_error( "Program is created from IL");
+	if(this->isBuilt()) this->waitForBuild();
+	clearVariants();
+	clearTypeGroups();
+
+	_sources.push_back(k);
 	std::string kernels = k;
 
 	//#if 0 // For now disable comment removal as we need it to play a trick on the AMD compiler.
@@ -477,64 +1264,56 @@ ocl::Program& ocl::Program::operator << (const std::string &k)
 		const std::string next = nextKernel(kernels, pos);
 
 		if(next.empty()) {
-			commonCodeBlocks_.push_back( kernels.substr( pos ) );
+			commonCodeBlocks_.push_back( CodeBlock{ _kernels.size(), kernels.substr( pos ) } );
 			break;
 		}
-		pos += next.length() + commonCodeBlocks_.back().length();
+		pos += next.length() + commonCodeBlocks_.back().code.length();
 
 
-//		std::cout << "COMMON CODE: " << commonCodeBlocks_.back();
+//		std::cout << "COMMON CODE: " << commonCodeBlocks_.back().code;
 //		std::cout << "KERNEL CODE: " << next << std::endl;
 
+		// Templates with several or non-type parameters are only instantiated on request.
+		if(ocl::Kernel::templated(next) &&
+		   (_types.empty() || ocl::Kernel::extractParameters(next).size() != 1 || !ocl::Kernel::typeParameter(next, 0))){
+			_templates[ocl::Kernel::extractName(next)] = next;
+			continue;
+		}
+
+		if(_lazy && !_types.empty() && ocl::Kernel::templated(next)){
+			_lazyTemplates[ocl::Kernel::extractName(next)] = next;
+			continue;
+		}
+
 		if(_types.empty() || !ocl::Kernel::templated(next)){
 			std::unique_ptr< ocl::Kernel > kernel( new ocl::Kernel(*this, next) );
-			if(this->isBuilt()) kernel->create();
-
-			auto t = std::find_if( _kernels.begin(), _kernels.end(), [&kernel]( std::unique_ptr< Kernel > const& k ){ return kernel->name() == k->name(); } );
+			if(_id != 0 && _objects.empty()) kernel->create();
 
-			if ( t != _kernels.end() ) {
-				t->swap( kernel );
-			} else {
-				_kernels.push_back( std::move( kernel ) );
-			}
+			insertKernel( std::move( kernel ), std::string(), nullptr );
 
 			continue;
 		}
 
+		const std::string templateName = ocl::Kernel::extractName(next);
 
 		for(utl::Types::const_iterator it = _types.begin(); it != _types.end(); ++it)
 		{
 			const utl::Type& type = **it;
 			std::unique_ptr< ocl::Kernel > kernel( new ocl::Kernel(*this, next, type) );
-			if(this->isBuilt()) {
+			if(_id != 0 && _objects.empty()) {
 				kernel->create();
 			}
-			Kernels::iterator t = std::find_if( _kernels.begin(), _kernels.end(), [&kernel]( std::unique_ptr< Kernel > const& k ){ return kernel->name() == k->name(); 		} );
-
-			if ( t != _kernels.end() ) {
-				t->swap( kernel );
-			} else {
-				_kernels.push_back( std::move( kernel ) );
-			}
-
-			// "Invent" common code blocks for kernels being generated by the type system.
-			if ( /*std::distance(it, _types.begin()) > 1*/ it != _types.begin() ) {
-				commonCodeBlocks_.push_back("\n");
-			}
+			insertKernel( std::move( kernel ), templateName, &type );
 		}
 	}
 
 
-	commonCodeBlocks_.push_back( "" );
-
 	//	std::cout << "Printing Program in StreamOperator:" << std::endl;
 	//	this->print();
 	//	std::cout << "-----------------------------------" << std::endl;
 
 
 	checkConstraints();
-
-	return *this;
 }
 
 /*! \brief Reads kernel functions from an input stream into this Program.
@@ -575,15 +1354,20 @@ bool ocl::Program::operator !=(const Program& other) const
 /*! \brief Returns the Kernel from this Program by providing the Kernel's function name.*/
 ocl::Kernel& ocl::Program::kernel(const std::string &name)
 {
-#if 0
-	const_iterator it = _kernels.find(name);
-#else
-	auto it = std::find_if( _kernels.begin(), _kernels.end(), [&name]( std::unique_ptr< Kernel > const& k ){
-			return k->name() == name;
-} );
-#endif
-	if(it == _kernels.end()) throw std::runtime_error( "Kernel " + name + " does not exist yet");
-	return *it->get();
+	Kernel *k = this->find(name.data(), name.size(), nullptr);
+	if(k == nullptr) throw std::runtime_error( "Kernel " + name + " does not exist yet");
+	return *k;
+}
+
+/*! \brief Returns the Kernel from this Program by providing the Kernel's function name.
+	*
+	* The lookup does not allocate memory.
+*/
+ocl::Kernel& ocl::Program::kernel(const char *name)
+{
+	Kernel *k = this->find(name, std::strlen(name), nullptr);
+	if(k == nullptr) throw std::runtime_error( std::string("Kernel ") + name + " does not exist yet");
+	return *k;
 }
 
 /*! \brief Returns the Kernel from this Program by providing the Kernel's function name and its Type.*/
@@ -591,7 +1375,7 @@ template<class T>
 ocl::Kernel& ocl::Program::kernel(const std::string &name)
 {
 	const utl::Type& t = utl::Type::type<T>();
-	return kernel(name, t);
+	return kernel(name.c_str(), t);
 }
 
 template ocl::Kernel & ocl::Program::kernel<char>(const std::string &name) ;
@@ -600,39 +1384,432 @@ template ocl::Kernel & ocl::Program::kernel<size_t>(const std::string &name) ;
 template ocl::Kernel & ocl::Program::kernel<double>(const std::string &name) ;
 template ocl::Kernel & ocl::Program::kernel<float>(const std::string &name) ;
 
+/*! \brief Returns the Kernel from this Program by providing the Kernel's function name and its Type.
+	*
+	* The lookup does not allocate memory.
+*/
+template<class T>
+ocl::Kernel& ocl::Program::kernel(const char *name)
+{
+	const utl::Type& t = utl::Type::type<T>();
+	return kernel(name, t);
+}
+
+template ocl::Kernel & ocl::Program::kernel<char>(const char *name) ;
+template ocl::Kernel & ocl::Program::kernel<int>(const char *name) ;
+template ocl::Kernel & ocl::Program::kernel<size_t>(const char *name) ;
+template ocl::Kernel & ocl::Program::kernel<double>(const char *name) ;
+template ocl::Kernel & ocl::Program::kernel<float>(const char *name) ;
+
 
 /*! \brief Returns the Kernel from this Program by providing the Kernel's function name and its Type.*/
 ocl::Kernel & ocl::Program::kernel(const std::string &name, const utl::Type &t)
+{
+	return this->kernel(name.c_str(), t);
+}
+
+/*! \brief Returns the Kernel from this Program by providing the Kernel's function name and its Type.
+	*
+	* The template function name and the Type are looked up in the kernel index
+	* without allocating memory. Kernel functions that have been loaded already
+	* specialized are found by their function name kernel_<type>.
+*/
+ocl::Kernel & ocl::Program::kernel(const char *name, const utl::Type &t)
 {
 	if(_types.empty()) throw std::runtime_error( "Need types to specialize the kernels." );
-	if(!_types.contains(t)) throw std::runtime_error( "Type " +  t.name() + " not found.");
-	std::string n = name; n+= "_"; n+= t.name();
-	return this->kernel(n);
+	Kernel *k = this->find(name, std::strlen(name), &t);
+	if(k != nullptr) return *k;
+	if(std::none_of(_types.begin(), _types.end(), [&t](const utl::Type *u){ return *u == t; }))
+		throw std::runtime_error( "Type " +  t.name() + " not found.");
+	if(this->isLazyTemplate(name, std::strlen(name))){
+		this->typeGroup(t);
+		k = this->find(name, std::strlen(name), &t);
+		if(k != nullptr) return *k;
+	}
+	return this->kernel(name + ocl::Kernel::mangle(Arguments(1, t.name())));
+}
+
+/*! \brief Instantiates the templated Kernel function with the arguments and returns the Kernel.
+	*
+	* Templated Kernel functions with several parameters or non-type parameters,
+	* e.g. template<class T, class Acc, int TILE>, are not specialized when loaded.
+	* Only the combinations requested with this function are instantiated. The Kernel
+	* is named after the template and the mangled arguments, e.g. gemm_float_double_16,
+	* and can be looked up by that name as well. Trailing parameters with default
+	* arguments may be omitted. An existing instance is returned as is.
+	* The Kernel is created when this Program is built or linked afterwards.
+	* Throws if this Program has already been built with build(), as its
+	* executable does not contain new instances. Programs built with link()
+	* create the Kernel with the next link().
+	*
+	* \param name Function name of the templated Kernel function.
+	* \param arguments One type or value for each template parameter in declaration order.
+*/
+ocl::Kernel& ocl::Program::instantiate(const std::string &name, const Arguments &arguments)
+{
+	auto t = _templates.find(name);
+	const std::string full = name + ocl::Kernel::mangle(t == _templates.end() ? arguments : ocl::Kernel::completeArguments(t->second, arguments));
+	Kernel *k = this->find(full.data(), full.size(), nullptr);
+	if(k != nullptr) return *k;
+
+	if(t == _templates.end()) throw std::runtime_error( "Kernel template " + name + " does not exist");
+
+	if(this->isBuilt() && _objects.empty())
+		throw std::runtime_error( "Cannot instantiate " + full + " as the Program is already built. Instantiate kernel templates before build() or use compile() and link().");
+
+	std::unique_ptr< ocl::Kernel > kernel( new ocl::Kernel(*this, ocl::Kernel::specialize(t->second, arguments)) );
+	k = kernel.get();
+	insertKernel( std::move( kernel ), std::string(), nullptr );
+	_instances.push_back(std::make_pair(name, arguments));
+	clearVariants();
+	return *k;
+}
+
+/*! \brief Returns true if a templated Kernel function with the name awaits instantiation.*/
+bool ocl::Program::isTemplate(const std::string &name) const
+{
+	return _templates.find(name) != _templates.end();
+}
+
+/*! \brief Returns the Program with all lazy templates specialized and built for the Type.
+  *
+  * The Program is built on first use and its Kernel objects are added to
+  * the index of this Program by their template name and Type.
+*/
+ocl::Program& ocl::Program::typeGroup(const utl::Type &type)
+{
+	auto found = _typeGroups.find(std::type_index(type.info()));
+	if(found != _typeGroups.end()) return *found->second;
+
+	if(this->_context == 0) throw std::runtime_error( "Program has no Context");
+
+	std::unique_ptr<Program> group( new Program(*_context, _options) );
+	*group << this->helpers();
+	for(const auto &t : _lazyTemplates)
+		*group << ocl::Kernel::specialize(t.second, type.name());
+	group->build();
+
+	const std::string suffix = ocl::Kernel::mangle(Arguments(1, type.name()));
+	for(const auto &t : _lazyTemplates)
+		index(t.first, &type, &group->kernel(t.first + suffix));
+
+	Program &g = *group;
+	_typeGroups[std::type_index(type.info())] = std::move(group);
+	return g;
+}
+
+/*! \brief Releases the Programs built for lazy templates. */
+void ocl::Program::clearTypeGroups()
+{
+	if(_typeGroups.empty()) return;
+
+	for(const auto &g : _typeGroups)
+		for(const auto &k : g.second->_kernels)
+			unindex(k.get());
+
+	_typeGroups.clear();
+	++_generation;
+}
+
+/*! \brief Returns a KernelHandle for the Kernel with the specified function name.*/
+ocl::KernelHandle ocl::Program::handle(const std::string &name)
+{
+	return ocl::KernelHandle(*this, name);
+}
+
+/*! \brief Returns a KernelHandle for the Kernel with the specified function name and Type.*/
+ocl::KernelHandle ocl::Program::handle(const std::string &name, const utl::Type &t)
+{
+	return ocl::KernelHandle(*this, name, &t);
+}
+
+/*! \brief Returns the number of times Kernel objects of this Program have been added, replaced or removed.*/
+size_t ocl::Program::generation() const
+{
+	return _generation;
+}
+
+/*! \brief Returns the Kernel of the variant of this Program specialized by the Defines.
+	*
+	* See variant(const Defines&).
+*/
+ocl::Kernel& ocl::Program::kernel(const std::string &name, const Defines &defines)
+{
+	return this->variant(defines).kernel(name);
+}
+
+/*! \brief Returns the Kernel with the specified Type of the variant of this Program specialized by the Defines.
+	*
+	* See variant(const Defines&).
+*/
+ocl::Kernel& ocl::Program::kernel(const std::string &name, const utl::Type &t, const Defines &defines)
+{
+	return this->variant(defines).kernel(name, t);
+}
+
+/*! \brief Returns the built variant of this Program specialized by the Defines.
+	*
+	* A variant is a Program with the Kernel functions and Types of this Program
+	* which is built with the CompileOption of this Program extended by
+	* -D name=value for each of the Defines. Variants are built on demand and
+	* cached so that switching between compile-time constants such as problem or
+	* tile sizes does not rebuild. A variant reads the same source as this Program
+	* and instantiates the same Kernel templates. If more than variantLimit() variants
+	* are resident, the least recently used one is released. Kernel references
+	* obtained from a released variant become invalid. This Program itself does
+	* not have to be built.
+	*
+	* Names and values must not contain whitespace as build options are not quoted
+	* portably. Use a typedef in the source for types such as unsigned int.
+	* The options are composed on each call in order to look up the variant, so keep
+	* the returned Program or Kernel instead of calling this function in a hot loop.
+*/
+ocl::Program& ocl::Program::variant(const Defines &defines)
+{
+	std::string key;
+	for(const auto &d : defines){
+		if(d.first.empty() || (d.first + d.second).find_first_of(" \t\n\r\f\v") != std::string::npos)
+			throw std::runtime_error( "Define '" + d.first + "=" + d.second + "' must have a name and must not contain whitespace");
+		key += " -D " + d.first + "=" + d.second;
+	}
+
+	auto found = _variantIndex.find(key);
+	if(found != _variantIndex.end()){
+		_variants.splice(_variants.begin(), _variants, found->second);
+		return *found->second->second;
+	}
+
+	if(this->_context == 0) throw std::runtime_error( "Program has no Context");
+	if(_kernels.empty()) throw std::runtime_error( "No kernels loaded for the program");
+	if(this->isIL()) throw std::runtime_error( "Variants are not supported for Programs created from IL. Use specialization constants instead.");
+
+	std::unique_ptr<Program> program( _types.empty() ?
+		new Program(*_context, _options | key) : new Program(*_context, _types, _options | key) );
+	program->setLazy(_lazy);
+	for(const auto &source : _sources)
+		program->read(source);
+	for(const auto &i : _instances)
+		program->instantiate(i.first, i.second);
+	program->build();
+
+	_variants.emplace_front(key, std::move(program));
+	_variantIndex[key] = _variants.begin();
+
+	while(_variants.size() > _variantLimit){
+		_variantIndex.erase(_variants.back().first);
+		_variants.pop_back();
+	}
+	return *_variants.front().second;
+}
+
+/*! \brief Sets the maximum number of resident variants of this Program.
+	*
+	* The limit is default_variant_limit unless changed.
+	* Least recently used variants exceeding the limit are released.
+*/
+void ocl::Program::setVariantLimit(size_t limit)
+{
+	if(limit == 0) throw std::runtime_error( "Variant limit must be greater 0.");
+	_variantLimit = limit;
+	while(_variants.size() > _variantLimit){
+		_variantIndex.erase(_variants.back().first);
+		_variants.pop_back();
+	}
+}
+
+/*! \brief Returns the maximum number of resident variants of this Program. */
+size_t ocl::Program::variantLimit() const
+{
+	return _variantLimit;
+}
+
+/*! \brief Returns the number of resident variants of this Program. */
+size_t ocl::Program::numberOfVariants() const
+{
+	return _variants.size();
+}
+
+/*! \brief Releases all variants of this Program.
+	*
+	* Called whenever the Kernel functions or the CompileOption of this Program change.
+*/
+void ocl::Program::clearVariants()
+{
+	_variantIndex.clear();
+	_variants.clear();
 }
 
 /*! \brief Returns true if the Kernel specified by its function name exist.*/
 bool ocl::Program::exists(const std::string &name) const
 {
-	return std::find_if( _kernels.begin(), _kernels.end(), [&name]( std::unique_ptr< Kernel > const& k ){
-		return k->name() == name;
-	}) != _kernels.end();
+	return this->find(name.data(), name.size(), nullptr) != nullptr;
 }
 
 /*! \brief Destroys the Kernel specified by its function name. */
 void ocl::Program::deleteKernel(const std::string &name)
 {
-	iterator it = std::find_if( _kernels.begin(), _kernels.end(), [&name]( std::unique_ptr< Kernel > const& k ){
-			return k->name() == name;
-});
+	Kernel *k = this->find(name.data(), name.size(), nullptr);
+	if(k == nullptr) throw std::runtime_error( "Kernel " + name + " does not exist yet");
 
-	if(it == _kernels.end()) throw std::runtime_error( "Kernel " + name + " does not exist yet");
-	/*const Kernel *__k = it->second;
-	delete __k;*/
-	_kernels.erase(it);
+	eraseKernel(k);
+	++_generation;
+	clearVariants();
+	clearTypeGroups();
 
 	checkConstraints();
 }
 
+/*! \brief Inserts the Kernel into this Program and its index.
+  *
+  * A Kernel with the same function name is replaced. If a Type is
+  * specified, the Kernel is additionally indexed by its template name and Type.
+*/
+void ocl::Program::insertKernel(std::unique_ptr< Kernel > kernel, const std::string &templateName, const utl::Type *type)
+{
+	Kernel *k = kernel.get();
+	Kernel *existing = this->find(k->name().data(), k->name().size(), nullptr);
+
+	// A replaced Kernel moves behind the auxiliary code read with it.
+	if ( existing != nullptr ) eraseKernel(existing);
+	_kernels.push_back( std::move( kernel ) );
+
+	index(k->name(), nullptr, k);
+	if(type != nullptr) index(templateName, type, k);
+	++_generation;
+}
+
+/*! \brief Removes the Kernel from this Program and its index.
+  *
+  * Auxiliary code which preceded the Kernel precedes the next Kernel afterwards.
+*/
+void ocl::Program::eraseKernel(const Kernel *kernel)
+{
+	auto it = std::find_if( _kernels.begin(), _kernels.end(), [kernel]( std::unique_ptr< Kernel > const& p ){ return p.get() == kernel; } );
+	const size_t position = size_t(it - _kernels.begin());
+	unindex(kernel);
+	_kernels.erase(it);
+	for(auto &block : commonCodeBlocks_)
+		if(block.position > position) --block.position;
+}
+
+/*! \brief Returns the Kernel indexed by the name and Type or nullptr.
+  *
+  * The name does not have to be null-terminated.
+*/
+ocl::Kernel* ocl::Program::find(const char *name, size_t length, const utl::Type *type) const
+{
+	const std::type_info *info = type == nullptr ? nullptr : &type->info();
+	auto range = _index.equal_range(hash(name, length, info));
+	for(auto it = range.first; it != range.second; ++it){
+		const IndexEntry &e = it->second;
+		if((e.type == nullptr) != (info == nullptr) || (info != nullptr && *e.type != *info)) continue;
+		if(e.name.size() == length && e.name.compare(0, length, name, length) == 0)
+			return e.kernel;
+	}
+	return nullptr;
+}
+
+/*! \brief Returns true if the templated kernel function awaits a Type on first use.
+  *
+  * The names are compared in order by length and characters so that no
+  * std::string is constructed for the lookup.
+*/
+bool ocl::Program::isLazyTemplate(const char *name, size_t length) const
+{
+	for(const auto &t : _lazyTemplates){
+		const int c = t.first.compare(0, t.first.size(), name, length);
+		if(c == 0) return true;
+		if(c > 0) return false;
+	}
+	return false;
+}
+
+/*! \brief Adds the Kernel to the index by the name and Type.
+  *
+  * Types are compared by their type_info so that equal Type objects find the same Kernel.
+*/
+void ocl::Program::index(const std::string &name, const utl::Type *type, Kernel *kernel)
+{
+	IndexEntry entry = { name, type == nullptr ? nullptr : &type->info(), kernel };
+	const size_t key = hash(name.data(), name.size(), entry.type);
+	_index.insert(std::make_pair(key, entry));
+	_indexKeys[kernel].push_back(key);
+}
+
+/*! \brief Removes all index entries of the Kernel by their keys.*/
+void ocl::Program::unindex(const Kernel *kernel)
+{
+	auto keys = _indexKeys.find(kernel);
+	if(keys == _indexKeys.end()) return;
+
+	for(size_t key : keys->second){
+		auto range = _index.equal_range(key);
+		for(auto it = range.first; it != range.second; ){
+			if(it->second.kernel == kernel) it = _index.erase(it);
+			else ++it;
+		}
+	}
+	_indexKeys.erase(keys);
+}
+
+/*! \brief Hashes the name and the type_info of a Type of a Kernel for the index.*/
+size_t ocl::Program::hash(const char *name, size_t length, const std::type_info *type)
+{
+	// FNV-1a over the characters, combined with the hash of the type_info.
+	size_t h = 2166136261u;
+	for(size_t i = 0; i < length; ++i)
+		h = (h ^ static_cast<unsigned char>(name[i])) * 16777619u;
+	return h ^ ((type == nullptr ? 0 : type->hash_code()) + 0x9e3779b9u + (h << 6) + (h >> 2));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \brief Instantiates an empty KernelHandle which does not refer to any Kernel.*/
+ocl::KernelHandle::KernelHandle() :
+	_program(nullptr), _name(), _type(nullptr), _kernel(nullptr), _generation(0)
+{
+}
+
+/*! \brief Instantiates this KernelHandle for the Kernel with the function name and optional Type.
+	*
+	* The Kernel is not resolved before it is accessed the first time.
+*/
+ocl::KernelHandle::KernelHandle(Program &program, const std::string &name, const utl::Type *type) :
+	_program(&program), _name(name), _type(type), _kernel(nullptr), _generation(0)
+{
+}
+
+/*! \brief Returns the Kernel of this KernelHandle.
+	*
+	* The Kernel is only looked up again if the Program changed its Kernel objects.
+*/
+ocl::Kernel& ocl::KernelHandle::kernel() const
+{
+	if(_program == nullptr) throw std::runtime_error( "KernelHandle does not refer to a Program.");
+	if(_kernel == nullptr || _generation != _program->generation()){
+		_kernel = _type == nullptr ? &_program->kernel(_name) : &_program->kernel(_name, *_type);
+		_generation = _program->generation();
+	}
+	return *_kernel;
+}
+
+/*! \brief Returns the Kernel of this KernelHandle.*/
+ocl::Kernel& ocl::KernelHandle::operator*() const
+{
+	return this->kernel();
+}
+
+/*! \brief Returns the Kernel of this KernelHandle.*/
+ocl::Kernel* ocl::KernelHandle::operator->() const
+{
+	return &this->kernel();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
 
 
 
@@ -670,6 +1847,12 @@ void ocl::Program::eraseComments(std::string &kernels) const
 
 /*! \brief Checks whether the build process was successfull or not.*/
 void ocl::Program::checkBuild(cl_int buildErr) const
+{
+	checkBuild(_id, buildErr);
+}
+
+/*! \brief Checks whether the build process of the specified program was successfull or not.*/
+void ocl::Program::checkBuild(cl_program program, cl_int buildErr) const
 {
 	// Exiting the program is not acceptable.
 	if ( buildErr == CL_SUCCESS )
@@ -683,9 +1866,9 @@ void ocl::Program::checkBuild(cl_int buildErr) const
 	{
 		cl_build_status buildStatus = CL_SUCCESS;
 
-		clGetProgramBuildInfo( _id, device.id(), CL_PROGRAM_BUILD_STATUS, sizeof buildStatus, &buildStatus, nullptr );
+		clGetProgramBuildInfo( program, device.id(), CL_PROGRAM_BUILD_STATUS, sizeof buildStatus, &buildStatus, nullptr );
 
-		if ( buildStatus != CL_SUCCESS )
+		if ( buildStatus != CL_SUCCESS && buildStatus != CL_BUILD_NONE )
 		{
 			if ( !headerSet )
 			{
@@ -695,11 +1878,11 @@ void ocl::Program::checkBuild(cl_int buildErr) const
 
 			size_t size = 0u;
 
-			clGetProgramBuildInfo( _id, device.id(), CL_PROGRAM_BUILD_LOG, 0u, nullptr, &size );
+			clGetProgramBuildInfo( program, device.id(), CL_PROGRAM_BUILD_LOG, 0u, nullptr, &size );
 
 			std::unique_ptr< cl_char[] > buildLog( new cl_char[size] );
 
-			clGetProgramBuildInfo( _id, device.id(), CL_PROGRAM_BUILD_LOG, size, buildLog.get(), nullptr );
+			clGetProgramBuildInfo( program, device.id(), CL_PROGRAM_BUILD_LOG, size, buildLog.get(), nullptr );
 
 			oss << "Device " << device.name() << " Build Log:\n" << buildLog.get() << '\n';
 		}
@@ -707,6 +1890,8 @@ void ocl::Program::checkBuild(cl_int buildErr) const
 
 	if ( !oss.str().empty() )
 		throw std::runtime_error( oss.str() );
+
+	OPENCL_SAFE_CALL( buildErr );
 }
 
 void ocl::Program::checkConstraints() const
@@ -30,6 +30,8 @@
 #include <memory>
 
 #include <ocl_query.h>
+#include <ocl_device_info.h>
+#include <ocl_platform_info.h>
 
 /*
  * Since CL_KHR_ICD is an extension, some platforms (e. g. OS X) may not
@@ -46,38 +48,33 @@ using namespace std;
 bool ocl::exists(cl_platform_id id)
 {
 	if(id == nullptr) throw std::runtime_error("invalid platform");
-	const vector<cl_platform_id>& pltfs = platforms();
-	return find(pltfs.begin(), pltfs.end(), id) != pltfs.end();
+	for(const auto &platform : PlatformInfo::all())
+		if(platform->id() == id) return true;
+	return false;
 }
 
 
-/*! \brief Returns all available OpenCL platforms. */
+/*! \brief Returns all available OpenCL platforms.
+  *
+  * The platforms are enumerated once. See PlatformInfo::refresh().
+  */
 vector<cl_platform_id> ocl::platforms()
 {
-	cl_uint numPlatforms = 0;
-
-	// Query for the number of recongnized platforms
-	OPENCL_SAFE_CALL( clGetPlatformIDs(0, NULL, &numPlatforms));
-	if(numPlatforms <= 0) throw std::runtime_error("no platforms available");
-	vector<cl_platform_id> pltfs(numPlatforms, 0);
-	OPENCL_SAFE_CALL( clGetPlatformIDs(numPlatforms, pltfs.data(), NULL));
-
+	const auto &infos = PlatformInfo::all();
+	if(infos.empty()) throw std::runtime_error("no platforms available");
+	vector<cl_platform_id> pltfs;
+	for(const auto &platform : infos) pltfs.push_back(platform->id());
 	return pltfs;
 }
 
-/*! \brief Returns all available OpenCL devices for the specified OpenCL platform. */
+/*! \brief Returns all available OpenCL devices for the specified OpenCL platform.
+  *
+  * The devices are enumerated once. See PlatformInfo::refresh().
+  */
 vector<cl_device_id> ocl::devices(cl_platform_id id)
 {
 	if(id == nullptr) throw std::runtime_error("invalid platform");
-
-	cl_uint numDevices = 0;
-	// Retrieve the number of devices present on the specified platform of the specified deviceType
-	OPENCL_SAFE_CALL( clGetDeviceIDs(id, CL_DEVICE_TYPE_ALL, 0, NULL,  &numDevices) );
-//	if(numPlatforms <= 0) throw std::runtime_error("no platforms available");
-
-	vector<cl_device_id> devs(numDevices,0);
-	OPENCL_SAFE_CALL( clGetDeviceIDs(id, CL_DEVICE_TYPE_ALL, numDevices, &devs[0], NULL) );
-	return devs;
+	return PlatformInfo::get(id)->devices();
 }
 
 
@@ -125,46 +122,34 @@ void ocl::printPlatform(cl_platform_id id,
 	}
 }
 
-static std::string getPlatformInfo(cl_platform_id id, cl_platform_info info)
-{
-	if(id == nullptr) throw std::runtime_error("invalid platform");
-	size_t size = 0;
-	OPENCL_SAFE_CALL( clGetPlatformInfo(id, info,  0, 0, &size));
-	if(size <= 0) throw std::runtime_error("could not retrieve platform profile");
-
-	std::unique_ptr< char[] > buffer( new char[size] );
-	OPENCL_SAFE_CALL( clGetPlatformInfo(id, info, size, buffer.get(), NULL));
-	return buffer.get();
-}
-
 /*! \brief Returns the profile of the specified OpenCL platform. */
 std::string ocl::profile(cl_platform_id id)
 {
-	return getPlatformInfo(id,CL_PLATFORM_PROFILE);
+	return PlatformInfo::get(id)->profile();
 }
 
 /*! \brief Returns the version of the specified OpenCL platform. */
 std::string ocl::version(cl_platform_id id)
 {
-	return getPlatformInfo(id,CL_PLATFORM_VERSION);
+	return PlatformInfo::get(id)->version();
 }
 
 /*! \brief Returns the name of the specified OpenCL platform. */
 std::string ocl::name(cl_platform_id id)
 {
-	return getPlatformInfo(id,CL_PLATFORM_NAME);
+	return PlatformInfo::get(id)->name();
 }
 
 /*! \brief Returns the vendor of the specified OpenCL platform. */
 std::string ocl::vendor(cl_platform_id id)
 {
-	return getPlatformInfo(id,CL_PLATFORM_VENDOR);
+	return PlatformInfo::get(id)->vendor();
 }
 
 /*! \brief Returns the extensions of the specified OpenCL platform. */
 std::string ocl::extensions(cl_platform_id id)
 {
-	return getPlatformInfo(id,CL_PLATFORM_EXTENSIONS);
+	return PlatformInfo::get(id)->extensions();
 }
 
 
@@ -206,47 +191,34 @@ void ocl::printDevice(cl_device_id id,
 	if(print_extensions) out << "Device Extensions : " << ocl::extensions(id) << endl;
 }
 
-static std::string getDeviceInfo(cl_device_id id, cl_device_info info)
-{
-	if(id == nullptr) throw std::runtime_error("invalid platform");
-	size_t size = 0;
-	OPENCL_SAFE_CALL( clGetDeviceInfo(id, info,  0, 0, &size));
-	if(size <= 0) throw std::runtime_error("Cannot retrieve device information");
-
-	std::unique_ptr< char[] > buffer( new char[size] );
-	OPENCL_SAFE_CALL( clGetDeviceInfo(id, info, size, buffer.get(), NULL));
-	return buffer.get();
-}
-
-
 /*! \brief Returns the profile of the specified OpenCL device. */
 std::string ocl::profile(cl_device_id id)
 {
-	return getDeviceInfo(id,CL_DEVICE_PROFILE);
+	return DeviceInfo::get(id)->profile();
 }
 
 /*! \brief Returns the version of the specified OpenCL device. */
 std::string ocl::version(cl_device_id id)
 {
-	return getDeviceInfo(id,CL_DEVICE_VERSION);
+	return DeviceInfo::get(id)->version();
 }
 
 /*! \brief Returns the name of the specified OpenCL device. */
 std::string ocl::name(cl_device_id id)
 {
-	return getDeviceInfo(id,CL_DEVICE_NAME);
+	return DeviceInfo::get(id)->name();
 }
 
 /*! \brief Returns the vendor of the specified OpenCL device. */
 std::string ocl::vendor(cl_device_id id)
 {
-	return getDeviceInfo(id,CL_DEVICE_VENDOR);
+	return DeviceInfo::get(id)->vendor();
 }
 
 /*! \brief Returns the extensions of the specified OpenCL device. */
 std::string ocl::extensions(cl_device_id id)
 {
-	return getDeviceInfo(id,CL_DEVICE_EXTENSIONS);
+	return DeviceInfo::get(id)->extensions();
 }
 
 
@@ -254,9 +226,7 @@ std::string ocl::extensions(cl_device_id id)
 cl_device_type ocl::deviceType(cl_device_id id)
 {
 	if(id == nullptr) throw std::runtime_error("invalid platform");
-	cl_device_type t;
-	OPENCL_SAFE_CALL( clGetDeviceInfo (id,CL_DEVICE_TYPE, sizeof(t), &t, NULL) );
-	return t;
+	return DeviceInfo::get(id)->type();
 }
 
 
@@ -272,6 +242,12 @@ double ocl::execTime(cl_event event)
 	return double(end - start); // returns in nanoseconds
 }
 
+/*! \brief Returns true if the library has been compiled with OCL_CHECKED. */
+bool ocl::checked()
+{
+	return OCL_CHECKED != 0;
+}
+
 /*! brief Auxiliary function for calling OpenCL routines. */
 void ocl::safe_call(cl_int status, const std::string file, const std::string function, const int line)
 {
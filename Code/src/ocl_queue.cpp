@@ -16,6 +16,7 @@
 //along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <ocl_platform.h>
+#include <ocl_platform_info.h>
 #include <ocl_query.h>
 #include <ocl_device.h>
 #include <ocl_queue.h>
@@ -82,21 +83,6 @@ void ocl::Queue::setContext(ocl::Context &ctxt)
     _context = &ctxt;
 }
 
-#if CL_VERSION_2_0
-static bool supportsAtLeast2Point0( cl_platform_id id )
-{
-  char version[128];
-  size_t versionLen = 0;
-  
-  clGetPlatformInfo( id, CL_PLATFORM_VERSION, 128, version, &versionLen );
-  
-  int major = 0, minor = 0;
-  
-  std::sscanf( version, "OpenCL %i.%i", &major, &minor );
-  
-  return major > 1;
-}
-#endif
 
 /*! \brief Creates cl_command_queue for this Queue.
   *
@@ -117,7 +103,7 @@ void ocl::Queue::create(ocl::Context * ctxt)
 	cl_int status;
 	
 #if CL_VERSION_2_0
-  if ( supportsAtLeast2Point0( device().platform() ) )
+  if ( ocl::PlatformInfo::get( device().platform() )->supportsVersion(2, 0) )
   {
     cl_queue_properties propties[] = {
       CL_QUEUE_PROPERTIES, this->properties(),
@@ -145,6 +131,7 @@ void ocl::Queue::release()
     if(this->created()){
         OPENCL_SAFE_CALL( clReleaseCommandQueue (_id));
     }
+	if(_context != 0) _context->remove(this);
 	_device = 0;
 	_context = 0;
     _id = 0;
@@ -246,7 +233,7 @@ void ocl::Queue::finish() const
 */
 void ocl::Queue::barrier(const EventList&  list ) const
 {
-    OPENCL_SAFE_CALL(  clEnqueueBarrierWithWaitList (this->id(),  list.size(), list.events().data(), 0) );
+    OPENCL_SAFE_CALL(  clEnqueueBarrierWithWaitList (this->id(),  list.size(), list.data(), 0) );
 }
 
 /*! \brief Returns the Context for this Queue.
@@ -0,0 +1,201 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <stdexcept>
+
+#include <ocl_queue_pool.h>
+#include <ocl_context.h>
+#include <ocl_device.h>
+#include <ocl_query.h>
+
+
+/*! \brief Instantiates this QueuePool with the specified number of Queue objects for the Device.
+  *
+  * \param ctxt is the Context of the Queue objects.
+  * \param device is the Device for which the Queue objects are created.
+  * \param size is the number of Queue objects.
+  * \param properties are the properties of each Queue.
+  * \param policy determines how the Queue for the next command is selected.
+  */
+ocl::QueuePool::QueuePool(Context &ctxt, const Device &device, size_t size, Queue::props properties, Policy policy) :
+	_context(&ctxt), _policy(policy), _slots(), _cursor(0), _mutex(), _completed()
+{
+	if(size == 0) throw std::runtime_error( "QueuePool must have at least one Queue");
+	this->create(device, size, properties);
+}
+
+/*! \brief Instantiates this QueuePool with the specified number of Queue objects for each Device of the Context.
+  *
+  * Commands are dispatched across all Device objects. Use next(const Device&)
+  * in order to dispatch commands to a specific Device.
+  */
+ocl::QueuePool::QueuePool(Context &ctxt, size_t sizePerDevice, Queue::props properties, Policy policy) :
+	_context(&ctxt), _policy(policy), _slots(), _cursor(0), _mutex(), _completed()
+{
+	if(sizePerDevice == 0) throw std::runtime_error( "QueuePool must have at least one Queue");
+	for(const auto &device : ctxt.devices())
+		this->create(device, sizePerDevice, properties);
+}
+
+/*! \brief Destructs this QueuePool.
+  *
+  * Waits until all commands of its Queue objects are completed
+  * and releases them from the Context.
+  */
+ocl::QueuePool::~QueuePool()
+{
+	_context->remove(this);
+	this->finish();
+	// Completion callbacks may still be running after finish returned.
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_completed.wait(lock, [this]{ return this->inFlight() == 0; });
+	}
+	for(const auto &slot : _slots)
+		_context->release(slot->queue.get());
+}
+
+/*! \brief Creates the Queue objects for the Device. */
+void ocl::QueuePool::create(const Device &device, size_t size, Queue::props properties)
+{
+	for(size_t i = 0; i < size; ++i)
+		_slots.emplace_back( new Slot( this, new Queue(*_context, device, properties) ) );
+}
+
+/*! \brief Returns the Queue for the next command according to the Policy. */
+ocl::Queue& ocl::QueuePool::next()
+{
+	return this->select(nullptr);
+}
+
+/*! \brief Returns the Queue of the Device for the next command according to the Policy. */
+ocl::Queue& ocl::QueuePool::next(const Device &device)
+{
+	return this->select(&device);
+}
+
+/*! \brief Selects the Queue among all Queue objects or among those of the Device.
+  *
+  * The search starts at a rotating position so that Queue objects
+  * with equal load are used in turn.
+*/
+ocl::Queue& ocl::QueuePool::select(const Device *device)
+{
+	const size_t n = _slots.size();
+	const size_t start = _cursor++ % n;
+	const Policy policy = _policy;
+
+	Slot *selected = nullptr;
+	size_t load = 0;
+	for(size_t i = 0; i < n; ++i){
+		Slot *slot = _slots[(start + i) % n].get();
+		if(device != nullptr && slot->queue->device() != *device) continue;
+		const size_t l = slot->inFlight;
+		if(selected == nullptr || l < load){
+			selected = slot;
+			load = l;
+		}
+		if(policy == RoundRobin || load == 0) break;
+	}
+	if(selected == nullptr) throw std::runtime_error( "QueuePool has no Queue for the Device");
+	return *selected->queue;
+}
+
+/*! \brief Returns the Queue at the specified position. */
+ocl::Queue& ocl::QueuePool::queue(size_t pos) const
+{
+	return *_slots.at(pos)->queue;
+}
+
+/*! \brief Returns the number of Queue objects of this QueuePool. */
+size_t ocl::QueuePool::size() const
+{
+	return _slots.size();
+}
+
+/*! \brief Returns the number of tracked commands in flight on all Queue objects. */
+size_t ocl::QueuePool::inFlight() const
+{
+	size_t n = 0;
+	for(const auto &slot : _slots) n += slot->inFlight;
+	return n;
+}
+
+/*! \brief Returns the number of tracked commands in flight on the Queue at the specified position. */
+size_t ocl::QueuePool::inFlight(size_t pos) const
+{
+	return _slots.at(pos)->inFlight;
+}
+
+/*! \brief Sets the Policy by which the Queue for the next command is selected. */
+void ocl::QueuePool::setPolicy(Policy policy)
+{
+	_policy = policy;
+}
+
+/*! \brief Returns the Policy by which the Queue for the next command is selected. */
+ocl::QueuePool::Policy ocl::QueuePool::policy() const
+{
+	return _policy;
+}
+
+/*! \brief Returns the Context of this QueuePool. */
+ocl::Context& ocl::QueuePool::context() const
+{
+	return *_context;
+}
+
+/*! \brief Counts the command of the Event as in flight on the Queue until the Event completes.
+  *
+  * Events of Queue objects which do not belong to this QueuePool are ignored.
+  * Returns the Event.
+*/
+const ocl::Event& ocl::QueuePool::track(const Queue &queue, const Event &event)
+{
+	for(auto &slot : _slots){
+		if(*slot->queue != queue) continue;
+		++slot->inFlight;
+		const cl_int status = clSetEventCallback(event.id(), CL_COMPLETE, &QueuePool::complete, slot.get());
+		if(status != CL_SUCCESS){
+			--slot->inFlight;
+			OPENCL_SAFE_CALL(status);
+		}
+		break;
+	}
+	return event;
+}
+
+/*! \brief Decrements the number of commands in flight of the Slot and wakes up a destructing QueuePool. */
+void CL_CALLBACK ocl::QueuePool::complete(cl_event, cl_int, void *data)
+{
+	Slot *slot = static_cast<Slot*>(data);
+	std::lock_guard<std::mutex> lock(slot->pool->_mutex);
+	--slot->inFlight;
+	slot->pool->_completed.notify_all();
+}
+
+/*! \brief Flushes all Queue objects of this QueuePool. */
+void ocl::QueuePool::flush() const
+{
+	for(const auto &slot : _slots) slot->queue->flush();
+}
+
+/*! \brief Blocks until all commands of all Queue objects of this QueuePool are completed. */
+void ocl::QueuePool::finish() const
+{
+	for(const auto &slot : _slots) slot->queue->finish();
+}
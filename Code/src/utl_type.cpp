@@ -77,6 +77,13 @@ const utl::Type* utl::Type::operator ()() const
     return this;
 }
 
+const utl::Type& utl::Type::type(const std::type_info& __info)
+{
+	for(auto __t : _allTypes) { if(*__t == __info) return *__t; }
+	assert(0);
+	throw std::runtime_error(std::string("Type with id ") + __info.name() + " not found");
+}
+
 
 
 namespace utl{
@@ -0,0 +1,137 @@
+//Copyright (C) 2013 Cem Bassoy.
+//
+//This file is part of the OpenCL Utility Toolkit.
+//
+//OpenCL Utility Toolkit is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//OpenCL Utility Toolkit is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with OpenCL Utility Toolkit.  If not, see <http://www.gnu.org/licenses/>.
+
+// oclpc - offline precompiler for OpenCL kernel files.
+//
+// Builds each kernel file as an ocl::Program for all devices of all available
+// platforms and writes the binaries into an ocl::Bundle. The bundle is written
+// either as a binary file or as a C++ source file defining
+//
+//   extern const unsigned char <symbol>[];
+//   extern const size_t <symbol>_size;
+//
+// which can be compiled into an executable and passed to ocl::Bundle.
+// Types, include paths and build options must be the same as those
+// of the Program at runtime, otherwise it falls back to the source.
+//
+// Usage: oclpc [-t type]... [-I dir]... [-b options] [-s symbol] -o output file.cl...
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <ocl_wrapper.h>
+
+namespace {
+
+void usage()
+{
+	std::cerr << "usage: oclpc [-t type]... [-I dir]... [-b options] [-s symbol] -o output file.cl..." << std::endl
+	          << "  -t type     type by which templated kernels are specialized (float, double, int, ...)" << std::endl
+	          << "  -I dir      directory in which included modules are searched" << std::endl
+	          << "  -b options  build options of the program" << std::endl
+	          << "  -s symbol   writes a C++ source defining the bundle as symbol instead of a binary file" << std::endl
+	          << "  -o output   output file" << std::endl;
+}
+
+const utl::Type& type(const std::string &name)
+{
+	for(const utl::Type *t : { &utl::type::Double, &utl::type::Single, &utl::type::Int, &utl::type::UInt,
+	                           &utl::type::Char, &utl::type::SChar, &utl::type::UChar })
+		if(t->name() == name) return *t;
+	throw std::runtime_error( "Unknown type " + name);
+}
+
+void writeSource(std::ostream &out, const std::string &symbol, const std::vector<unsigned char> &data)
+{
+	out << "// Generated by oclpc. Do not edit." << std::endl
+	    << "#include <cstddef>" << std::endl << std::endl
+	    << "extern const unsigned char " << symbol << "[];" << std::endl
+	    << "extern const size_t " << symbol << "_size;" << std::endl << std::endl
+	    << "const unsigned char " << symbol << "[] = {";
+	for(size_t i = 0; i < data.size(); ++i){
+		if(i % 16 == 0) out << std::endl << "\t";
+		out << "0x" << std::hex << std::setw(2) << std::setfill('0') << int(data[i]) << ",";
+	}
+	out << std::dec << std::endl << "};" << std::endl
+	    << "const size_t " << symbol << "_size = " << data.size() << ";" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	utl::Types types;
+	std::vector<std::string> includePaths, files;
+	std::string options, symbol, output;
+
+	for(int i = 1; i < argc; ++i){
+		const std::string arg = argv[i];
+		const bool value = i + 1 < argc;
+		if     (arg == "-t" && value) types << type(argv[++i]);
+		else if(arg == "-I" && value) includePaths.push_back(argv[++i]);
+		else if(arg == "-b" && value) options = argv[++i];
+		else if(arg == "-s" && value) symbol = argv[++i];
+		else if(arg == "-o" && value) output = argv[++i];
+		else if(!arg.empty() && arg[0] != '-') files.push_back(arg);
+		else { usage(); return 1; }
+	}
+	if(output.empty() || files.empty()) { usage(); return 1; }
+
+	try{
+		cl_uint count = 0;
+		if(clGetPlatformIDs(0, NULL, &count) != CL_SUCCESS) count = 0;
+		std::vector<cl_platform_id> ids(count);
+		if(count > 0) OPENCL_SAFE_CALL( clGetPlatformIDs(count, ids.data(), NULL) );
+
+		ocl::Bundle bundle;
+		for(cl_platform_id id : ids){
+			ocl::Platform platform(id);
+			if(platform.devices().empty()) continue;
+			ocl::Context context(platform.devices());
+
+			for(const auto &file : files){
+				std::unique_ptr<ocl::Program> program( types.empty() ?
+					new ocl::Program(context, ocl::CompileOption(options)) : new ocl::Program(context, types, ocl::CompileOption(options)) );
+				for(const auto &path : includePaths) program->addIncludePath(path);
+				std::ifstream stream(file.c_str());
+				*program << stream;
+				program->build();
+				bundle.add(program->binaries());
+				std::cout << file << ": built for " << platform.devices().size() << " device(s)" << std::endl;
+			}
+		}
+		if(bundle.empty())
+			std::cerr << "oclpc: warning: no devices available, writing an empty bundle" << std::endl;
+
+		std::ofstream out(output.c_str(), symbol.empty() ? std::ios::binary : std::ios::out);
+		if(out.fail()) throw std::runtime_error( "Could not open " + output);
+		if(symbol.empty())
+			bundle.write(out);
+		else
+			writeSource(out, symbol, bundle.serialize());
+	}
+	catch(const std::exception &e){
+		std::cerr << "oclpc: " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
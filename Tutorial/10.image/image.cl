@@ -28,3 +28,16 @@ __kernel void add4(int cols, int rows, write_only image2d_t C, read_only image2d
 
 }
 
+
+__kernel void add4_buffer(int cols, int rows, __global float4 *C, __global const float4 *A, __global const float4 *B)
+{
+	size_t x = get_global_id(0); // col of float4
+	size_t y = get_global_id(1); // row
+
+	if(x >= (cols>>2) || y >= rows) return;
+
+	size_t i = y*(cols>>2) + x;
+
+	C[i] = A[i] + B[i];
+
+}
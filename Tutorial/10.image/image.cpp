@@ -256,6 +256,62 @@ int main(int /*argc*/, char** /*argv*/)
 			if(A+B != C) std::cout << "Computation result: FALSE" << std::endl;
 			else         std::cout << "Computation result: TRUE" << std::endl;
 		}
+
+
+
+		// images as views over buffers require OpenCL 2.0 and a row pitch
+		// which is a multiple of the pitch alignment of the device.
+		const size_t alignment = device.supportsVersion(2,0) ? device.info().imagePitchAlignment() : 0;
+		if(!device.supportsVersion(2,0))
+			std::cout << "Images from buffers: skipped (OpenCL 2.0 required)" << std::endl;
+		else if(alignment > 0 && (cols>>2) % alignment != 0)
+			std::cout << "Images from buffers: skipped (row pitch not a multiple of " << alignment << " pixels)" << std::endl;
+		else
+		{
+			C = 0;
+
+			// get the kernels.
+			ocl::Kernel &kernel = program.kernel("add4");
+			// set the index space for the kernels
+			kernel.setWorkSize(localCols>>2, localRows, cols>>2, rows);
+
+			// the matrices are uploaded once into buffers.
+			const size_t bytes = A.rows()*A.cols()*sizeof(Type);
+			ocl::Buffer bA(context, bytes);
+			ocl::Buffer bB(context, bytes);
+			ocl::Buffer bC(context, bytes);
+
+			bA.write(queue, A.data(), bytes);
+			bB.write(queue, B.data(), bytes);
+
+			// the images share the memory of the buffers and are not copied.
+			ocl::Image iA(context, bA, A.cols()>>2 , A.rows());
+			ocl::Image iB(context, bB, B.cols()>>2 , B.rows());
+			ocl::Image iC(context, bC, C.cols()>>2 , C.rows());
+
+			kernel(queue, int(A.cols()), int(A.rows()), iC.id(), iA.id(), iB.id(), sampler.id());
+			queue.finish();
+
+			bC.read(queue, C.data(), bytes);
+
+			if(A+B != C) std::cout << "Computation result: FALSE" << std::endl;
+			else         std::cout << "Computation result: TRUE" << std::endl;
+
+			// the same buffers are read through global pointers as well.
+			C = 0;
+			bC.write(queue, C.data(), bytes);
+
+			ocl::Kernel &global = program.kernel("add4_buffer");
+			global.setWorkSize(localCols>>2, localRows, cols>>2, rows);
+
+			global(queue, int(A.cols()), int(A.rows()), bC.id(), bA.id(), bB.id());
+			queue.finish();
+
+			bC.read(queue, C.data(), bytes);
+
+			if(A+B != C) std::cout << "Computation result: FALSE" << std::endl;
+			else         std::cout << "Computation result: TRUE" << std::endl;
+		}
 	}
     
 	return 0;
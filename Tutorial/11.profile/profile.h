@@ -72,8 +72,8 @@ private :
 	ocl::Device   device_;   /*! The first Device is chosen. Initialized in the constructor */
 	ocl::Context  context_;  /*! Only one Context is created. Initialized in the constructor */
 	ocl::Queue    queue_;    /*! Only one Queue is created with the above Context and Device. Initialized in the constructor */
-	ocl::Program  program_;  /*! Program is created in the constructor but built in the prof() function with dimension parameters.*/
-	ocl::Kernel*  kernel_;   /*! Kernel is created in the constructor but built in the prof() function. */
+	ocl::Program  program_;  /*! Program is created in the constructor. Its variants are built in the prof() function with dimension parameters.*/
+	std::string   kernelname_; /*! Name of the kernel which is looked up in the variant for the dimension parameters. */
 };
 
 
@@ -96,15 +96,14 @@ StudXPass1<Type_,Format_,W1,W2>::StudXPass1(
 	  device_( platform_.device( ocl::device_type::GPU ) ),
 	  context_( device_ ),
 	  queue_( context_, device_, CL_QUEUE_PROFILING_ENABLE ),
-	  program_( context_, utl::type::Single | utl::type::Double ),
-	  kernel_(nullptr)
+	  program_( context_, utl::type::Single | utl::type::Double, ocl::compile_option::FAST_MATH | ocl::compile_option::NO_SIGNED_ZERO | "-w -Werror" ),
+	  kernelname_(kernel)
 {
 	std::ifstream stream( file );
 	if ( !stream.is_open() ) { throw std::runtime_error("Failed opening file " + file);}
 	program_ << stream;
 
-	kernel_ = &program_.kernel(kernel, utl::Type::type<Type_>());
-	if ( kernel_ == nullptr ) { throw std::runtime_error( "kernel not valid" ); }
+	if ( !program_.exists(kernel + "_" + utl::Type::type<Type_>().name()) ) { throw std::runtime_error( "kernel not valid" ); }
 }
 
 
@@ -129,15 +128,16 @@ void StudXPass1<Type_,Format_, W1,W2>::prof( utl::Dim const& dim )
 	  if( N <= 0 ) throw std::runtime_error( "N should be greater 0." );
 	  if( M <= 0 ) throw std::runtime_error( "M should be greater 0." );
 
-	  std::ostringstream oss;
-	  oss << "-w -Werror" << " -D M=" << M << "u -D N=" << N << "u -D W=" << W1 << 'u';
+	  // Variants for already visited dimensions are kept and not built again.
+	  ocl::Program::Defines defines;
+	  defines["M"] = std::to_string(M) + "u";
+	  defines["N"] = std::to_string(N) + "u";
+	  defines["W"] = std::to_string(W1) + "u";
 
-	  program_.setCompileOption( ocl::compile_option::FAST_MATH | ocl::compile_option::NO_SIGNED_ZERO | ocl::CompileOption( oss.str() ) );
-	  program_.build();
-	  if ( ! program_.isBuilt() ) { throw std::runtime_error( "program not built" ); }
-	  if ( ! kernel_->created() ) { throw std::runtime_error( "kernel not created" ); }
+	  ocl::Kernel& kernel = program_.kernel( kernelname_, utl::Type::type<Type>(), defines );
+	  if ( ! kernel.created() ) { throw std::runtime_error( "kernel not created" ); }
 
-	  kernel_->setWorkSize( W1, M );
+	  kernel.setWorkSize( W1, M );
 
 	  const size_t numResBytes = sizeof (Type) * M * 1;
 	  const size_t numLhsBytes = sizeof (Type) * M * N;
@@ -167,7 +167,7 @@ void StudXPass1<Type_,Format_, W1,W2>::prof( utl::Dim const& dim )
 		  queue.finish();
 	  };
 
-	  this->call(std::bind(lambda, std::ref(*kernel_), std::ref(queue_), std::ref(bufRes), std::cref(bufLhs), std::cref(bufRhs)));
+	  this->call(std::bind(lambda, std::ref(kernel), std::ref(queue_), std::ref(bufRes), std::cref(bufLhs), std::cref(bufRhs)));
 
 
 
@@ -189,9 +189,6 @@ void StudXPass1<Type_,Format_, W1,W2>::prof( utl::Dim const& dim )
 			  std::cout << "ref[" << index << "] = " << ref[index] << " != res[" << index << "] = " << res[index] << std::endl;
 		  }
 	  }
-
-
-	  program_.release();
 }
 
 
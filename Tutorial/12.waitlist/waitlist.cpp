@@ -0,0 +1,110 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+#include <ocl_wrapper.h>
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+
+namespace kernel_strings {
+
+const std::string touch =
+R"(
+
+__kernel void touch(__global float *a)
+{
+    if(get_global_id(0) == 0) a[0] += 1.0f;
+}
+
+)";
+
+}
+
+// Measures the host cost of enqueueing a kernel with wait lists of
+// different lengths. The EventList stores up to EventList::inline_capacity
+// events without allocating memory and is passed to OpenCL without copying
+// unless a DependencyTracker adds events to it. For comparison, the cost of
+// copying an EventList and of copying the events into a std::vector, which
+// has been done for every enqueue before, is measured as well.
+
+int main()
+{
+    typedef std::chrono::high_resolution_clock clock;
+
+    ocl::Platform platform(ocl::device_type::GPU);
+    ocl::Device device = platform.device(ocl::device_type::GPU);
+
+    // creates a context for a decice or platform
+    ocl::Context context(device);
+
+    // create command queue.
+    ocl::Queue queue(context, device);
+
+    // create program on a context.
+    ocl::Program program(context);
+    program << kernel_strings::touch;
+    program.build();
+
+    ocl::Kernel &kernel = program.kernel("touch");
+    kernel.setWorkSize(1, 1);
+
+    ocl::Buffer buffer(context, sizeof(float));
+    const float zero = 0.0f;
+    buffer.write(queue, &zero, sizeof(float));
+
+    // completed events on which the kernel executions wait.
+    std::vector<ocl::Event> events;
+    for(size_t i = 0; i < 32; ++i)
+        events.push_back(buffer.writeAsync(queue, 0, &zero, sizeof(float)));
+    queue.finish();
+
+    const size_t repetitions = 10000;
+
+    std::cout << std::setw(8) << "events"
+              << std::setw(16) << "enqueue [us]"
+              << std::setw(16) << "list [ns]"
+              << std::setw(16) << "copy [ns]" << std::endl;
+
+    for(size_t n : {0, 1, 2, 4, 8, 16, 32})
+    {
+        ocl::EventList list;
+        for(size_t i = 0; i < n; ++i) list << events[i];
+
+        // enqueue with the wait list.
+        auto start = clock::now();
+        for(size_t r = 0; r < repetitions; ++r){
+            kernel(queue, list, buffer.id());
+            if(r % 1000 == 999) queue.finish();
+        }
+        queue.finish();
+        const double enqueue = std::chrono::duration<double, std::micro>(clock::now() - start).count() / repetitions;
+
+        // copy the wait list as done with a DependencyTracker.
+        start = clock::now();
+        for(size_t r = 0; r < repetitions; ++r){
+            ocl::EventList copy(list);
+            if(copy.size() != n) return EXIT_FAILURE;
+        }
+        const double build = std::chrono::duration<double, std::nano>(clock::now() - start).count() / repetitions;
+
+        // copy the events into a std::vector as for each enqueue before.
+        start = clock::now();
+        size_t sum = 0;
+        for(size_t r = 0; r < repetitions; ++r)
+            sum += list.events().size();
+        const double copy = std::chrono::duration<double, std::nano>(clock::now() - start).count() / repetitions;
+        if(sum != n * repetitions) return EXIT_FAILURE;
+
+        std::cout << std::setw(8) << n
+                  << std::setw(16) << std::fixed << std::setprecision(3) << enqueue
+                  << std::setw(16) << std::setprecision(1) << build
+                  << std::setw(16) << copy << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
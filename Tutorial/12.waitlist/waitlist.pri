@@ -0,0 +1 @@
+SOURCES += 12.waitlist/waitlist.cpp
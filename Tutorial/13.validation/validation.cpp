@@ -0,0 +1,95 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+
+#include <ocl_wrapper.h>
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+
+namespace kernel_strings {
+
+const std::string touch =
+R"(
+
+__kernel void touch(__global float *a, float b)
+{
+    if(get_global_id(0) == 0) a[0] += b;
+}
+
+)";
+
+}
+
+// Measures the host overhead of kernel launches and small transfers.
+// The library validates contexts, pointers and argument positions if it
+// is configured with OCL_CHECKED=1 in ocl_config.h, which is the default
+// for debug builds. Release builds compile the validation out.
+// Build this tutorial once against a checked and once against an unchecked
+// library in order to compare both modes.
+
+// Returns the average time in microseconds of one call.
+double measure(const ocl::Queue &queue, size_t repetitions, const std::function<void()> &call)
+{
+    typedef std::chrono::high_resolution_clock clock;
+    auto start = clock::now();
+    for(size_t r = 0; r < repetitions; ++r){
+        call();
+        if(r % 1000 == 999) queue.finish();
+    }
+    queue.finish();
+    return std::chrono::duration<double, std::micro>(clock::now() - start).count() / repetitions;
+}
+
+int main()
+{
+    ocl::Platform platform(ocl::device_type::GPU);
+    ocl::Device device = platform.device(ocl::device_type::GPU);
+
+    // creates a context for a decice or platform
+    ocl::Context context(device);
+
+    // create command queue.
+    ocl::Queue queue(context, device);
+
+    // create program on a context.
+    ocl::Program program(context);
+    program << kernel_strings::touch;
+    program.build();
+
+    ocl::Kernel &kernel = program.kernel("touch");
+    kernel.setWorkSize(1, 1);
+
+    ocl::Buffer a(context, sizeof(float)), b(context, sizeof(float));
+    float value = 0.0f;
+    a.write(queue, &value, sizeof(float));
+
+    const size_t repetitions = 10000;
+
+    std::cout << "validation: " << (ocl::checked() ? "checked" : "unchecked") << std::endl;
+    std::cout << std::setw(16) << "command" << std::setw(16) << "time [us]" << std::endl;
+
+    const std::pair<std::string, std::function<void()>> commands[] =
+    {
+        {"launch",     [&]{ kernel(queue, a.id(), 1.0f); }},
+        {"setArg",     [&]{ kernel.setArg(0, a.id()); kernel.setArg(1, 1.0f); }},
+        {"writeAsync", [&]{ a.writeAsync(queue, 0, &value, sizeof(float)); }},
+        {"readAsync",  [&]{ a.readAsync(queue, 0, &value, sizeof(float)); }},
+        {"copyAsync",  [&]{ a.copyToAsync(queue, 0, sizeof(float), b, 0); }},
+        {"write",      [&]{ a.write(queue, &value, sizeof(float)); }},
+        {"read",       [&]{ a.read(queue, &value, sizeof(float)); }},
+    };
+
+    for(const auto &command : commands)
+    {
+        std::cout << std::setw(16) << command.first
+                  << std::setw(16) << std::fixed << std::setprecision(3)
+                  << measure(queue, repetitions, command.second) << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1 @@
+SOURCES += 13.validation/validation.cpp
@@ -59,9 +59,9 @@ int main()
     program1 << kernel_strings::copy;
     program2 << kernel_strings::copy;
 
-    // kernels are created and program is built for the context.
-    program1.build();
-    program2.build();
+    // kernels are created and programs are built in parallel for their contexts.
+    // program1.build() builds a single program synchronously.
+    ocl::Program::buildAll(program1, program2);
 
     if(program1.isBuilt())
         std::cout << "Program 1 on context 1 is built" << std::endl;
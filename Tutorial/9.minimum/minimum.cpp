@@ -11,6 +11,12 @@
 #include <CL/opencl.h>
 #endif
 
+#ifdef MINIMUM_BUNDLE
+// binaries precompiled by oclpc (see ocl_kernel_bundle in CMakeLists.txt)
+extern const unsigned char minimum_bundle[];
+extern const size_t minimum_bundle_size;
+#endif
+
 typedef float Type;
 typedef utl::Matrix <Type,utl::column_major_tag> Matrix;
 typedef utl::Ones <Type,utl::column_major_tag> Ones;
@@ -43,6 +49,11 @@ int main(int argc, char* argv[])
     // create program on a context
     // as the kernel is templated, creates kernel for single and integer types
     ocl::Program program(context, utl::type::Single | utl::type::Int);       	
+#ifdef MINIMUM_BUNDLE
+    // prefers the precompiled binaries and builds from source if the device or driver differs.
+    static const ocl::Bundle bundle(minimum_bundle, minimum_bundle_size);
+    program.setBundle(&bundle);
+#endif
     // inserts kernels into the program.
     std::ifstream file("9.minimum/minimum.cl");
     program << file;
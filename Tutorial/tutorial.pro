@@ -2,6 +2,7 @@ TEMPLATE = app
 CONFIG += console
 CONFIG -= app_bundle
 CONFIG -= qt
+CONFIG(release, debug|release): DEFINES += NDEBUG OCL_CHECKED=0
 
 INCLUDEPATH +=../Code/inc
 INCLUDEPATH +=../../Profiler/Code/inc
@@ -17,3 +18,5 @@ include(8.matrix/matrix.pri)
 include(9.minimum/minimum.pri)
 include(10.image/image.pri)
 include(11.profile/profile.pri)
+include(12.waitlist/waitlist.pri)
+include(13.validation/validation.pri)